@@ -179,6 +179,34 @@ if(NOT MSVC)
     CXXFLAGS ${AVX2_CXXFLAGS}
   )
 
+  # Check for AVX-512 intrinsics.
+  set(AVX512_CXXFLAGS -mavx512f)
+  check_cxx_source_compiles_with_flags("
+    #include <immintrin.h>
+
+    int main()
+    {
+      __m512i l = _mm512_ternarylogic_epi32(_mm512_set1_epi32(0), _mm512_set1_epi32(1), _mm512_set1_epi32(2), 0x96);
+      return _mm_cvtsi128_si32(_mm512_castsi512_si128(_mm512_ror_epi32(l, 7)));
+    }
+    " HAVE_AVX512
+    CXXFLAGS ${AVX512_CXXFLAGS}
+  )
+
+  # Check for AVX-512 IFMA intrinsics.
+  set(AVX512IFMA_CXXFLAGS -mavx512f -mavx512ifma)
+  check_cxx_source_compiles_with_flags("
+    #include <immintrin.h>
+
+    int main()
+    {
+      __m512i l = _mm512_madd52lo_epu64(_mm512_set1_epi64(0), _mm512_set1_epi64(1), _mm512_set1_epi64(2));
+      return _mm_cvtsi128_si32(_mm512_castsi512_si128(_mm512_madd52hi_epu64(l, l, l)));
+    }
+    " HAVE_AVX512IFMA
+    CXXFLAGS ${AVX512IFMA_CXXFLAGS}
+  )
+
   # Check for x86 SHA-NI intrinsics.
   set(X86_SHANI_CXXFLAGS -msse4 -msha)
   check_cxx_source_compiles_with_flags("
@@ -0,0 +1,105 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <coins.h>
+#include <consensus/amount.h>
+#include <flatfile.h>
+#include <node/blockstorage.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <util/check.h>
+#include <util/threadpool.h>
+#include <validation.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+static constexpr int NUM_BLOCKS{8};
+static constexpr int INPUTS_PER_BLOCK{250};
+
+/*
+ * Reads a chain of NUM_BLOCKS blocks that are on disk but not connected, and loads the prevouts of each block into
+ * the coins cache in connection order, the way ConnectTip() does during IBD. With workers, upcoming blocks and their
+ * prevouts are fetched by BlockLookahead while earlier blocks are being processed.
+ */
+static void BlockLookaheadBench(benchmark::Bench& bench, int workers)
+{
+    const auto test_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    auto& chainman{*test_setup->m_node.chainman};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+    const CScript script{CScript{} << OP_TRUE};
+
+    // Confirm a transaction with enough outputs to be spent by all benchmark blocks.
+    std::vector<CTxOut> outputs(NUM_BLOCKS * INPUTS_PER_BLOCK, CTxOut{COIN / 100, script});
+    const auto& coinbase{test_setup->m_coinbase_txns[0]};
+    const auto [funding_tx, _]{test_setup->CreateValidTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}},
+                                                                  /*input_height=*/1, {test_setup->coinbaseKey}, outputs, {}, {})};
+    test_setup->CreateAndProcessBlock({funding_tx}, script);
+
+    std::vector<CBlock> blocks;
+    for (int i{0}; i < NUM_BLOCKS; ++i) {
+        CMutableTransaction tx;
+        for (int j{0}; j < INPUTS_PER_BLOCK; ++j) {
+            tx.vin.emplace_back(funding_tx.GetHash(), i * INPUTS_PER_BLOCK + j);
+        }
+        tx.vout.emplace_back(INPUTS_PER_BLOCK * (COIN / 100), script);
+        blocks.push_back(test_setup->CreateBlock({tx}, script));
+    }
+
+    std::vector<const CBlockIndex*> indexes;
+    {
+        LOCK(cs_main);
+        chainstate.ForceFlushStateToDisk();
+        // Write the blocks to disk as a chain on top of the tip, without connecting them.
+        const CBlockIndex* prev{chainstate.m_chain.Tip()};
+        for (auto& block : blocks) {
+            block.hashPrevBlock = prev->GetBlockHash();
+            while (!CheckProofOfWork(block.GetHash(), block.nBits, chainman.GetConsensus())) ++block.nNonce;
+            const FlatFilePos pos{chainman.m_blockman.WriteBlock(block, prev->nHeight + 1)};
+            CBlockIndex* index{chainman.m_blockman.AddToBlockIndex(block, chainman.m_best_header)};
+            index->nFile = pos.nFile;
+            index->nDataPos = pos.nPos;
+            index->nStatus |= BLOCK_HAVE_DATA;
+            indexes.push_back(index);
+            prev = index;
+        }
+    }
+
+    ThreadPool thread_pool{"lookahead"};
+    if (workers > 0) thread_pool.Start(workers);
+    BlockLookahead lookahead{chainman.m_blockman, WITH_LOCK(cs_main, return chainstate.CoinsErrorCatcher()), thread_pool};
+
+    bench.unit("block").batch(NUM_BLOCKS).run([&] {
+        LOCK(cs_main);
+        auto& cache{chainstate.CoinsTip()};
+        const auto write_epoch{chainstate.CoinsDB().GetWriteEpoch()};
+        for (const CBlockIndex* index : indexes) {
+            lookahead.Schedule(*index, *indexes.back(), write_epoch);
+            auto block{lookahead.Take(*index, cache, write_epoch)};
+            if (!block) {
+                auto read_block{std::make_shared<CBlock>()};
+                assert(chainman.m_blockman.ReadBlock(*read_block, *index));
+                block = std::move(read_block);
+            }
+            for (const auto& in : block->vtx[1]->vin) assert(cache.HaveCoin(in.prevout));
+        }
+        // Evict the prevouts again so the next run starts from a cold cache.
+        for (const auto& block : blocks) {
+            for (const auto& in : block.vtx[1]->vin) cache.Uncache(in.prevout);
+        }
+    });
+}
+
+static void BlockLookaheadDisabled(benchmark::Bench& bench) { BlockLookaheadBench(bench, /*workers=*/0); }
+static void BlockLookaheadFourWorkers(benchmark::Bench& bench) { BlockLookaheadBench(bench, /*workers=*/4); }
+
+BENCHMARK(BlockLookaheadDisabled);
+BENCHMARK(BlockLookaheadFourWorkers);
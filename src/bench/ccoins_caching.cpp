@@ -9,12 +9,19 @@
 #include <key.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
+#include <random.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
+#include <support/allocators/pool.h>
 #include <test/util/transaction_utils.h>
 #include <util/check.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 // Microbenchmark for simple accesses to a CCoinsViewCache database. Note from
@@ -55,3 +62,75 @@ static void CCoinsCaching(benchmark::Bench& bench)
 }
 
 BENCHMARK(CCoinsCaching);
+
+//! The CCoinsMap type used before NodeHashMap, kept to compare against.
+using LegacyCoinsMap = std::unordered_map<COutPoint,
+                                          CCoinsCacheEntry,
+                                          SaltedCoinsCacheHasher,
+                                          std::equal_to<COutPoint>,
+                                          PoolAllocator<CoinsCachePair,
+                                                        sizeof(CoinsCachePair) + sizeof(void*) * 4>>;
+
+static constexpr size_t COINS_MAP_ENTRIES{1'000'000};
+
+/*
+ * Looks up random outpoints, half of them present, in a coins map much larger than the CPU caches, as done by
+ * CCoinsViewCache::FetchCoin() during block connection.
+ */
+template <typename Map>
+static void CoinsMapLookup(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    typename Map::allocator_type::ResourceType resource;
+    Map map{0, SaltedCoinsCacheHasher{/*deterministic=*/true}, std::equal_to<COutPoint>{}, &resource};
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(COINS_MAP_ENTRIES * 2);
+    for (size_t i{0}; i < COINS_MAP_ENTRIES * 2; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), rng.randrange(4));
+        if (i % 2 == 0) map.try_emplace(outpoints.back());
+    }
+    std::shuffle(outpoints.begin(), outpoints.end(), rng);
+
+    size_t i{0}, found{0};
+    bench.batch(1000).unit("lookup").run([&] {
+        for (int j{0}; j < 1000; ++j) {
+            found += map.find(outpoints[i++ % outpoints.size()]) != map.end();
+        }
+    });
+    assert(found > 0);
+}
+
+/* Inserts and erases random outpoints in a coins map, as done when a CCoinsViewCache fetches and uncaches coins. */
+template <typename Map>
+static void CoinsMapInsertErase(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    typename Map::allocator_type::ResourceType resource;
+    Map map{0, SaltedCoinsCacheHasher{/*deterministic=*/true}, std::equal_to<COutPoint>{}, &resource};
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(COINS_MAP_ENTRIES);
+    for (size_t i{0}; i < COINS_MAP_ENTRIES; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), rng.randrange(4));
+        map.try_emplace(outpoints.back());
+    }
+
+    size_t i{0};
+    bench.batch(1000).unit("op").run([&] {
+        for (int j{0}; j < 1000; ++j) {
+            COutPoint& outpoint{outpoints[i++ % outpoints.size()]};
+            map.erase(outpoint);
+            outpoint.n += 4;
+            map.try_emplace(outpoint);
+        }
+    });
+}
+
+static void CoinsMapLookupLegacy(benchmark::Bench& bench) { CoinsMapLookup<LegacyCoinsMap>(bench); }
+static void CoinsMapLookupNodeHashMap(benchmark::Bench& bench) { CoinsMapLookup<CCoinsMap>(bench); }
+static void CoinsMapInsertEraseLegacy(benchmark::Bench& bench) { CoinsMapInsertErase<LegacyCoinsMap>(bench); }
+static void CoinsMapInsertEraseNodeHashMap(benchmark::Bench& bench) { CoinsMapInsertErase<CCoinsMap>(bench); }
+
+BENCHMARK(CoinsMapLookupLegacy);
+BENCHMARK(CoinsMapLookupNodeHashMap);
+BENCHMARK(CoinsMapInsertEraseLegacy);
+BENCHMARK(CoinsMapInsertEraseNodeHashMap);
@@ -9,6 +9,7 @@
 // See https://github.com/include-what-you-use/include-what-you-use/issues/2014.
 #include <util/byte_units.h> // IWYU pragma: keep
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <span>
@@ -17,6 +18,7 @@
 /* Number of bytes to process per iteration */
 static const uint64_t BUFFER_SIZE_TINY  = 64;
 static const uint64_t BUFFER_SIZE_SMALL = 256;
+static const uint64_t BUFFER_SIZE_MEDIUM = 4096;
 static const uint64_t BUFFER_SIZE_LARGE{1_MiB};
 
 static void CHACHA20(benchmark::Bench& bench, size_t buffersize)
@@ -43,6 +45,21 @@ static void FSCHACHA20POLY1305(benchmark::Bench& bench, size_t buffersize)
     });
 }
 
+static void FSCHACHA20POLY1305_ROUNDTRIP(benchmark::Bench& bench, size_t buffersize)
+{
+    std::vector<std::byte> key(32);
+    FSChaCha20Poly1305 enc_ctx(key, 224), dec_ctx(key, 224);
+    std::vector<std::byte> plain(buffersize);
+    std::vector<std::byte> aad;
+    std::vector<std::byte> cipher(buffersize + FSChaCha20Poly1305::EXPANSION);
+    // Every packet is encrypted with a different nonce, so keep the encryption side in step.
+    bench.batch(plain.size()).unit("byte").run([&] {
+        enc_ctx.Encrypt(plain, aad, cipher);
+        const bool ok{dec_ctx.Decrypt(cipher, aad, plain)};
+        assert(ok);
+    });
+}
+
 static void CHACHA20_64BYTES(benchmark::Bench& bench)
 {
     CHACHA20(bench, BUFFER_SIZE_TINY);
@@ -53,6 +70,11 @@ static void CHACHA20_256BYTES(benchmark::Bench& bench)
     CHACHA20(bench, BUFFER_SIZE_SMALL);
 }
 
+static void CHACHA20_4KB(benchmark::Bench& bench)
+{
+    CHACHA20(bench, BUFFER_SIZE_MEDIUM);
+}
+
 static void CHACHA20_1MB(benchmark::Bench& bench)
 {
     CHACHA20(bench, BUFFER_SIZE_LARGE);
@@ -68,14 +90,27 @@ static void FSCHACHA20POLY1305_256BYTES(benchmark::Bench& bench)
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_SMALL);
 }
 
+static void FSCHACHA20POLY1305_4KB(benchmark::Bench& bench)
+{
+    FSCHACHA20POLY1305(bench, BUFFER_SIZE_MEDIUM);
+}
+
 static void FSCHACHA20POLY1305_1MB(benchmark::Bench& bench)
 {
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_LARGE);
 }
 
+static void FSCHACHA20POLY1305_ROUNDTRIP_4KB(benchmark::Bench& bench)
+{
+    FSCHACHA20POLY1305_ROUNDTRIP(bench, BUFFER_SIZE_MEDIUM);
+}
+
 BENCHMARK(CHACHA20_64BYTES);
 BENCHMARK(CHACHA20_256BYTES);
+BENCHMARK(CHACHA20_4KB);
 BENCHMARK(CHACHA20_1MB);
 BENCHMARK(FSCHACHA20POLY1305_64BYTES);
 BENCHMARK(FSCHACHA20POLY1305_256BYTES);
+BENCHMARK(FSCHACHA20POLY1305_4KB);
 BENCHMARK(FSCHACHA20POLY1305_1MB);
+BENCHMARK(FSCHACHA20POLY1305_ROUNDTRIP_4KB);
@@ -171,6 +171,16 @@ static void SHA256D64_1024_AVX2(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+static void SHA256D64_1024_AVX512(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AVX2_AND_AVX512)));
+    std::vector<uint8_t> in(64 * 1024, 0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        SHA256D64(in.data(), in.data(), 1024);
+    });
+    SHA256AutoDetect();
+}
+
 static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
 {
     bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_SHANI)));
@@ -181,6 +191,65 @@ static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+/* Double-SHA256 of 1000 independent messages with the sizes of typical transactions, as for computing txids */
+static std::vector<std::vector<uint8_t>> TxSizedMessages()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<uint8_t>> messages;
+    for (int i = 0; i < 1000; ++i) {
+        messages.push_back(rng.randbytes(150 + rng.randrange(450)));
+    }
+    return messages;
+}
+
+static void SHA256DMulti_1000_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::STANDARD)));
+    const auto messages{TxSizedMessages()};
+    const std::vector<std::span<const uint8_t>> inputs(messages.begin(), messages.end());
+    std::vector<uint8_t> out(inputs.size() * CSHA256::OUTPUT_SIZE);
+    bench.batch(inputs.size()).unit("message").run([&] {
+        SHA256DMulti(out.data(), inputs);
+    });
+    SHA256AutoDetect();
+}
+
+static void SHA256DMulti_1000_SSE4(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4)));
+    const auto messages{TxSizedMessages()};
+    const std::vector<std::span<const uint8_t>> inputs(messages.begin(), messages.end());
+    std::vector<uint8_t> out(inputs.size() * CSHA256::OUTPUT_SIZE);
+    bench.batch(inputs.size()).unit("message").run([&] {
+        SHA256DMulti(out.data(), inputs);
+    });
+    SHA256AutoDetect();
+}
+
+static void SHA256DMulti_1000_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_AVX2)));
+    const auto messages{TxSizedMessages()};
+    const std::vector<std::span<const uint8_t>> inputs(messages.begin(), messages.end());
+    std::vector<uint8_t> out(inputs.size() * CSHA256::OUTPUT_SIZE);
+    bench.batch(inputs.size()).unit("message").run([&] {
+        SHA256DMulti(out.data(), inputs);
+    });
+    SHA256AutoDetect();
+}
+
+static void SHA256DMulti_1000_SHANI(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_SHANI)));
+    const auto messages{TxSizedMessages()};
+    const std::vector<std::span<const uint8_t>> inputs(messages.begin(), messages.end());
+    std::vector<uint8_t> out(inputs.size() * CSHA256::OUTPUT_SIZE);
+    bench.batch(inputs.size()).unit("message").run([&] {
+        SHA256DMulti(out.data(), inputs);
+    });
+    SHA256AutoDetect();
+}
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -323,7 +392,12 @@ BENCHMARK(SipHash13UJ_36b);
 BENCHMARK(SHA256D64_1024_STANDARD);
 BENCHMARK(SHA256D64_1024_SSE4);
 BENCHMARK(SHA256D64_1024_AVX2);
+BENCHMARK(SHA256D64_1024_AVX512);
 BENCHMARK(SHA256D64_1024_SHANI);
+BENCHMARK(SHA256DMulti_1000_STANDARD);
+BENCHMARK(SHA256DMulti_1000_SSE4);
+BENCHMARK(SHA256DMulti_1000_AVX2);
+BENCHMARK(SHA256DMulti_1000_SHANI);
 
 BENCHMARK(MuHash);
 BENCHMARK(MuHashMul);
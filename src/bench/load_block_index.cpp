@@ -0,0 +1,77 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <dbwrapper.h>
+#include <kernel/cs_main.h>
+#include <node/blockstorage.h>
+#include <node/kernel_notifications.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/check.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+static constexpr int NUM_BLOCKS{50'000};
+
+/*
+ * Loads a block index of NUM_BLOCKS headers from disk, the way BlockManager does at startup: reading, deserializing and
+ * checking the entries, inserting them into the block index, and computing the chain work.
+ */
+static void LoadBlockIndexBench(benchmark::Bench& bench, int threads)
+{
+    const auto testing_setup{MakeNoLogFileContext<BasicTestingSetup>()};
+    const auto& consensus{Params().GetConsensus()};
+    const DBParams db_params{
+        .path = testing_setup->m_args.GetDataDirNet() / "bench_block_index",
+        .cache_bytes = 8_MiB,
+    };
+    {
+        std::vector<uint256> hashes(NUM_BLOCKS);
+        std::vector<std::unique_ptr<CBlockIndex>> chain;
+        std::vector<const CBlockIndex*> block_info;
+        for (int i{0}; i < NUM_BLOCKS; ++i) {
+            CBlockHeader header;
+            header.hashPrevBlock = i > 0 ? hashes[i - 1] : uint256{};
+            header.nTime = i;
+            header.nBits = Params().GenesisBlock().nBits;
+            while (!CheckProofOfWork(header.GetHash(), header.nBits, consensus)) ++header.nNonce;
+            hashes[i] = header.GetHash();
+            auto& index{*chain.emplace_back(std::make_unique<CBlockIndex>(header))};
+            index.phashBlock = &hashes[i];
+            index.pprev = i > 0 ? chain[i - 1].get() : nullptr;
+            index.nHeight = i;
+            index.nStatus = BLOCK_VALID_TREE;
+            block_info.push_back(&index);
+        }
+        kernel::BlockTreeDB{db_params}.WriteBatchSync({}, 0, block_info);
+    }
+
+    node::KernelNotifications notifications{Assert(testing_setup->m_node.shutdown_request), testing_setup->m_node.exit_status, *Assert(testing_setup->m_node.warnings)};
+    const node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = testing_setup->m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = db_params,
+        .block_index_load_threads = threads,
+    };
+    bench.unit("block").batch(NUM_BLOCKS).run([&] {
+        node::BlockManager blockman{*Assert(testing_setup->m_node.shutdown_signal), blockman_opts};
+        LOCK(cs_main);
+        assert(blockman.LoadBlockIndexDB(/*snapshot_blockhash=*/{}));
+    });
+}
+
+static void LoadBlockIndexSerial(benchmark::Bench& bench) { LoadBlockIndexBench(bench, /*threads=*/0); }
+static void LoadBlockIndexFourThreads(benchmark::Bench& bench) { LoadBlockIndexBench(bench, /*threads=*/4); }
+
+BENCHMARK(LoadBlockIndexSerial);
+BENCHMARK(LoadBlockIndexFourThreads);
@@ -19,6 +19,7 @@
 #include <memory>
 #include <optional>
 #include <span>
+#include <utility>
 
 static CBlock CreateTestBlock()
 {
@@ -64,6 +65,22 @@ static void ReadRawBlockBench(benchmark::Bench& bench)
     });
 }
 
+// Same as ReadRawBlockBench, but from a block file that is no longer written to, which is read through a memory map.
+static void ReadRawBlockMappedBench(benchmark::Bench& bench)
+{
+    // With -fastprune, each test block is written to its own file.
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, {.extra_args = {"-fastprune"}})};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    const auto [pos, next_pos]{WITH_LOCK(::cs_main, return std::pair(blockman.WriteBlock(CreateTestBlock(), 413'567),
+                                                                     blockman.WriteBlock(CreateTestBlock(), 413'568)))};
+    assert(pos.nFile < next_pos.nFile);
+    bench.run([&] {
+        const auto res{blockman.ReadRawBlock(pos)};
+        assert(res);
+    });
+}
+
 BENCHMARK(WriteBlockBench);
 BENCHMARK(ReadBlockBench);
 BENCHMARK(ReadRawBlockBench);
+BENCHMARK(ReadRawBlockMappedBench);
@@ -0,0 +1,69 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <util/sock.h>
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/socket.h>
+
+using namespace std::chrono_literals;
+
+/*
+ * Waits for readiness of num_connections mostly idle connections, of which one always has data to receive, the way
+ * the socket handler loops of CConnman and HTTPServer do on every iteration.
+ */
+template <typename WaitFn>
+static void SockWaitBench(benchmark::Bench& bench, size_t num_connections, WaitFn wait)
+{
+    std::vector<std::shared_ptr<const Sock>> socks;
+    std::vector<Sock> peers;
+    for (size_t i{0}; i < num_connections; ++i) {
+        int fds[2];
+        assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        socks.push_back(std::make_shared<const Sock>(fds[0]));
+        peers.emplace_back(fds[1]);
+    }
+    assert(peers.back().Send("x", 1, 0) == 1);
+
+    bench.unit("wait").run([&] { wait(socks); });
+}
+
+static void SockWaitManyBench(benchmark::Bench& bench, size_t num_connections)
+{
+    SockWaitBench(bench, num_connections, [](const std::vector<std::shared_ptr<const Sock>>& socks) {
+        Sock::EventsPerSock events_per_sock;
+        for (const auto& sock : socks) events_per_sock.emplace(sock, Sock::Events{Sock::RecvEvent});
+        assert(events_per_sock.begin()->first->WaitMany(1s, events_per_sock));
+        assert(events_per_sock.at(socks.back()).occurred == Sock::RecvEvent);
+    });
+}
+
+static void SockWaitSetBench(benchmark::Bench& bench, size_t num_connections)
+{
+    SockWaitSet wait_set;
+    Sock::EventsPerSock ready;
+    SockWaitBench(bench, num_connections, [&](const std::vector<std::shared_ptr<const Sock>>& socks) {
+        for (const auto& sock : socks) wait_set.Set(sock, Sock::RecvEvent);
+        assert(wait_set.Wait(1s, ready));
+        assert(ready.at(socks.back()).occurred == Sock::RecvEvent);
+    });
+}
+
+static void SockWaitMany100(benchmark::Bench& bench) { SockWaitManyBench(bench, 100); }
+static void SockWaitMany2000(benchmark::Bench& bench) { SockWaitManyBench(bench, 2000); }
+static void SockWaitSet100(benchmark::Bench& bench) { SockWaitSetBench(bench, 100); }
+static void SockWaitSet2000(benchmark::Bench& bench) { SockWaitSetBench(bench, 2000); }
+
+BENCHMARK(SockWaitMany100);
+BENCHMARK(SockWaitMany2000);
+BENCHMARK(SockWaitSet100);
+BENCHMARK(SockWaitSet2000);
+#endif // WIN32
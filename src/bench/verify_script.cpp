@@ -9,6 +9,7 @@
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <pubkey.h>
+#include <random.h>
 #include <script/interpreter.h>
 #include <script/script.h>
 #include <script/script_error.h>
@@ -21,6 +22,7 @@
 #include <util/check.h>
 #include <util/translation.h>
 
+#include <cassert>
 #include <cstddef>
 #include <map>
 #include <span>
@@ -109,6 +111,38 @@ static void VerifyScriptP2WPKH(benchmark::Bench& bench) { VerifyScriptBench(benc
 static void VerifyScriptP2TR_KeyPath(benchmark::Bench& bench) { VerifyScriptBench(bench, ScriptType::P2TR_KeyPath); }
 static void VerifyScriptP2TR_ScriptPath(benchmark::Bench& bench) { VerifyScriptBench(bench, ScriptType::P2TR_ScriptPath); }
 
+// Microbenchmark for the BIP340 signature check alone, which dominates the cost of taproot key-path and tapscript
+// CHECKSIG(ADD) verification, and is what a batch verification path would amortize. Each iteration verifies a
+// different signature by a different key, as during block validation.
+static void VerifySchnorrSignature(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+
+    constexpr size_t NUM_SIGS{64};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<XOnlyPubKey> pubkeys;
+    std::vector<uint256> msgs;
+    std::vector<std::vector<unsigned char>> sigs;
+    for (size_t i{0}; i < NUM_SIGS; ++i) {
+        CKey key;
+        const uint256 secret{rng.rand256()};
+        key.Set(secret.begin(), secret.end(), /*fCompressedIn=*/true);
+        assert(key.IsValid());
+        pubkeys.emplace_back(key.GetPubKey());
+        msgs.push_back(rng.rand256());
+        sigs.emplace_back(64);
+        const bool signed_ok{key.SignSchnorr(msgs.back(), sigs.back(), /*merkle_root=*/nullptr, /*aux=*/uint256::ZERO)};
+        assert(signed_ok);
+    }
+
+    size_t i{0};
+    bench.unit("signature").run([&] {
+        const bool success{pubkeys[i].VerifySchnorr(msgs[i], sigs[i])};
+        assert(success);
+        i = (i + 1) % NUM_SIGS;
+    });
+}
+
 static void VerifyNestedIfScript(benchmark::Bench& bench)
 {
     std::vector<std::vector<unsigned char>> stack;
@@ -134,4 +168,5 @@ static void VerifyNestedIfScript(benchmark::Bench& bench)
 BENCHMARK(VerifyScriptP2WPKH);
 BENCHMARK(VerifyScriptP2TR_KeyPath);
 BENCHMARK(VerifyScriptP2TR_ScriptPath);
+BENCHMARK(VerifySchnorrSignature);
 BENCHMARK(VerifyNestedIfScript);
@@ -42,7 +42,7 @@ static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const b
         wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
         wallet.SetupDescriptorScriptPubKeyMans();
     }
-    auto handler = test_setup->m_node.chain->handleNotifications({&wallet, [](CWallet*) {}});
+    auto handler = test_setup->m_node.chain->handleNotifications({&wallet, [](CWallet*) {}}, "wallet");
 
     const std::optional<std::string> address_mine{add_mine ? std::optional<std::string>{getnewaddress(wallet)} : std::nullopt};
 
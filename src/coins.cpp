@@ -12,6 +12,8 @@
 #include <util/threadpool.h>
 #include <util/trace.h>
 
+#include <algorithm>
+#include <atomic>
 #include <ranges>
 #include <unordered_set>
 
@@ -130,6 +132,17 @@ void CCoinsViewCache::EmplaceCoinInternalDANGER(const COutPoint& outpoint, Coin&
     }
 }
 
+bool CCoinsViewCache::EmplaceFetchedCoin(const COutPoint& outpoint, Coin&& coin)
+{
+    Assume(!coin.IsSpent());
+    const auto [it, inserted] = cacheCoins.try_emplace(outpoint);
+    if (inserted) {
+        it->second.coin = std::move(coin);
+        cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+    }
+    return inserted;
+}
+
 void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool check_for_overwrite) {
     bool fCoinbase = tx.IsCoinBase();
     const Txid& txid = tx.GetHash();
@@ -411,6 +424,46 @@ CCoinsViewCache::ResetGuard CoinsViewOverlay::StartFetching(const CBlock& block
     return CreateResetGuard();
 }
 
+std::vector<COutPoint> CCoinsViewCache::PrefetchCoins(std::span<const COutPoint> outpoints, ThreadPool& thread_pool)
+{
+    std::vector<COutPoint> added;
+    const auto workers_count{thread_pool.WorkersCount()};
+    if (workers_count == 0) return added;
+
+    std::vector<COutPoint> to_fetch;
+    to_fetch.reserve(outpoints.size());
+    for (const auto& outpoint : outpoints) {
+        if (!cacheCoins.contains(outpoint)) to_fetch.push_back(outpoint);
+    }
+    std::sort(to_fetch.begin(), to_fetch.end());
+    to_fetch.erase(std::unique(to_fetch.begin(), to_fetch.end()), to_fetch.end());
+    // A single lookup is not worth the handoff to another thread.
+    if (to_fetch.size() < 2) return added;
+
+    std::vector<std::optional<Coin>> coins(to_fetch.size());
+    std::atomic_size_t next{0};
+    const auto process_inputs{[&] {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < to_fetch.size();) {
+            coins[i] = base->PeekCoin(to_fetch[i]);
+        }
+    }};
+    std::vector<std::function<void()>> tasks(std::min<size_t>(workers_count, to_fetch.size() - 1), process_inputs);
+    auto futures{thread_pool.Submit(std::move(tasks))};
+    if (!futures) {
+        LogWarning("Failed to submit prevout fetch tasks (%s); falling back to single-threaded fetching.", SubmitErrorString(futures.error()));
+        return added;
+    }
+    // The calling thread participates instead of idling until the workers are done.
+    process_inputs();
+    for (auto& future : *futures) future.get();
+
+    added.reserve(to_fetch.size());
+    for (size_t i{0}; i < to_fetch.size(); ++i) {
+        if (coins[i] && Assume(EmplaceFetchedCoin(to_fetch[i], std::move(*coins[i])))) added.push_back(to_fetch[i]);
+    }
+    return added;
+}
+
 static const uint64_t MIN_TRANSACTION_OUTPUT_WEIGHT{WITNESS_SCALE_FACTOR * ::GetSerializeSize(CTxOut())};
 static const uint64_t MAX_OUTPUTS_PER_BLOCK{MAX_BLOCK_WEIGHT / MIN_TRANSACTION_OUTPUT_WEIGHT};
 
@@ -18,6 +18,7 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/log.h>
+#include <util/node_hash_map.h>
 #include <util/overflow.h>
 
 #include <cassert>
@@ -28,7 +29,7 @@
 #include <future>
 #include <memory>
 #include <optional>
-#include <unordered_map>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -257,19 +258,15 @@ public:
 };
 
 /**
- * PoolAllocator's MAX_BLOCK_SIZE_BYTES parameter here uses sizeof the data, and adds the size
- * of 4 pointers. We do not know the exact node size used in the std::unordered_node implementation
- * because it is implementation defined. Most implementations have an overhead of 1 or 2 pointers,
- * so nodes can be connected in a linked list, and in some cases the hash value is stored as well.
- * Using an additional sizeof(void*)*4 for MAX_BLOCK_SIZE_BYTES should thus be sufficient so that
- * all implementations can allocate the nodes from the PoolAllocator.
+ * Elements are allocated individually from a PoolAllocator and indexed by an open addressing table of pointers,
+ * so they never move and can be linked into the DIRTY/FRESH list. As NodeHashMap stores no per-element overhead
+ * next to the data, MAX_BLOCK_SIZE_BYTES is exactly the size of a CoinsCachePair.
  */
-using CCoinsMap = std::unordered_map<COutPoint,
-                                     CCoinsCacheEntry,
-                                     SaltedCoinsCacheHasher,
-                                     std::equal_to<COutPoint>,
-                                     PoolAllocator<CoinsCachePair,
-                                                   sizeof(CoinsCachePair) + sizeof(void*) * 4>>;
+using CCoinsMap = NodeHashMap<COutPoint,
+                              CCoinsCacheEntry,
+                              SaltedCoinsCacheHasher,
+                              std::equal_to<COutPoint>,
+                              PoolAllocator<CoinsCachePair, sizeof(CoinsCachePair)>>;
 
 using CCoinsMapMemoryResource = CCoinsMap::allocator_type::ResourceType;
 
@@ -526,6 +523,15 @@ public:
      */
     void EmplaceCoinInternalDANGER(const COutPoint& outpoint, Coin&& coin);
 
+    /**
+     * Add a coin fetched from the base view to the cache without marking it dirty, as a FetchCoin() cache miss
+     * would. Has no effect if the cache already holds an entry for the outpoint.
+     *
+     * The caller must ensure the base view has not been written to since the coin was fetched.
+     * @return whether the coin was added.
+     */
+    bool EmplaceFetchedCoin(const COutPoint& outpoint, Coin&& coin);
+
     /**
      * Spend a coin. Pass moveto in order to get the deleted data.
      * If no unspent output exists for the passed outpoint, this call
@@ -568,6 +574,17 @@ public:
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
+    /**
+     * Fetch the given outpoints from the base view in parallel on the workers of thread_pool and add the unspent
+     * ones to this cache, exactly as a FetchCoin() cache miss would. Outpoints already in this cache are skipped.
+     *
+     * This is a no-op if the pool has no workers, leaving the caller to fetch the coins serially on demand.
+     * This assumes all base->PeekCoin() paths are safe for concurrent readers and do not mutate lower cache layers.
+     *
+     * @return the outpoints that were added to this cache.
+     */
+    std::vector<COutPoint> PrefetchCoins(std::span<const COutPoint> outpoints, ThreadPool& thread_pool);
+
     //! Run an internal sanity check on the cache data structure. */
     void SanityCheck() const;
 
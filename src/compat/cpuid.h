@@ -22,5 +22,42 @@ void static inline GetCPUID(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32
 #endif
 }
 
+//! Read the XCR0 register, which tells which register sets the OS saves on context switches.
+uint64_t static inline GetXCR0()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (uint64_t{d} << 32) | a;
+}
+
+//! Whether the CPU supports AVX2 and the OS has enabled the AVX registers.
+bool static inline HaveAVX2()
+{
+    uint32_t a, b, c, d;
+    GetCPUID(1, 0, a, b, c, d);
+    // OSXSAVE and AVX
+    if (!((c >> 27) & 1) || !((c >> 28) & 1) || (GetXCR0() & 0x6) != 0x6) return false;
+    GetCPUID(7, 0, a, b, c, d);
+    return (b >> 5) & 1;
+}
+
+//! Whether the CPU supports AVX-512F and the OS has enabled the AVX-512 registers.
+bool static inline HaveAVX512F()
+{
+    if (!HaveAVX2()) return false;
+    uint32_t a, b, c, d;
+    GetCPUID(7, 0, a, b, c, d);
+    return ((b >> 16) & 1) && (GetXCR0() & 0xe6) == 0xe6;
+}
+
+//! Whether the CPU supports AVX-512F and AVX-512 IFMA, and the OS has enabled the AVX-512 registers.
+bool static inline HaveAVX512IFMA()
+{
+    if (!HaveAVX512F()) return false;
+    uint32_t a, b, c, d;
+    GetCPUID(7, 0, a, b, c, d);
+    return (b >> 21) & 1;
+}
+
 #endif // defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #endif // BITCOIN_COMPAT_CPUID_H
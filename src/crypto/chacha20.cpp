@@ -5,6 +5,7 @@
 // Based on the public domain implementation 'merged' by D. J. Bernstein
 // See https://cr.yp.to/chacha.html.
 
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 #include <crypto/chacha20.h>
 #include <support/cleanse.h>
@@ -21,6 +22,60 @@
 
 #define REPEAT10(a) do { {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; } while(0)
 
+#ifdef ENABLE_AVX2
+namespace chacha20_avx2 {
+void Crypt_8way(const uint32_t* input, const std::byte* in, std::byte* out);
+}
+#endif
+
+#ifdef ENABLE_AVX512
+namespace chacha20_avx512 {
+void Crypt_16way(const uint32_t* input, const std::byte* in, std::byte* out);
+}
+#endif
+
+namespace {
+
+/** An implementation producing a fixed number of consecutive blocks per call, XORed with in unless it is nullptr. */
+struct MultiBlock {
+    void (*crypt)(const uint32_t* input, const std::byte* in, std::byte* out){nullptr};
+    size_t blocks{0};
+};
+
+MultiBlock DetectMultiBlock()
+{
+#ifdef HAVE_GETCPUID
+#ifdef ENABLE_AVX512
+    if (HaveAVX512F()) return {chacha20_avx512::Crypt_16way, 16};
+#endif
+#ifdef ENABLE_AVX2
+    if (HaveAVX2()) return {chacha20_avx2::Crypt_8way, 8};
+#endif
+#endif
+    return {};
+}
+
+/**
+ * Process as many leading blocks as the vectorized implementation (if any) handles, advancing the block counter in
+ * input. Returns the number of blocks processed; the rest is left to the scalar code.
+ */
+size_t CryptMultiBlock(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks)
+{
+    static const MultiBlock impl{DetectMultiBlock()};
+    size_t done = 0;
+    if (!impl.crypt) return done;
+    while (blocks - done >= impl.blocks) {
+        impl.crypt(input, in ? in + done * ChaCha20Aligned::BLOCKLEN : nullptr, out + done * ChaCha20Aligned::BLOCKLEN);
+        const uint64_t counter = ((uint64_t{input[9]} << 32) | input[8]) + impl.blocks;
+        input[8] = counter;
+        input[9] = counter >> 32;
+        done += impl.blocks;
+    }
+    return done;
+}
+
+} // namespace
+
 void ChaCha20Aligned::SetKey(std::span<const std::byte> key) noexcept
 {
     assert(key.size() == KEYLEN);
@@ -67,6 +122,11 @@ inline void ChaCha20Aligned::Keystream(std::span<std::byte> output) noexcept
 
     if (!blocks) return;
 
+    const size_t vectorized = CryptMultiBlock(input, nullptr, c, blocks);
+    if (vectorized == blocks) return;
+    blocks -= vectorized;
+    c += vectorized * BLOCKLEN;
+
     j4 = input[0];
     j5 = input[1];
     j6 = input[2];
@@ -170,6 +230,12 @@ inline void ChaCha20Aligned::Crypt(std::span<const std::byte> in_bytes, std::spa
 
     if (!blocks) return;
 
+    const size_t vectorized = CryptMultiBlock(input, m, c, blocks);
+    if (vectorized == blocks) return;
+    blocks -= vectorized;
+    c += vectorized * BLOCKLEN;
+    m += vectorized * BLOCKLEN;
+
     j4 = input[0];
     j5 = input[1];
     j6 = input[2];
@@ -0,0 +1,112 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+namespace chacha20_avx2 {
+namespace {
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+
+template <int N>
+__m256i inline RotL(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N)); }
+
+// Rotations by whole bytes are a single byte shuffle.
+template <>
+__m256i inline RotL<16>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                                  13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+}
+
+template <>
+__m256i inline RotL<8>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                                                  14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3));
+}
+
+void ALWAYS_INLINE QuarterRound(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = Add(a, b); d = RotL<16>(Xor(d, a));
+    c = Add(c, d); b = RotL<12>(Xor(b, c));
+    a = Add(a, b); d = RotL<8>(Xor(d, a));
+    c = Add(c, d); b = RotL<7>(Xor(b, c));
+}
+
+/**
+ * Transpose 8 state words of 8 blocks (one vector per word) into 32 contiguous bytes per block, and write them to
+ * out + 64 * block + offset, XORed with the same bytes of in unless in is nullptr.
+ */
+void ALWAYS_INLINE WriteHalf(const __m256i* v, const std::byte* in, std::byte* out, int offset)
+{
+    const __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]), t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]), t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]), t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]), t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+    // u0 holds words 0-3 of blocks 0 and 4, u1 those of blocks 1 and 5, and so on; u4-u7 hold words 4-7.
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7);
+    const __m256i blocks[8] = {
+        _mm256_permute2x128_si256(u0, u4, 0x20), _mm256_permute2x128_si256(u1, u5, 0x20),
+        _mm256_permute2x128_si256(u2, u6, 0x20), _mm256_permute2x128_si256(u3, u7, 0x20),
+        _mm256_permute2x128_si256(u0, u4, 0x31), _mm256_permute2x128_si256(u1, u5, 0x31),
+        _mm256_permute2x128_si256(u2, u6, 0x31), _mm256_permute2x128_si256(u3, u7, 0x31),
+    };
+    for (int b = 0; b < 8; ++b) {
+        __m256i r = blocks[b];
+        if (in) r = Xor(r, _mm256_loadu_si256((const __m256i*)(in + 64 * b + offset)));
+        _mm256_storeu_si256((__m256i*)(out + 64 * b + offset), r);
+    }
+}
+
+}
+
+void Crypt_8way(const uint32_t* input, const std::byte* in, std::byte* out)
+{
+    // Block counters of the 8 lanes, carrying into the second counter word like the scalar code does.
+    alignas(32) uint32_t counter_lo[8], counter_hi[8];
+    for (uint32_t i = 0; i < 8; ++i) {
+        counter_lo[i] = input[8] + i;
+        counter_hi[i] = input[9] + (counter_lo[i] < input[8]);
+    }
+
+    __m256i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        _mm256_load_si256((const __m256i*)counter_lo), _mm256_load_si256((const __m256i*)counter_hi), K(input[10]), K(input[11]),
+    };
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int i = 0; i < 10; ++i) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+
+    WriteHalf(x, in, out, 0);
+    WriteHalf(x + 8, in, out, 32);
+}
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <cstddef>
+#include <cstdint>
+
+// GCC's AVX-512 intrinsic header can warn about the undefined pass-through operand of its masked builtins once they
+// are inlined into the rotations below; keep the suppression limited to the header.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <attributes.h>
+
+namespace chacha20_avx512 {
+namespace {
+
+__m512i inline K(uint32_t x) { return _mm512_set1_epi32(x); }
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }
+__m512i inline Xor(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+
+void ALWAYS_INLINE QuarterRound(__m512i& a, __m512i& b, __m512i& c, __m512i& d)
+{
+    a = Add(a, b); d = _mm512_rol_epi32(Xor(d, a), 16);
+    c = Add(c, d); b = _mm512_rol_epi32(Xor(b, c), 12);
+    a = Add(a, b); d = _mm512_rol_epi32(Xor(d, a), 8);
+    c = Add(c, d); b = _mm512_rol_epi32(Xor(b, c), 7);
+}
+
+void ALWAYS_INLINE WriteBlock(__m512i v, const std::byte* in, std::byte* out, int block)
+{
+    if (in) v = Xor(v, _mm512_loadu_si512(in + 64 * block));
+    _mm512_storeu_si512(out + 64 * block, v);
+}
+
+}
+
+void Crypt_16way(const uint32_t* input, const std::byte* in, std::byte* out)
+{
+    // Block counters of the 16 lanes, carrying into the second counter word like the scalar code does.
+    alignas(64) uint32_t counter_lo[16], counter_hi[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        counter_lo[i] = input[8] + i;
+        counter_hi[i] = input[9] + (counter_lo[i] < input[8]);
+    }
+
+    __m512i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        _mm512_load_si512(counter_lo), _mm512_load_si512(counter_hi), K(input[10]), K(input[11]),
+    };
+    __m512i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int i = 0; i < 10; ++i) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+
+    // Transpose the 16x16 matrix of words. Afterwards u[4 * g + r] holds words 4g..4g+3 of blocks r, r+4, r+8 and
+    // r+12, one block per 128-bit lane.
+    __m512i t[16], u[16];
+    for (int i = 0; i < 16; i += 2) {
+        t[i] = _mm512_unpacklo_epi32(x[i], x[i + 1]);
+        t[i + 1] = _mm512_unpackhi_epi32(x[i], x[i + 1]);
+    }
+    for (int g = 0; g < 16; g += 4) {
+        u[g] = _mm512_unpacklo_epi64(t[g], t[g + 2]);
+        u[g + 1] = _mm512_unpackhi_epi64(t[g], t[g + 2]);
+        u[g + 2] = _mm512_unpacklo_epi64(t[g + 1], t[g + 3]);
+        u[g + 3] = _mm512_unpackhi_epi64(t[g + 1], t[g + 3]);
+    }
+    for (int r = 0; r < 4; ++r) {
+        const __m512i a = _mm512_shuffle_i32x4(u[r], u[4 + r], 0x44), b = _mm512_shuffle_i32x4(u[r], u[4 + r], 0xEE);
+        const __m512i c = _mm512_shuffle_i32x4(u[8 + r], u[12 + r], 0x44), d = _mm512_shuffle_i32x4(u[8 + r], u[12 + r], 0xEE);
+        WriteBlock(_mm512_shuffle_i32x4(a, c, 0x88), in, out, r);
+        WriteBlock(_mm512_shuffle_i32x4(a, c, 0xDD), in, out, 4 + r);
+        WriteBlock(_mm512_shuffle_i32x4(b, d, 0x88), in, out, 8 + r);
+        WriteBlock(_mm512_shuffle_i32x4(b, d, 0xDD), in, out, 12 + r);
+    }
+}
+
+}
+
+#endif
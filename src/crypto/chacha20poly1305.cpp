@@ -10,6 +10,7 @@
 #include <span.h>
 #include <support/cleanse.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 
@@ -35,8 +36,12 @@ int timingsafe_bcmp_internal(const unsigned char* b1, const unsigned char* b2, s
     return (ret != 0);
 }
 
-/** Compute poly1305 tag. chacha20 must be set to the right nonce, block 0. Will be at block 1 after. */
-void ComputeTag(ChaCha20& chacha20, std::span<const std::byte> aad, std::span<const std::byte> cipher, std::span<std::byte> tag) noexcept
+/** Bytes processed per step of the one-pass AEAD, small enough for a chunk to stay in L1 between encryption and
+ *  authentication. A multiple of the ChaCha20 and Poly1305 block sizes, so neither needs to buffer partial blocks. */
+constexpr size_t AEAD_CHUNK_SIZE{4096};
+
+/** Start computing a poly1305 tag. chacha20 must be set to the right nonce, block 0. Will be at block 1 after. */
+Poly1305 StartTag(ChaCha20& chacha20, std::span<const std::byte> aad) noexcept
 {
     static const std::byte PADDING[16] = {{}};
 
@@ -47,17 +52,24 @@ void ComputeTag(ChaCha20& chacha20, std::span<const std::byte> aad, std::span<co
     // Use the first 32 bytes of the first keystream block as poly1305 key.
     Poly1305 poly1305{std::span{first_block}.first(Poly1305::KEYLEN)};
 
-    // Compute tag:
-    // - Process the padded AAD with Poly1305.
+    // Process the padded AAD with Poly1305.
     const unsigned aad_padding_length = (16 - (aad.size() % 16)) % 16;
     poly1305.Update(aad).Update(std::span{PADDING}.first(aad_padding_length));
-    // - Process the padded ciphertext with Poly1305.
-    const unsigned cipher_padding_length = (16 - (cipher.size() % 16)) % 16;
-    poly1305.Update(cipher).Update(std::span{PADDING}.first(cipher_padding_length));
+    return poly1305;
+}
+
+/** Finish a poly1305 tag after the ciphertext has been processed with StartTag's poly1305 object. */
+void FinishTag(Poly1305& poly1305, size_t aad_size, size_t cipher_size, std::span<std::byte> tag) noexcept
+{
+    static const std::byte PADDING[16] = {{}};
+
+    // - Pad the ciphertext.
+    const unsigned cipher_padding_length = (16 - (cipher_size % 16)) % 16;
+    poly1305.Update(std::span{PADDING}.first(cipher_padding_length));
     // - Process the AAD and plaintext length with Poly1305.
     std::byte length_desc[Poly1305::TAGLEN];
-    WriteLE64(length_desc, aad.size());
-    WriteLE64(length_desc + 8, cipher.size());
+    WriteLE64(length_desc, aad_size);
+    WriteLE64(length_desc + 8, cipher_size);
     poly1305.Update(length_desc);
 
     // Output tag.
@@ -70,29 +82,54 @@ void AEADChaCha20Poly1305::Encrypt(std::span<const std::byte> plain1, std::span<
 {
     assert(cipher.size() == plain1.size() + plain2.size() + EXPANSION);
 
-    // Encrypt using ChaCha20 (starting at block 1).
-    m_chacha20.Seek(nonce, 1);
-    m_chacha20.Crypt(plain1, cipher.first(plain1.size()));
-    m_chacha20.Crypt(plain2, cipher.subspan(plain1.size()).first(plain2.size()));
-
-    // Seek to block 0, and compute tag using key drawn from there.
+    // Draw the poly1305 key from block 0, and process the AAD.
     m_chacha20.Seek(nonce, 0);
-    ComputeTag(m_chacha20, aad, cipher.first(cipher.size() - EXPANSION), cipher.last(EXPANSION));
+    Poly1305 poly1305{StartTag(m_chacha20, aad)};
+
+    // Encrypt using ChaCha20 (continuing at block 1), authenticating every chunk of ciphertext while it is still in
+    // cache rather than in a second pass over the whole message.
+    size_t pos{0};
+    for (const auto plain : {plain1, plain2}) {
+        for (size_t i = 0; i < plain.size(); i += AEAD_CHUNK_SIZE) {
+            const auto in{plain.subspan(i, std::min(AEAD_CHUNK_SIZE, plain.size() - i))};
+            const auto out{cipher.subspan(pos, in.size())};
+            m_chacha20.Crypt(in, out);
+            poly1305.Update(out);
+            pos += in.size();
+        }
+    }
+    FinishTag(poly1305, aad.size(), pos, cipher.last(EXPANSION));
 }
 
 bool AEADChaCha20Poly1305::Decrypt(std::span<const std::byte> cipher, std::span<const std::byte> aad, Nonce96 nonce, std::span<std::byte> plain1, std::span<std::byte> plain2) noexcept
 {
     assert(cipher.size() == plain1.size() + plain2.size() + EXPANSION);
 
-    // Verify tag (using key drawn from block 0).
+    // Draw the poly1305 key from block 0, and process the AAD.
     m_chacha20.Seek(nonce, 0);
-    std::byte expected_tag[EXPANSION];
-    ComputeTag(m_chacha20, aad, cipher.first(cipher.size() - EXPANSION), expected_tag);
-    if (timingsafe_bcmp_internal(UCharCast(expected_tag), UCharCast(cipher.last(EXPANSION).data()), EXPANSION)) return false;
+    Poly1305 poly1305{StartTag(m_chacha20, aad)};
+
+    // Authenticate and decrypt (continuing at block 1) in the same pass. Every chunk is authenticated before it is
+    // decrypted, so this also works in place.
+    size_t pos{0};
+    for (const auto plain : {plain1, plain2}) {
+        for (size_t i = 0; i < plain.size(); i += AEAD_CHUNK_SIZE) {
+            const auto out{plain.subspan(i, std::min(AEAD_CHUNK_SIZE, plain.size() - i))};
+            const auto in{cipher.subspan(pos, out.size())};
+            poly1305.Update(in);
+            m_chacha20.Crypt(in, out);
+            pos += out.size();
+        }
+    }
 
-    // Decrypt (starting at block 1).
-    m_chacha20.Crypt(cipher.first(plain1.size()), plain1);
-    m_chacha20.Crypt(cipher.subspan(plain1.size()).first(plain2.size()), plain2);
+    // Verify tag, and do not leave plaintext of an unauthenticated message behind.
+    std::byte expected_tag[EXPANSION];
+    FinishTag(poly1305, aad.size(), pos, expected_tag);
+    if (timingsafe_bcmp_internal(UCharCast(expected_tag), UCharCast(cipher.last(EXPANSION).data()), EXPANSION)) {
+        memory_cleanse(plain1.data(), plain1.size());
+        memory_cleanse(plain2.data(), plain2.size());
+        return false;
+    }
     return true;
 }
 
@@ -49,7 +49,7 @@ public:
      */
     void Encrypt(std::span<const std::byte> plain1, std::span<const std::byte> plain2, std::span<const std::byte> aad, Nonce96 nonce, std::span<std::byte> cipher) noexcept;
 
-    /** Decrypt a message with a specified 96-bit nonce and aad. Returns true if valid.
+    /** Decrypt a message with a specified 96-bit nonce and aad. Returns true if valid, and zeroes plain otherwise.
      *
      * Requires cipher.size() = plain.size() + EXPANSION.
      */
@@ -58,7 +58,8 @@ public:
         return Decrypt(cipher, aad, nonce, plain, {});
     }
 
-    /** Decrypt a message with a specified 96-bit nonce and aad and split the result. Returns true if valid.
+    /** Decrypt a message with a specified 96-bit nonce and aad and split the result. Returns true if valid, and
+     *  zeroes plain1 and plain2 otherwise.
      *
      * Requires cipher.size() = plain1.size() + plain2.size() + EXPANSION.
      */
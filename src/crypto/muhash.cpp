@@ -4,6 +4,7 @@
 
 #include <crypto/muhash.h>
 
+#include <compat/cpuid.h>
 #include <crypto/chacha20.h>
 #include <crypto/common.h>
 #include <hash.h>
@@ -14,6 +15,13 @@
 #include <bit>
 #include <cstring>
 #include <limits>
+#include <string>
+
+#if defined(ENABLE_AVX512IFMA) && defined(__SIZEOF_INT128__)
+namespace muhash_avx512ifma {
+void Multiply(uint64_t* out, const uint64_t* a, const uint64_t* b);
+}
+#endif
 
 namespace {
 
@@ -110,6 +118,42 @@ inline void addnextract2(limb_t& c0, limb_t& c1, const limb_t& a, limb_t& n)
     c1 = c2;
 }
 
+/** A multiplication of two numbers of LIMBS limbs into their full product of 2 * LIMBS limbs. */
+using FullMultiplyFn = void (*)(limb_t* out, const limb_t* a, const limb_t* b);
+
+FullMultiplyFn DetectFullMultiply()
+{
+#if defined(HAVE_GETCPUID) && defined(ENABLE_AVX512IFMA) && defined(__SIZEOF_INT128__)
+    if (HaveAVX512IFMA()) return muhash_avx512ifma::Multiply;
+#endif
+    return nullptr;
+}
+
+/** The full multiplication in use by Num3072::Multiply, or nullptr for the generic implementation. */
+FullMultiplyFn g_full_multiply{DetectFullMultiply()};
+
+/**
+ * Reduce a full product modulo the modulus into out, using that 2^3072 = MAX_PRIME_DIFF (mod modulus). Returns 1 if
+ * out + 2^3072 is the result, which only happens when out is small.
+ */
+limb_t ReduceProduct(const limb_t (&product)[2 * LIMBS], limb_t (&out)[LIMBS])
+{
+    double_limb_t c = 0;
+    for (int i = 0; i < LIMBS; ++i) {
+        c += (double_limb_t)product[LIMBS + i] * MAX_PRIME_DIFF + product[i];
+        out[i] = c;
+        c >>= LIMB_SIZE;
+    }
+    // What carried out of the top limb is at most MAX_PRIME_DIFF, and is folded in once more.
+    c *= MAX_PRIME_DIFF;
+    for (int i = 0; i < LIMBS; ++i) {
+        c += out[i];
+        out[i] = c;
+        c >>= LIMB_SIZE;
+    }
+    return c;
+}
+
 } // namespace
 
 /** Indicates whether d is larger than the modulus. */
@@ -455,6 +499,15 @@ Num3072 Num3072::GetInverse() const
 
 void Num3072::Multiply(const Num3072& a)
 {
+    if (g_full_multiply) {
+        limb_t product[2 * LIMBS];
+        g_full_multiply(product, this->limbs, a.limbs);
+        const limb_t carry = ReduceProduct(product, this->limbs);
+        if (this->IsOverflow()) this->FullReduce();
+        if (carry) this->FullReduce();
+        return;
+    }
+
     limb_t c0 = 0, c1 = 0, c2 = 0;
     Num3072 tmp;
 
@@ -523,6 +576,15 @@ Num3072::Num3072(const unsigned char (&data)[BYTE_SIZE]) {
     }
 }
 
+std::string MuHashSelectImplementation(bool use_accelerated)
+{
+    g_full_multiply = use_accelerated ? DetectFullMultiply() : nullptr;
+#if defined(ENABLE_AVX512IFMA) && defined(__SIZEOF_INT128__)
+    if (g_full_multiply == muhash_avx512ifma::Multiply) return "avx512ifma";
+#endif
+    return "standard";
+}
+
 void Num3072::ToBytes(unsigned char (&out)[BYTE_SIZE]) {
     for (int i = 0; i < LIMBS; ++i) {
         if (sizeof(limb_t) == 4) {
@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <string>
 
 class uint256;
 
@@ -70,6 +71,12 @@ public:
     }
 };
 
+/**
+ * Choose whether Num3072::Multiply may use a hardware-accelerated implementation if the CPU supports one, and return
+ * the name of the implementation that is now in use. Not thread-safe; meant for tests and benchmarks.
+ */
+std::string MuHashSelectImplementation(bool use_accelerated = true);
+
 /** A class representing MuHash sets
  *
  * MuHash is a hashing algorithm that supports adding set elements in any
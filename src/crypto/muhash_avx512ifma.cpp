@@ -0,0 +1,104 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512IFMA
+
+#include <algorithm>
+#include <cstdint>
+
+// Limit the suppression of GCC's spurious uninitialized warnings from the AVX-512 masked builtins to the intrinsic
+// header itself, so this file's own code is still checked.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace muhash_avx512ifma {
+namespace {
+
+/** Number of 64-bit limbs of a 3072-bit number. */
+constexpr int LIMBS{48};
+/** Number of 52-bit limbs of a 3072-bit number, rounded up to whole vectors. */
+constexpr int LIMBS52{64};
+/** Number of 52-bit limbs that hold a 3072-bit number (59 * 52 = 3068). */
+constexpr int USED_LIMBS52{60};
+constexpr uint64_t MASK52{(uint64_t{1} << 52) - 1};
+
+/** Split a 3072-bit number into 52-bit limbs, zeroing the unused ones. */
+void ToRadix52(const uint64_t* in, uint64_t* out)
+{
+    for (int k = 0; k < USED_LIMBS52; ++k) {
+        const int word{52 * k / 64}, shift{52 * k % 64};
+        uint64_t v{in[word] >> shift};
+        if (shift > 64 - 52 && word + 1 < LIMBS) v |= in[word + 1] << (64 - shift);
+        out[k] = v & MASK52;
+    }
+    std::fill(out + USED_LIMBS52, out + LIMBS52, 0);
+}
+
+}
+
+void Multiply(uint64_t* out, const uint64_t* a, const uint64_t* b)
+{
+    // a is padded with a vector's worth of zero limbs on both sides, so that the shifted loads below may run past
+    // either end of it.
+    alignas(64) uint64_t a52[LIMBS52 + USED_LIMBS52 + LIMBS52];
+    uint64_t b52[LIMBS52];
+    std::fill(a52, a52 + LIMBS52, 0);
+    ToRadix52(a, a52 + LIMBS52);
+    std::fill(a52 + 2 * LIMBS52, a52 + LIMBS52 + USED_LIMBS52 + LIMBS52, 0);
+    ToRadix52(b, b52);
+
+    // Column k of the product collects the low 52 bits of a[i] * b[j] for i + j = k and the high bits for
+    // i + j = k - 1. Each vector of 8 columns is computed as the sum over j of a[k - j] * b[j], in four independent
+    // accumulators to hide the multiply latency. With at most 120 terms below 2^52 each, columns fit 64 bits.
+    constexpr int COLUMNS{2 * USED_LIMBS52};
+    alignas(64) uint64_t lo[COLUMNS], hi[COLUMNS];
+    for (int t = 0; t < COLUMNS / 8; ++t) {
+        __m512i l0 = _mm512_setzero_si512(), l1 = l0, l2 = l0, l3 = l0, h0 = l0, h1 = l0, h2 = l0, h3 = l0;
+        // Rounding the range of j to multiples of 4 only adds products with zero limbs.
+        const int j_begin{std::max(0, 8 * t - (USED_LIMBS52 - 1)) & ~3};
+        const int j_end{std::min(USED_LIMBS52, 8 * t + 8)};
+        for (int j = j_begin; j < j_end; j += 4) {
+            const uint64_t* x{a52 + LIMBS52 + 8 * t - j};
+            const __m512i x0 = _mm512_loadu_si512(x), y0 = _mm512_set1_epi64(b52[j]);
+            const __m512i x1 = _mm512_loadu_si512(x - 1), y1 = _mm512_set1_epi64(b52[j + 1]);
+            const __m512i x2 = _mm512_loadu_si512(x - 2), y2 = _mm512_set1_epi64(b52[j + 2]);
+            const __m512i x3 = _mm512_loadu_si512(x - 3), y3 = _mm512_set1_epi64(b52[j + 3]);
+            l0 = _mm512_madd52lo_epu64(l0, x0, y0);
+            h0 = _mm512_madd52hi_epu64(h0, x0, y0);
+            l1 = _mm512_madd52lo_epu64(l1, x1, y1);
+            h1 = _mm512_madd52hi_epu64(h1, x1, y1);
+            l2 = _mm512_madd52lo_epu64(l2, x2, y2);
+            h2 = _mm512_madd52hi_epu64(h2, x2, y2);
+            l3 = _mm512_madd52lo_epu64(l3, x3, y3);
+            h3 = _mm512_madd52hi_epu64(h3, x3, y3);
+        }
+        _mm512_store_si512(lo + 8 * t, _mm512_add_epi64(_mm512_add_epi64(l0, l1), _mm512_add_epi64(l2, l3)));
+        _mm512_store_si512(hi + 8 * t, _mm512_add_epi64(_mm512_add_epi64(h0, h1), _mm512_add_epi64(h2, h3)));
+    }
+
+    // Carry the columns into 52-bit limbs, and pack those into 64-bit limbs.
+    uint64_t digits[COLUMNS + 2];
+    uint64_t carry{0};
+    for (int k = 0; k < COLUMNS; ++k) {
+        carry += lo[k] + (k > 0 ? hi[k - 1] : 0);
+        digits[k] = carry & MASK52;
+        carry >>= 52;
+    }
+    digits[COLUMNS] = digits[COLUMNS + 1] = 0;
+    for (int i = 0; i < 2 * LIMBS; ++i) {
+        const int k{64 * i / 52}, shift{64 * i % 52};
+        out[i] = (digits[k] >> shift) | (digits[k + 1] << (52 - shift)) | (shift > 40 ? digits[k + 2] << (104 - shift) : 0);
+    }
+}
+
+}
+
+#endif
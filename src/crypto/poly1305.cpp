@@ -2,9 +2,17 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 #include <crypto/poly1305.h>
 
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+namespace poly1305_avx2 {
+/** Process blocks (a nonzero multiple of 4) message blocks into h, given r^1..r^4 in r_powers. */
+void Blocks_4way(uint32_t* h, const uint32_t (*r_powers)[5], const unsigned char* m, size_t blocks);
+}
+#endif
+
 namespace poly1305_donna {
 
 // Based on the public domain implementation by Andrew Moon
@@ -35,7 +43,52 @@ void poly1305_init(poly1305_context *st, const unsigned char key[32]) noexcept {
     st->final = 0;
 }
 
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+/* out = a * b, partially reduced like h in poly1305_blocks */
+static void poly1305_mul(uint32_t out[5], const uint32_t a[5], const uint32_t b[5]) noexcept {
+    const uint32_t s1 = b[1] * 5, s2 = b[2] * 5, s3 = b[3] * 5, s4 = b[4] * 5;
+    uint64_t d0,d1,d2,d3,d4;
+    uint32_t c;
+
+    d0 = ((uint64_t)a[0] * b[0]) + ((uint64_t)a[1] * s4) + ((uint64_t)a[2] * s3) + ((uint64_t)a[3] * s2) + ((uint64_t)a[4] * s1);
+    d1 = ((uint64_t)a[0] * b[1]) + ((uint64_t)a[1] * b[0]) + ((uint64_t)a[2] * s4) + ((uint64_t)a[3] * s3) + ((uint64_t)a[4] * s2);
+    d2 = ((uint64_t)a[0] * b[2]) + ((uint64_t)a[1] * b[1]) + ((uint64_t)a[2] * b[0]) + ((uint64_t)a[3] * s4) + ((uint64_t)a[4] * s3);
+    d3 = ((uint64_t)a[0] * b[3]) + ((uint64_t)a[1] * b[2]) + ((uint64_t)a[2] * b[1]) + ((uint64_t)a[3] * b[0]) + ((uint64_t)a[4] * s4);
+    d4 = ((uint64_t)a[0] * b[4]) + ((uint64_t)a[1] * b[3]) + ((uint64_t)a[2] * b[2]) + ((uint64_t)a[3] * b[1]) + ((uint64_t)a[4] * b[0]);
+
+                      c = (uint32_t)(d0 >> 26); out[0] = (uint32_t)d0 & 0x3ffffff;
+    d1 += c;          c = (uint32_t)(d1 >> 26); out[1] = (uint32_t)d1 & 0x3ffffff;
+    d2 += c;          c = (uint32_t)(d2 >> 26); out[2] = (uint32_t)d2 & 0x3ffffff;
+    d3 += c;          c = (uint32_t)(d3 >> 26); out[3] = (uint32_t)d3 & 0x3ffffff;
+    d4 += c;          c = (uint32_t)(d4 >> 26); out[4] = (uint32_t)d4 & 0x3ffffff;
+    out[0] += c * 5;  c = (out[0] >> 26);       out[0] &= 0x3ffffff;
+    out[1] += c;
+}
+
+/* Below this many bytes, computing the powers of r costs more than the 4-way code saves. */
+static constexpr size_t POLY1305_AVX2_MIN_BYTES{256};
+
+static bool poly1305_use_avx2() noexcept {
+    static const bool use_avx2{HaveAVX2()};
+    return use_avx2;
+}
+#endif
+
 static void poly1305_blocks(poly1305_context *st, const unsigned char *m, size_t bytes) noexcept {
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    /* hash groups of 4 blocks in parallel, using powers of r */
+    if (!st->final && bytes >= POLY1305_AVX2_MIN_BYTES && poly1305_use_avx2()) {
+        uint32_t r_powers[4][5];
+        for (int i = 0; i < 5; i++) r_powers[0][i] = st->r[i];
+        poly1305_mul(r_powers[1], r_powers[0], r_powers[0]);
+        poly1305_mul(r_powers[2], r_powers[1], r_powers[0]);
+        poly1305_mul(r_powers[3], r_powers[1], r_powers[1]);
+        const size_t blocks = bytes / (4 * POLY1305_BLOCK_SIZE) * 4;
+        poly1305_avx2::Blocks_4way(st->h, r_powers, m, blocks);
+        m += blocks * POLY1305_BLOCK_SIZE;
+        bytes -= blocks * POLY1305_BLOCK_SIZE;
+    }
+#endif
     const uint32_t hibit = (st->final) ? 0 : (1UL << 24); /* 1 << 128 */
     uint32_t r0,r1,r2,r3,r4;
     uint32_t s1,s2,s3,s4;
@@ -0,0 +1,109 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+namespace poly1305_avx2 {
+namespace {
+
+/** Poly1305 in radix 2^26, with the limbs of four independent accumulators in the 64-bit lanes of five vectors. */
+struct Limbs {
+    __m256i v[5];
+};
+
+__m256i inline Mask26() { return _mm256_set1_epi64x(0x3ffffff); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Mul(__m256i x, __m256i y) { return _mm256_mul_epu32(x, y); }
+__m256i inline Times5(__m256i x) { return Add(x, _mm256_slli_epi64(x, 2)); }
+
+/** Split four 16-byte message blocks into limbs, including the 2^128 bit. */
+Limbs ALWAYS_INLINE LoadMessage(const unsigned char* m)
+{
+    const __m256i a = _mm256_loadu_si256((const __m256i*)m), b = _mm256_loadu_si256((const __m256i*)(m + 32));
+    const __m256i lo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8);
+    const __m256i hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xD8);
+    return {{
+        _mm256_and_si256(lo, Mask26()),
+        _mm256_and_si256(_mm256_srli_epi64(lo, 26), Mask26()),
+        _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(lo, 52), _mm256_slli_epi64(hi, 12)), Mask26()),
+        _mm256_and_si256(_mm256_srli_epi64(hi, 14), Mask26()),
+        _mm256_or_si256(_mm256_srli_epi64(hi, 40), _mm256_set1_epi64x(1 << 24)),
+    }};
+}
+
+/** h *= r, with s = 5 * r, followed by the same partial reduction as the scalar code. */
+void ALWAYS_INLINE MulReduce(Limbs& h, const Limbs& r, const Limbs& s)
+{
+    const __m256i* x = h.v;
+    __m256i d0 = Add(Add(Add(Mul(x[0], r.v[0]), Mul(x[1], s.v[4])), Add(Mul(x[2], s.v[3]), Mul(x[3], s.v[2]))), Mul(x[4], s.v[1]));
+    __m256i d1 = Add(Add(Add(Mul(x[0], r.v[1]), Mul(x[1], r.v[0])), Add(Mul(x[2], s.v[4]), Mul(x[3], s.v[3]))), Mul(x[4], s.v[2]));
+    __m256i d2 = Add(Add(Add(Mul(x[0], r.v[2]), Mul(x[1], r.v[1])), Add(Mul(x[2], r.v[0]), Mul(x[3], s.v[4]))), Mul(x[4], s.v[3]));
+    __m256i d3 = Add(Add(Add(Mul(x[0], r.v[3]), Mul(x[1], r.v[2])), Add(Mul(x[2], r.v[1]), Mul(x[3], r.v[0]))), Mul(x[4], s.v[4]));
+    __m256i d4 = Add(Add(Add(Mul(x[0], r.v[4]), Mul(x[1], r.v[3])), Add(Mul(x[2], r.v[2]), Mul(x[3], r.v[1]))), Mul(x[4], r.v[0]));
+
+    d1 = Add(d1, _mm256_srli_epi64(d0, 26));
+    d2 = Add(d2, _mm256_srli_epi64(d1, 26));
+    d3 = Add(d3, _mm256_srli_epi64(d2, 26));
+    d4 = Add(d4, _mm256_srli_epi64(d3, 26));
+    __m256i h0 = Add(_mm256_and_si256(d0, Mask26()), Times5(_mm256_srli_epi64(d4, 26)));
+    h.v[1] = Add(_mm256_and_si256(d1, Mask26()), _mm256_srli_epi64(h0, 26));
+    h.v[0] = _mm256_and_si256(h0, Mask26());
+    h.v[2] = _mm256_and_si256(d2, Mask26());
+    h.v[3] = _mm256_and_si256(d3, Mask26());
+    h.v[4] = _mm256_and_si256(d4, Mask26());
+}
+
+}
+
+void Blocks_4way(uint32_t* h, const uint32_t (*r_powers)[5], const unsigned char* m, size_t blocks)
+{
+    // Every accumulator is multiplied by r^4 per group of four blocks, except for the last group, after which lane i
+    // is multiplied by r^(4-i) so that the sum of the lanes equals the serially computed result.
+    Limbs r4, s4, r_last, s_last, acc;
+    for (int i = 0; i < 5; ++i) {
+        r4.v[i] = _mm256_set1_epi64x(r_powers[3][i]);
+        s4.v[i] = Times5(r4.v[i]);
+        r_last.v[i] = _mm256_set_epi64x(r_powers[0][i], r_powers[1][i], r_powers[2][i], r_powers[3][i]);
+        s_last.v[i] = Times5(r_last.v[i]);
+        acc.v[i] = _mm256_set_epi64x(0, 0, 0, h[i]);
+    }
+
+    for (;;) {
+        const Limbs msg = LoadMessage(m);
+        for (int i = 0; i < 5; ++i) acc.v[i] = Add(acc.v[i], msg.v[i]);
+        if (blocks == 4) break;
+        MulReduce(acc, r4, s4);
+        m += 64;
+        blocks -= 4;
+    }
+    MulReduce(acc, r_last, s_last);
+
+    // Sum the lanes and carry, so the limbs fit the scalar code's assumptions again.
+    uint64_t sum[5];
+    for (int i = 0; i < 5; ++i) {
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256((__m256i*)lanes, acc.v[i]);
+        sum[i] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    for (int i = 0; i < 4; ++i) {
+        sum[i + 1] += sum[i] >> 26;
+        sum[i] &= 0x3ffffff;
+    }
+    sum[0] += (sum[4] >> 26) * 5;
+    sum[4] &= 0x3ffffff;
+    sum[1] += sum[0] >> 26;
+    sum[0] &= 0x3ffffff;
+    for (int i = 0; i < 5; ++i) h[i] = sum[i];
+}
+
+}
+
+#endif
@@ -34,11 +34,26 @@ namespace sha256d64_sse41
 void Transform_4way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_sse41
+{
+void Transform_4way(uint32_t* s, const unsigned char* const* chunks);
+}
+
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_avx2
+{
+void Transform_8way(uint32_t* s, const unsigned char* const* chunks);
+}
+
+namespace sha256d64_avx512
+{
+void Transform_16way(unsigned char* out, const unsigned char* in);
+}
+
 namespace sha256d64_x86_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
@@ -437,6 +452,8 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+/** Perform one SHA-256 transformation in each of several lanes. The state of lane i is at s + 8 * i, its chunk at chunks[i]. */
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -482,6 +499,9 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformD64_16way = nullptr;
+TransformMultiType TransformMulti_4way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -565,6 +585,31 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformD64_16way, if available, on the 8 messages above repeated twice.
+    if (TransformD64_16way) {
+        unsigned char in[1024];
+        std::copy(data + 1, data + 513, in);
+        std::copy(data + 1, data + 513, in + 512);
+        unsigned char out[512];
+        TransformD64_16way(out, in);
+        if (!std::equal(out, out + 256, result_d64) || !std::equal(out + 256, out + 512, result_d64)) return false;
+    }
+
+    // Test the multi-lane transforms, if available, with lane i transforming the state after i chunks with chunk i.
+    for (const auto& [transform, lanes] : {std::pair{TransformMulti_4way, 4}, std::pair{TransformMulti_8way, 8}}) {
+        if (!transform) continue;
+        uint32_t states[64];
+        const unsigned char* chunks[8];
+        for (int i = 0; i < lanes; ++i) {
+            std::copy(result[i], result[i] + 8, states + 8 * i);
+            chunks[i] = data + 1 + 64 * i;
+        }
+        transform(states, chunks);
+        for (int i = 0; i < lanes; ++i) {
+            if (!std::equal(states + 8 * i, states + 8 * i + 8, result[i + 1])) return false;
+        }
+    }
+
     return true;
 }
 
@@ -573,9 +618,13 @@ bool SelfTest() {
 /** Check whether the OS has enabled AVX registers. */
 bool AVXEnabled()
 {
-    uint32_t a, d;
-    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
-    return (a & 6) == 6;
+    return (GetXCR0() & 6) == 6;
+}
+
+/** Check whether the OS has enabled AVX-512 registers, in addition to the AVX ones. */
+bool AVX512Enabled()
+{
+    return (GetXCR0() & 0xe6) == 0xe6;
 }
 #endif
 #endif // DISABLE_OPTIMIZED_SHA256
@@ -590,6 +639,9 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     TransformD64_2way = nullptr;
     TransformD64_4way = nullptr;
     TransformD64_8way = nullptr;
+    TransformD64_16way = nullptr;
+    TransformMulti_4way = nullptr;
+    TransformMulti_8way = nullptr;
 
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(HAVE_GETCPUID)
@@ -597,8 +649,10 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     bool have_xsave = false;
     bool have_avx = false;
     [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool have_avx512 = false;
     [[maybe_unused]] bool have_x86_shani = false;
     [[maybe_unused]] bool enabled_avx = false;
+    [[maybe_unused]] bool enabled_avx512 = false;
 
     uint32_t eax, ebx, ecx, edx;
     GetCPUID(1, 0, eax, ebx, ecx, edx);
@@ -609,12 +663,16 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     have_avx = (ecx >> 28) & 1;
     if (have_xsave && have_avx) {
         enabled_avx = AVXEnabled();
+        enabled_avx512 = enabled_avx && AVX512Enabled();
     }
     if (have_sse4) {
         GetCPUID(7, 0, eax, ebx, ecx, edx);
         if (use_implementation & sha256_implementation::USE_AVX2) {
             have_avx2 = (ebx >> 5) & 1;
         }
+        if (use_implementation & sha256_implementation::USE_AVX512) {
+            have_avx512 = (ebx >> 16) & 1;
+        }
         if (use_implementation & sha256_implementation::USE_SHANI) {
             have_x86_shani = (ebx >> 29) & 1;
         }
@@ -639,6 +697,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #endif
 #if defined(ENABLE_SSE41)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformMulti_4way = sha256_sse41::Transform_4way;
         ret += ";sse41(4way)";
 #endif
     }
@@ -646,9 +705,18 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #if defined(ENABLE_AVX2)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti_8way = sha256_avx2::Transform_8way;
         ret += ";avx2(8way)";
     }
 #endif
+
+#if defined(ENABLE_AVX512)
+    // Unlike the SSE4 and AVX2 ones, the AVX-512 transform outperforms SHA-NI, so it is also used alongside it.
+    if (have_avx512 && enabled_avx512) {
+        TransformD64_16way = sha256d64_avx512::Transform_16way;
+        ret += ";avx512(16way)";
+    }
+#endif
 #endif // defined(HAVE_GETCPUID)
 
 #if defined(ENABLE_ARM_SHANI)
@@ -748,6 +816,14 @@ CSHA256& CSHA256::Reset()
 
 void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
 {
+    if (TransformD64_16way) {
+        while (blocks >= 16) {
+            TransformD64_16way(out, in);
+            out += 512;
+            in += 1024;
+            blocks -= 16;
+        }
+    }
     if (TransformD64_8way) {
         while (blocks >= 8) {
             TransformD64_8way(out, in);
@@ -779,3 +855,135 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+namespace {
+/** One lane of SHA256DMulti, working through the chunks of one of the two SHA-256 passes over a message. */
+struct MultiLane
+{
+    //! Whether the lane is hashing a message at all.
+    bool active{false};
+    //! Index of the message being hashed.
+    size_t input;
+    //! Whether the lane is in the second pass, over the result of the first.
+    bool outer;
+    //! Full 64-byte chunks of the message that are still to be transformed.
+    const unsigned char* data;
+    size_t data_chunks;
+    //! The padded final chunk(s) of the message, of which tail_chunks starting at tail_next are still to be transformed.
+    unsigned char tail[128];
+    const unsigned char* tail_next;
+    size_t tail_chunks;
+    //! The result of the first pass.
+    unsigned char digest[CSHA256::OUTPUT_SIZE];
+
+    void Start(uint32_t* s, const unsigned char* msg, size_t len)
+    {
+        sha256::Initialize(s);
+        data = msg;
+        data_chunks = len / 64;
+        const size_t rem{len % 64};
+        tail_chunks = rem < 56 ? 1 : 2;
+        if (rem) std::memcpy(tail, msg + len - rem, rem);
+        tail[rem] = 0x80;
+        std::memset(tail + rem + 1, 0, tail_chunks * 64 - rem - 9);
+        WriteBE64(tail + tail_chunks * 64 - 8, uint64_t{len} << 3);
+        tail_next = tail;
+    }
+
+    const unsigned char* NextChunk()
+    {
+        const unsigned char* ret;
+        if (data_chunks) {
+            ret = data;
+            data += 64;
+            --data_chunks;
+        } else {
+            ret = tail_next;
+            tail_next += 64;
+            --tail_chunks;
+        }
+        return ret;
+    }
+
+    bool PassDone() const { return data_chunks == 0 && tail_chunks == 0; }
+};
+
+void WriteState(unsigned char* out, const uint32_t* s)
+{
+    for (int i = 0; i < 8; ++i) WriteBE32(out + 4 * i, s[i]);
+}
+} // namespace
+
+bool SHA256DMultiIsParallel()
+{
+    return TransformMulti_8way || TransformMulti_4way;
+}
+
+void SHA256DMulti(unsigned char* output, std::span<const std::span<const unsigned char>> inputs)
+{
+    const TransformMultiType transform{TransformMulti_8way ? TransformMulti_8way : TransformMulti_4way};
+    if (!transform) {
+        for (const auto& input : inputs) {
+            unsigned char inner[CSHA256::OUTPUT_SIZE];
+            CSHA256().Write(input.data(), input.size()).Finalize(inner);
+            CSHA256().Write(inner, sizeof(inner)).Finalize(output);
+            output += CSHA256::OUTPUT_SIZE;
+        }
+        return;
+    }
+    const size_t lanes{TransformMulti_8way ? 8U : 4U};
+
+    // Idle lanes transform a dummy chunk, and their state is discarded.
+    static const unsigned char idle_chunk[64] = {0};
+    uint32_t states[8 * 8] = {0};
+    MultiLane lane[8];
+    const unsigned char* chunks[8];
+    size_t next_input{0};
+
+    const auto start = [&](size_t i) {
+        lane[i].active = next_input < inputs.size();
+        if (!lane[i].active) return;
+        lane[i].input = next_input;
+        lane[i].outer = false;
+        lane[i].Start(states + 8 * i, inputs[next_input].data(), inputs[next_input].size());
+        ++next_input;
+    };
+    // Continue with the second pass once the first is done, and with the next message once both are.
+    const auto pass_done = [&](size_t i) {
+        if (!lane[i].outer) {
+            WriteState(lane[i].digest, states + 8 * i);
+            lane[i].outer = true;
+            lane[i].Start(states + 8 * i, lane[i].digest, sizeof(lane[i].digest));
+        } else {
+            WriteState(output + CSHA256::OUTPUT_SIZE * lane[i].input, states + 8 * i);
+            start(i);
+        }
+    };
+
+    for (size_t i = 0; i < lanes; ++i) start(i);
+    while (true) {
+        size_t busy{0}, last{0};
+        for (size_t i = 0; i < lanes; ++i) {
+            if (lane[i].active) {
+                ++busy;
+                last = i;
+            }
+        }
+        if (busy == 0) break;
+        if (busy == 1) {
+            // All other messages are done, so the multi-lane transform would only do wasted work for this one.
+            while (lane[last].active) {
+                Transform(states + 8 * last, lane[last].NextChunk(), 1);
+                if (lane[last].PassDone()) pass_done(last);
+            }
+            break;
+        }
+        for (size_t i = 0; i < lanes; ++i) {
+            chunks[i] = lane[i].active ? lane[i].NextChunk() : idle_chunk;
+        }
+        transform(states, chunks);
+        for (size_t i = 0; i < lanes; ++i) {
+            if (lane[i].active && lane[i].PassDone()) pass_done(i);
+        }
+    }
+}
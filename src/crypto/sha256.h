@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <span>
 #include <string>
 
 /** A hasher class for SHA-256. */
@@ -32,9 +33,11 @@ enum UseImplementation : uint8_t {
     USE_SSE4 = 1 << 0,
     USE_AVX2 = 1 << 1,
     USE_SHANI = 1 << 2,
+    USE_AVX512 = 1 << 3,
     USE_SSE4_AND_AVX2 = USE_SSE4 | USE_AVX2,
     USE_SSE4_AND_SHANI = USE_SSE4 | USE_SHANI,
-    USE_ALL = USE_SSE4 | USE_AVX2 | USE_SHANI,
+    USE_SSE4_AVX2_AND_AVX512 = USE_SSE4 | USE_AVX2 | USE_AVX512,
+    USE_ALL = USE_SSE4 | USE_AVX2 | USE_SHANI | USE_AVX512,
 };
 }
 
@@ -50,4 +53,16 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute the double-SHA256's of several messages of arbitrary length.
+ *  Where available, the messages are hashed in the lanes of a multi-way SHA-256 transform,
+ *  with each lane moving on to the next message as soon as it is done with one.
+ *  output:  pointer to a inputs.size()*32 byte output buffer
+ *  inputs:  the messages to hash.
+ */
+void SHA256DMulti(unsigned char* output, std::span<const std::span<const unsigned char>> inputs);
+
+/** Whether SHA256DMulti hashes messages in parallel lanes. If not, as when SHA-NI is used, it hashes them one after
+ *  the other, and batching messages for it brings nothing. */
+bool SHA256DMultiIsParallel();
+
 #endif // BITCOIN_CRYPTO_SHA256_H
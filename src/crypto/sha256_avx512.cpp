@@ -0,0 +1,149 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <array>
+#include <cstdint>
+
+// Some GCC versions warn about the deliberately undefined pass-through operand of the masked builtins behind the
+// AVX-512 intrinsics. The warning is attributed to the intrinsic header, so only silence it there.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <attributes.h>
+
+namespace sha256d64_avx512 {
+namespace {
+
+constexpr std::array<uint32_t, 64> ROUND_CONSTANTS{
+    0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul, 0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+    0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul, 0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+    0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul, 0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+    0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul, 0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+    0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul, 0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+    0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul, 0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+    0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul, 0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+    0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul, 0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+};
+
+/** Round constants plus message schedule of the padding chunk, which is the second chunk of every 64-byte message. */
+constexpr std::array<uint32_t, 64> PADDING_KW = [] {
+    constexpr auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+    std::array<uint32_t, 64> w{0x80000000ul};
+    w[15] = 0x200;
+    for (int i = 16; i < 64; ++i) {
+        w[i] = w[i - 16] + (rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 7] + (rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10));
+    }
+    for (int i = 0; i < 64; ++i) w[i] += ROUND_CONSTANTS[i];
+    return w;
+}();
+
+const uint32_t INIT[8] = {0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul};
+
+__m512i inline K(uint32_t x) { return _mm512_set1_epi32(x); }
+
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }
+__m512i inline Add(__m512i x, __m512i y, __m512i z) { return Add(Add(x, y), z); }
+__m512i inline Add(__m512i x, __m512i y, __m512i z, __m512i w) { return Add(Add(x, y), Add(z, w)); }
+__m512i inline Inc(__m512i& x, __m512i y, __m512i z, __m512i w) { x = Add(x, y, z, w); return x; }
+__m512i inline Xor(__m512i x, __m512i y, __m512i z) { return _mm512_ternarylogic_epi32(x, y, z, 0x96); }
+
+__m512i inline Ch(__m512i x, __m512i y, __m512i z) { return _mm512_ternarylogic_epi32(x, y, z, 0xCA); }
+__m512i inline Maj(__m512i x, __m512i y, __m512i z) { return _mm512_ternarylogic_epi32(x, y, z, 0xE8); }
+__m512i inline Sigma0(__m512i x) { return Xor(_mm512_ror_epi32(x, 2), _mm512_ror_epi32(x, 13), _mm512_ror_epi32(x, 22)); }
+__m512i inline Sigma1(__m512i x) { return Xor(_mm512_ror_epi32(x, 6), _mm512_ror_epi32(x, 11), _mm512_ror_epi32(x, 25)); }
+__m512i inline sigma0(__m512i x) { return Xor(_mm512_ror_epi32(x, 7), _mm512_ror_epi32(x, 18), _mm512_srli_epi32(x, 3)); }
+__m512i inline sigma1(__m512i x) { return Xor(_mm512_ror_epi32(x, 17), _mm512_ror_epi32(x, 19), _mm512_srli_epi32(x, 10)); }
+
+/** Reverse the bytes of each 32-bit word, without requiring AVX512BW for a byte shuffle. */
+__m512i inline ByteSwap(__m512i x) { return Ch(K(0xFF00FF00ul), _mm512_ror_epi32(x, 8), _mm512_rol_epi32(x, 8)); }
+
+/** One round of SHA-256. */
+void ALWAYS_INLINE Round(__m512i a, __m512i b, __m512i c, __m512i& d, __m512i e, __m512i f, __m512i g, __m512i& h, __m512i k)
+{
+    __m512i t1 = Add(h, Sigma1(e), Ch(e, f, g), k);
+    __m512i t2 = Add(Sigma0(a), Maj(a, b, c));
+    d = Add(d, t1);
+    h = Add(t1, t2);
+}
+
+/** 64 rounds over the state s, with kw(i) giving round constant plus message schedule word i. */
+template <typename KW>
+void ALWAYS_INLINE Rounds(__m512i* s, KW kw)
+{
+    __m512i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; i += 8) {
+        Round(a, b, c, d, e, f, g, h, kw(i));
+        Round(h, a, b, c, d, e, f, g, kw(i + 1));
+        Round(g, h, a, b, c, d, e, f, kw(i + 2));
+        Round(f, g, h, a, b, c, d, e, kw(i + 3));
+        Round(e, f, g, h, a, b, c, d, kw(i + 4));
+        Round(d, e, f, g, h, a, b, c, kw(i + 5));
+        Round(c, d, e, f, g, h, a, b, kw(i + 6));
+        Round(b, c, d, e, f, g, h, a, kw(i + 7));
+    }
+    s[0] = Add(s[0], a);
+    s[1] = Add(s[1], b);
+    s[2] = Add(s[2], c);
+    s[3] = Add(s[3], d);
+    s[4] = Add(s[4], e);
+    s[5] = Add(s[5], f);
+    s[6] = Add(s[6], g);
+    s[7] = Add(s[7], h);
+}
+
+/** Transform the state s with a chunk whose 16 message words are in w. */
+void ALWAYS_INLINE Transform(__m512i* s, __m512i* w)
+{
+    Rounds(s, [&](int i) {
+        if (i >= 16) Inc(w[i & 15], sigma1(w[(i + 14) & 15]), w[(i + 9) & 15], sigma0(w[(i + 1) & 15]));
+        return Add(K(ROUND_CONSTANTS[i]), w[i & 15]);
+    });
+}
+
+/** Offsets of the 16 lanes' data, spaced stride bytes apart. */
+__m512i inline LaneOffsets(int stride, int offset)
+{
+    return Add(_mm512_mullo_epi32(_mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), K(stride)), K(offset));
+}
+
+}
+
+void Transform_16way(unsigned char* out, const unsigned char* in)
+{
+    __m512i s[8], w[16];
+
+    // Transform 1
+    for (int i = 0; i < 8; ++i) s[i] = K(INIT[i]);
+    for (int i = 0; i < 16; ++i) w[i] = ByteSwap(_mm512_i32gather_epi32(LaneOffsets(64, 4 * i), in, 1));
+    Transform(s, w);
+
+    // Transform 2
+    Rounds(s, [](int i) { return K(PADDING_KW[i]); });
+
+    // Transform 3
+    for (int i = 0; i < 8; ++i) {
+        w[i] = s[i];
+        s[i] = K(INIT[i]);
+    }
+    w[8] = K(0x80000000ul);
+    for (int i = 9; i < 15; ++i) w[i] = K(0);
+    w[15] = K(0x100);
+    Transform(s, w);
+
+    // Output
+    for (int i = 0; i < 8; ++i) _mm512_i32scatter_epi32(out, LaneOffsets(32, 4 * i), ByteSwap(s[i]), 1);
+}
+
+}
+
+#endif
@@ -967,12 +967,12 @@ void HTTPServer::SocketHandlerListening(const Sock::EventsPerSock& events_per_so
     }
 }
 
-HTTPServer::IOReadiness HTTPServer::GenerateWaitSockets() const
+HTTPServer::IOReadiness HTTPServer::GenerateWaitSockets()
 {
     IOReadiness io_readiness;
 
     for (const auto& sock : m_listen) {
-        io_readiness.events_per_sock.emplace(sock, Sock::Events{Sock::RecvEvent});
+        m_sock_wait_set.Set(sock, Sock::RecvEvent);
     }
 
     for (const auto& http_client : m_connected) {
@@ -987,7 +987,7 @@ HTTPServer::IOReadiness HTTPServer::GenerateWaitSockets() const
         // them in the opposite order here would risk a lock-order inversion deadlock.
         const bool send_ready{WITH_LOCK(http_client->m_send_mutex, return http_client->m_send_ready;)};
         Sock::Event event = (send_ready ? Sock::SendEvent : Sock::RecvEvent);
-        io_readiness.events_per_sock.emplace(sock, Sock::Events{event});
+        m_sock_wait_set.Set(sock, event);
         io_readiness.httpclients_per_sock.emplace(sock, http_client);
     }
 
@@ -1003,10 +1003,7 @@ void HTTPServer::ThreadSocketHandler()
         // select(2)). If none are ready, wait for a short while and return
         // empty sets.
         auto io_readiness{GenerateWaitSockets()};
-        if (io_readiness.events_per_sock.empty() ||
-            // WaitMany() may as well be a static method, the context of the first Sock in the vector is not relevant.
-            !io_readiness.events_per_sock.begin()->first->WaitMany(SELECT_TIMEOUT,
-                                                                   io_readiness.events_per_sock)) {
+        if (!m_sock_wait_set.Wait(SELECT_TIMEOUT, io_readiness.events_per_sock)) {
             m_interrupt_net.sleep_for(SELECT_TIMEOUT);
         }
 
@@ -1019,6 +1016,7 @@ void HTTPServer::ThreadSocketHandler()
         // Disconnect any clients that have been flagged.
         DisconnectClients();
     }
+    m_sock_wait_set.Clear();
 }
 
 void HTTPServer::MaybeDispatchRequestsFromClient(const std::shared_ptr<HTTPRemoteClient>& client) const
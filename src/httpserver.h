@@ -391,6 +391,11 @@ private:
      */
     std::thread m_thread_socket_handler;
 
+    /**
+     * Sockets waited on by the I/O loop, only accessed from m_thread_socket_handler.
+     */
+    SockWaitSet m_sock_wait_set;
+
     /*
      * What to do with HTTP requests once received, validated and parsed.
      * Set in main thread by server start and interrupt but read in
@@ -451,11 +456,11 @@ private:
     void SocketHandlerListening(const Sock::EventsPerSock& events_per_sock);
 
     /**
-     * Generate a collection of sockets to check for IO readiness.
-     * @return Sockets to check for readiness plus an aux map to find the
-     * corresponding HTTPRemoteClient given a socket.
+     * Update the events to check for IO readiness on the sockets in m_sock_wait_set.
+     * @return An aux map to find the corresponding HTTPRemoteClient given a
+     * socket, with no sockets ready yet.
      */
-    IOReadiness GenerateWaitSockets() const;
+    IOReadiness GenerateWaitSockets();
 
     /**
      * Check connected and listening sockets for IO readiness and process them accordingly.
@@ -21,19 +21,24 @@
 #include <uint256.h>
 #include <undo.h>
 #include <util/check.h>
+#include <util/expected.h>
 #include <util/fs.h>
 #include <util/log.h>
 #include <util/string.h>
 #include <util/thread.h>
+#include <util/threadpool.h>
 #include <util/threadinterrupt.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <any>
 #include <compare>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <future>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -48,6 +53,8 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+/** Number of blocks each sync worker prepares ahead of the block being appended. */
+constexpr size_t SYNC_PREPARE_AHEAD_PER_WORKER{8};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -115,7 +122,7 @@ bool BaseIndex::Init()
                              return &m_chain->context()->chainman->ValidatedChainstate());
     // Register to validation interface before setting the 'm_synced' flag, so that
     // callbacks are not missed once m_synced is true.
-    m_chain->context()->validation_signals->RegisterValidationInterface(this);
+    m_chain->context()->validation_signals->RegisterValidationInterface(this, GetName());
 
     const auto locator{GetDB().ReadBestBlock()};
 
@@ -205,12 +212,77 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
     return true;
 }
 
+struct BaseIndex::SyncPipeline {
+    ThreadPool pool;
+    const size_t max_ahead;
+    const bool need_undo;
+    //! Blocks following each other on a chain, with the results of their CustomPrepare calls.
+    std::deque<std::pair<const CBlockIndex*, std::future<util::Expected<std::any, std::string>>>> blocks;
+
+    SyncPipeline(const std::string& thread_name, int workers, bool need_undo)
+        : pool{thread_name}, max_ahead{workers * SYNC_PREPARE_AHEAD_PER_WORKER}, need_undo{need_undo}
+    {
+        pool.Start(workers);
+    }
+};
+
+bool BaseIndex::ProcessPreparedBlock(SyncPipeline& pipeline, const CBlockIndex* pindex)
+{
+    auto& blocks{pipeline.blocks};
+    const auto prepare{[this, need_undo = pipeline.need_undo](const CBlockIndex* block_index) -> util::Expected<std::any, std::string> {
+        CBlock block;
+        if (!m_chainstate->m_blockman.ReadBlock(block, *block_index)) {
+            return util::Unexpected{strprintf("Failed to read block %s from disk", block_index->GetBlockHash().ToString())};
+        }
+        interfaces::BlockInfo block_info = kernel::MakeBlockInfo(block_index, &block);
+        CBlockUndo block_undo;
+        if (need_undo) {
+            if (block_index->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *block_index)) {
+                return util::Unexpected{strprintf("Failed to read undo block data %s from disk", block_index->GetBlockHash().ToString())};
+            }
+            block_info.undo_data = &block_undo;
+        }
+        return CustomPrepare(block_info);
+    }};
+
+    // Blocks prepared ahead of a rewind belong to the branch that was rewound.
+    if (!blocks.empty() && blocks.front().first != pindex) blocks.clear();
+
+    // Keep the workers busy with the blocks following pindex, as far as they are on the chain.
+    for (const CBlockIndex* next{blocks.empty() ? pindex : nullptr}; blocks.size() < pipeline.max_ahead;) {
+        if (!next) next = WITH_LOCK(::cs_main, return m_chainstate->m_chain.Next(*blocks.back().first));
+        if (!next) break;
+        auto future{pipeline.pool.Submit([prepare, next] { return prepare(next); })};
+        if (!future) break;
+        blocks.emplace_back(next, std::move(*future));
+        next = nullptr;
+    }
+    if (blocks.empty()) return ProcessBlock(pindex);
+
+    auto prepared{blocks.front().second.get()};
+    blocks.pop_front();
+    if (!prepared) {
+        FatalErrorf("%s", prepared.error());
+        return false;
+    }
+    if (!CustomAppendPrepared(kernel::MakeBlockInfo(pindex), std::move(*prepared))) {
+        FatalErrorf("Failed to write block %s to index database",
+                    pindex->GetBlockHash().ToString());
+        return false;
+    }
+    return true;
+}
+
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
         auto last_log_time{NodeClock::now()};
         auto last_locator_write_time{last_log_time};
+        std::optional<SyncPipeline> pipeline;
+        if (m_sync_workers > 0 && AllowParallelSync()) {
+            pipeline.emplace(m_thread_name, m_sync_workers, CustomOptions().connect_undo_data);
+        }
         while (true) {
             if (m_interrupt) {
                 LogInfo("%s: m_interrupt set; exiting ThreadSync", GetName());
@@ -250,7 +322,11 @@ void BaseIndex::Sync()
             pindex = pindex_next;
 
 
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            if (pipeline) {
+                if (!ProcessPreparedBlock(*pipeline, pindex)) return; // error logged internally
+            } else if (!ProcessBlock(pindex)) {
+                return; // error logged internally
+            }
 
             auto current_time{NodeClock::now()};
             if (current_time - last_log_time >= SYNC_LOG_INTERVAL) {
@@ -276,6 +352,11 @@ void BaseIndex::Sync()
 
 void BaseIndex::Commit()
 {
+    if (!CustomFlush()) {
+        LogError("Failed to write buffered %s entries", GetName());
+        return;
+    }
+
     // Don't commit anything if we haven't indexed any block yet
     // (this could happen if init is interrupted).
     bool ok = m_best_block_index != nullptr;
@@ -307,6 +388,9 @@ bool BaseIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_ti
 {
     assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
 
+    // Entries of the blocks being disconnected may still be buffered.
+    if (!CustomFlush()) return false;
+
     CBlock block;
     CBlockUndo block_undo;
 
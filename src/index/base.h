@@ -15,6 +15,7 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <any>
 #include <atomic>
 #include <cstddef>
 #include <memory>
@@ -25,8 +26,17 @@
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class ThreadPool;
 
 struct CBlockLocator;
+
+/** Default for -indexworkers, the number of threads preparing the entries of upcoming blocks during the initial sync of an index. */
+inline constexpr int DEFAULT_INDEX_WORKERS{0};
+/** Maximum for -indexworkers. */
+inline constexpr int MAX_INDEX_WORKERS{16};
+/** Number of entries an index buffers during the initial sync before writing them to the database in one batch. */
+inline constexpr size_t SYNC_WRITE_BATCH_ENTRIES{500'000};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -94,10 +104,14 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Number of threads running CustomPrepare ahead of the sync thread, for indexes that allow it.
+    int m_sync_workers{DEFAULT_INDEX_WORKERS};
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     /// Will skip the commit if no block has been indexed yet or if the index's best block is
     /// ahead of the chainstate's last flushed block. This avoids persisting state an unclean shutdown
     /// could not roll back from. A later call commits when the chainstate has flushed far enough.
+    /// Buffered index entries (see CustomFlush) are written in either case.
     void Commit();
 
     /// Loop over disconnected blocks and call CustomRemove.
@@ -105,6 +119,13 @@ private:
 
     bool ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data = nullptr);
 
+    /// The blocks for which CustomPrepare is running on the sync workers.
+    struct SyncPipeline;
+
+    /// Append a block during the initial sync from the result of CustomPrepare, after making sure it is being
+    /// computed for the blocks following it.
+    bool ProcessPreparedBlock(SyncPipeline& pipeline, const CBlockIndex* pindex);
+
     virtual bool AllowPrune() const = 0;
 
     template <typename... Args>
@@ -126,6 +147,22 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether the initial sync may run CustomPrepare for upcoming blocks on worker threads (see
+    /// SetSyncWorkers), and append them with CustomAppendPrepared instead of CustomAppend.
+    virtual bool AllowParallelSync() const { return false; }
+
+    /// Compute the parts of the index entries of a block that do not depend on earlier blocks. This may run on
+    /// several threads at once, so it must not access mutable index state.
+    [[nodiscard]] virtual std::any CustomPrepare(const interfaces::BlockInfo& block) const { return {}; }
+
+    /// Write index entries for a block from the result of CustomPrepare. Blocks are appended in chain order,
+    /// and block.data and block.undo_data are not set.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any prepared) { return false; }
+
+    /// Write index entries that CustomAppendPrepared buffered in memory to be written in larger batches. Called
+    /// before committing and before rewinding.
+    [[nodiscard]] virtual bool CustomFlush() { return true; }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -162,6 +199,10 @@ public:
     /// validation interface so that it stays in sync with blockchain updates.
     [[nodiscard]] bool Init();
 
+    /// Set the number of threads preparing the entries of upcoming blocks during the initial sync, if the index
+    /// allows it. Must be called before StartBackgroundSync.
+    void SetSyncWorkers(int workers) { m_sync_workers = workers; }
+
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
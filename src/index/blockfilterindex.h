@@ -13,6 +13,7 @@
 #include <uint256.h>
 #include <util/hasher.h>
 
+#include <any>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -60,6 +61,9 @@ private:
 
     bool Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header);
 
+    /** Chain the filter of the next block to the last header and write it. */
+    bool AppendFilter(const BlockFilter& filter, uint32_t block_height);
+
     std::optional<uint256> ReadFilterHeader(int height, const uint256& expected_block_hash);
 
 protected:
@@ -69,6 +73,12 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool AllowParallelSync() const override { return true; }
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any prepared) override;
+
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
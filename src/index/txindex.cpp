@@ -21,11 +21,13 @@
 #include <streams.h>
 #include <sync.h>
 #include <uint256.h>
+#include <util/check.h>
 #include <util/fs.h>
 #include <util/log.h>
 #include <validation.h>
 
 #include <algorithm>
+#include <any>
 #include <array>
 #include <cassert>
 #include <cstdint>
@@ -35,6 +37,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -51,6 +54,21 @@ SipHasher13UJ ReadOrCreateTxidHasher(CDBWrapper& db)
     }
     return SipHasher13UJ{salt.first, salt.second};
 }
+
+/** Key prefixes and offsets of the transactions of a block. */
+using BlockTxs = std::vector<std::pair<txindex::TxHashKeyPrefix, uint32_t>>;
+
+BlockTxs ComputeBlockTxs(const SipHasher13UJ& hasher, const CBlock& block)
+{
+    BlockTxs txs;
+    txs.reserve(block.vtx.size());
+    uint32_t tx_offset_in_block{txindex::BLOCK_HEADER_SIZE + GetSizeOfCompactSize(block.vtx.size())};
+    for (const auto& tx : block.vtx) {
+        txs.emplace_back(txindex::CreateKeyPrefix(hasher, tx->GetHash()), tx_offset_in_block);
+        tx_offset_in_block += tx->ComputeTotalSize();
+    }
+    return txs;
+}
 } // namespace
 
 /** Access to the txindex database (indexes/txindex/) */
@@ -59,8 +77,13 @@ class TxIndex::DB : public BaseIndex::DB
 public:
     explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
 
-    /// Write a block of transaction positions to the DB.
-    void WriteTxs(const interfaces::BlockInfo& block);
+    /// Buffer the transaction positions of a block, assigning it the next sequence number.
+    void AppendTxs(const uint256& block_hash, const BlockTxs& txs);
+
+    /// Write the buffered transaction positions to the DB in one batch, in key order.
+    void WritePending();
+
+    size_t PendingSize() const { return m_pending_keys.size(); }
 
     /// Used to hash the txid to compute the prefix.
     const SipHasher13UJ m_hasher;
@@ -73,6 +96,11 @@ public:
 
 private:
     DB(size_t n_cache_size, bool f_memory, bool f_wipe, bool has_legacy);
+
+    std::vector<txindex::DBKey> m_pending_keys;
+    std::vector<std::pair<uint32_t, uint256>> m_pending_blocks;
+    /// Sequence number of the next block, while blocks are buffered.
+    std::optional<uint32_t> m_next_block_seq;
 };
 
 static fs::path TxIndexDBPath() { return gArgs.GetDataDirNet() / "indexes" / "txindex"; }
@@ -108,28 +136,48 @@ void TxIndex::DB::WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator)
     batch.Write(txindex::DB_BEST_BLOCK_V2, locator);
 }
 
-void TxIndex::DB::WriteTxs(const interfaces::BlockInfo& block)
+void TxIndex::DB::AppendTxs(const uint256& block_hash, const BlockTxs& txs)
 {
     // A block may be submitted again after it was already indexed, e.g. when it
     // reconnects after a reorg or is re-processed after an unclean shutdown. It
     // keeps its original sequence number, so skip it to avoid duplicate entries.
-    if (Exists(txindex::BlockHashKey{block.hash})) return;
+    // Buffered blocks are written before any rewind, so checking the DB suffices.
+    if (Exists(txindex::BlockHashKey{block_hash})) return;
+
+    if (!m_next_block_seq) {
+        m_next_block_seq = 0;
+        Read(txindex::DB_NEXT_BLOCK_SEQ, *m_next_block_seq);
+    }
+    const uint32_t block_seq{(*m_next_block_seq)++};
+    m_pending_blocks.emplace_back(block_seq, block_hash);
+    for (const auto& [prefix, tx_offset_in_block] : txs) {
+        m_pending_keys.push_back({prefix, txindex::BlockTxPosition{block_seq, tx_offset_in_block}});
+    }
+}
 
-    uint32_t block_seq{0};
-    Read(txindex::DB_NEXT_BLOCK_SEQ, block_seq);
+void TxIndex::DB::WritePending()
+{
+    if (m_pending_blocks.empty()) return;
 
+    // Keys of consecutive blocks are spread over the whole key space, so sorting
+    // them makes for sequential inserts into the memtable.
+    std::ranges::sort(m_pending_keys, {}, [](const txindex::DBKey& key) {
+        return std::tuple{key.hash_prefix, key.pos.block_seq, key.pos.tx_offset_in_block};
+    });
     CDBBatch batch(*this);
-    batch.Write(txindex::BlockHashKey{block.hash}, block_seq);
-    batch.Write(txindex::BlockSeqKey{block_seq}, block.hash);
-    batch.Write(txindex::DB_NEXT_BLOCK_SEQ, block_seq + 1);
-    uint32_t tx_offset_in_block{txindex::BLOCK_HEADER_SIZE + GetSizeOfCompactSize(block.data->vtx.size())};
-    for (const auto& tx : block.data->vtx) {
-        const txindex::DBKey key{txindex::CreateKeyPrefix(m_hasher, tx->GetHash()),
-                                 txindex::BlockTxPosition{block_seq, tx_offset_in_block}};
+    for (const auto& [block_seq, block_hash] : m_pending_blocks) {
+        batch.Write(txindex::BlockHashKey{block_hash}, block_seq);
+        batch.Write(txindex::BlockSeqKey{block_seq}, block_hash);
+    }
+    batch.Write(txindex::DB_NEXT_BLOCK_SEQ, *m_next_block_seq);
+    for (const auto& key : m_pending_keys) {
         batch.Write(key, txindex::EMPTY_VALUE);
-        tx_offset_in_block += tx->ComputeTotalSize();
     }
     WriteBatch(batch);
+
+    m_pending_keys.clear();
+    m_pending_blocks.clear();
+    m_next_block_seq.reset();
 }
 
 TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
@@ -150,7 +198,29 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
     if (block.height == 0) return true;
 
     assert(block.data);
-    m_db->WriteTxs(block);
+    m_db->AppendTxs(block.hash, ComputeBlockTxs(m_db->m_hasher, *block.data));
+    m_db->WritePending();
+    return true;
+}
+
+std::any TxIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    return ComputeBlockTxs(m_db->m_hasher, *Assert(block.data));
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any prepared)
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return true;
+
+    m_db->AppendTxs(block.hash, std::any_cast<const BlockTxs&>(prepared));
+    if (m_db->PendingSize() >= SYNC_WRITE_BATCH_ENTRIES) m_db->WritePending();
+    return true;
+}
+
+bool TxIndex::CustomFlush()
+{
+    m_db->WritePending();
     return true;
 }
 
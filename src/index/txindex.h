@@ -9,6 +9,7 @@
 #include <primitives/transaction.h>
 #include <uint256.h>
 
+#include <any>
 #include <cstddef>
 #include <memory>
 #include <optional>
@@ -50,6 +51,14 @@ private:
 protected:
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool AllowParallelSync() const override { return true; }
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any prepared) override;
+
+    bool CustomFlush() override;
+
     BaseIndex::DB& GetDB() const override;
 
 public:
@@ -5,6 +5,7 @@
 #include <index/txospenderindex.h>
 
 #include <common/args.h>
+#include <compat/byteswap.h>
 #include <crypto/siphash.h>
 #include <dbwrapper.h>
 #include <flatfile.h>
@@ -23,12 +24,15 @@
 #include <util/fs.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <any>
 #include <cstddef>
 #include <cstdio>
 #include <exception>
 #include <ios>
 #include <span>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -135,6 +139,46 @@ bool TxoSpenderIndex::CustomAppend(const interfaces::BlockInfo& block)
     return true;
 }
 
+std::any TxoSpenderIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    std::vector<std::pair<uint64_t, CDiskTxPos>> keys;
+    for (const auto& [outpoint, pos] : BuildSpenderPositions(block)) {
+        keys.emplace_back(CreateKeyPrefix(m_siphash_key, outpoint), pos);
+    }
+    return keys;
+}
+
+bool TxoSpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any prepared)
+{
+    const auto& keys{std::any_cast<const std::vector<std::pair<uint64_t, CDiskTxPos>>&>(prepared)};
+    m_pending.insert(m_pending.end(), keys.begin(), keys.end());
+    if (m_pending.size() >= SYNC_WRITE_BATCH_ENTRIES) WritePending();
+    return true;
+}
+
+bool TxoSpenderIndex::CustomFlush()
+{
+    WritePending();
+    return true;
+}
+
+void TxoSpenderIndex::WritePending()
+{
+    if (m_pending.empty()) return;
+
+    // Sort by serialized key, so that the spread out keys are inserted sequentially. The hash is serialized
+    // little-endian.
+    std::ranges::sort(m_pending, {}, [](const std::pair<uint64_t, CDiskTxPos>& key) {
+        return std::tuple{internal_bswap_64(key.first), key.second.nFile, key.second.nPos, key.second.nTxOffset};
+    });
+    CDBBatch batch(*m_db);
+    for (const auto& [prefix, pos] : m_pending) {
+        batch.Write(DBKey(prefix, pos), std::span<const std::byte>{});
+    }
+    m_db->WriteBatch(batch);
+    m_pending.clear();
+}
+
 bool TxoSpenderIndex::CustomRemove(const interfaces::BlockInfo& block)
 {
     EraseSpenderInfos(BuildSpenderPositions(block));
@@ -6,11 +6,13 @@
 #define BITCOIN_INDEX_TXOSPENDERINDEX_H
 
 #include <index/base.h>
+#include <index/disktxpos.h>
 #include <interfaces/chain.h>
 #include <primitives/transaction.h>
 #include <uint256.h>
 #include <util/expected.h>
 
+#include <any>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -19,8 +21,6 @@
 #include <utility>
 #include <vector>
 
-struct CDiskTxPos;
-
 inline constexpr bool DEFAULT_TXOSPENDERINDEX{false};
 
 struct TxoSpender {
@@ -41,6 +41,10 @@ private:
     bool AllowPrune() const override { return false; }
     void WriteSpenderInfos(const std::vector<std::pair<COutPoint, CDiskTxPos>>& items);
     void EraseSpenderInfos(const std::vector<std::pair<COutPoint, CDiskTxPos>>& items);
+
+    /// Key prefixes and spender positions buffered during the initial sync, to be written in larger batches.
+    std::vector<std::pair<uint64_t, CDiskTxPos>> m_pending;
+    void WritePending();
     util::Expected<TxoSpender, std::string> ReadTransaction(const CDiskTxPos& pos) const;
 
 protected:
@@ -48,6 +52,14 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool AllowParallelSync() const override { return true; }
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any prepared) override;
+
+    bool CustomFlush() override;
+
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
     BaseIndex::DB& GetDB() const override;
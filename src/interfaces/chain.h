@@ -20,6 +20,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -308,6 +309,10 @@ public:
     public:
         virtual ~Notifications() = default;
         virtual void transactionAddedToMempool(const CTransactionRef& tx) {}
+        virtual void transactionsAddedToMempool(std::span<const CTransactionRef> txs)
+        {
+            for (const auto& tx : txs) transactionAddedToMempool(tx);
+        }
         virtual void transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason) {}
         virtual void blockConnected(const kernel::ChainstateRole& role, const BlockInfo& block) {}
         virtual void blockDisconnected(const BlockInfo& block) {}
@@ -326,11 +331,11 @@ public:
         bool disconnect_undo_data = false;
     };
 
-    //! Register handler for notifications.
+    //! Register handler for notifications, which are delivered on a thread of its own, named name.
     //! Some notifications are asynchronous and may still execute after the handler is disconnected.
     //! Use waitForNotifications() after the handler is disconnected to ensure all pending notifications
     //! have been processed.
-    virtual std::unique_ptr<Handler> handleNotifications(std::shared_ptr<Notifications> notifications) = 0;
+    virtual std::unique_ptr<Handler> handleNotifications(std::shared_ptr<Notifications> notifications, std::string name) = 0;
 
     //! Wait for pending notifications to be processed unless block hash points to the current
     //! chain tip.
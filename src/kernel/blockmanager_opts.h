@@ -16,6 +16,9 @@ class CChainParams;
 namespace kernel {
 
 inline constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+inline constexpr bool DEFAULT_BLOCKS_MMAP{true};
+//! Maximum number of threads used to load the block index at startup
+inline constexpr int32_t MAX_BLOCK_INDEX_LOAD_THREADS{15};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -24,11 +27,15 @@ inline constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
 struct BlockManagerOpts {
     const CChainParams& chainparams;
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
+    //! Read finalized block files through a memory map. I/O errors then raise SIGBUS instead of failing the read.
+    bool use_mmap{DEFAULT_BLOCKS_MMAP};
     uint64_t prune_target{0};
     bool fast_prune{false};
     const fs::path blocks_dir;
     Notifications& notifications;
     DBParams block_tree_db_params;
+    //! Number of additional threads reading and checking block index entries at startup (0 to load on the caller's thread)
+    int32_t block_index_load_threads{0};
 };
 
 } // namespace kernel
@@ -6,6 +6,7 @@
 
 #include <chain.h>
 #include <coins.h>
+#include <crypto/common.h>
 #include <crypto/muhash.h>
 #include <hash.h>
 #include <node/blockstorage.h>
@@ -16,15 +17,21 @@
 #include <sync.h>
 #include <txdb.h>
 #include <uint256.h>
+#include <util/byte_units.h>
 #include <util/check.h>
 #include <util/log.h>
 #include <util/overflow.h>
+#include <util/threadpool.h>
+#include <util/time.h>
 #include <validation.h>
 
+#include <condition_variable>
 #include <cstddef>
+#include <exception>
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
@@ -51,7 +58,7 @@ static void TxOutSer(T& ss, const COutPoint& outpoint, const Coin& coin)
     ss << coin.out;
 }
 
-static void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
 {
     TxOutSer(ss, outpoint, coin);
 }
@@ -107,44 +114,291 @@ static void ApplyStats(CCoinsStats& stats, const std::map<uint32_t, Coin>& outpu
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
+/**
+ * Feeds the serialized coins of the partitions of the UTXO set into one HashWriter in key order while the partitions
+ * are scanned in parallel. The partition whose turn it is writes straight into the hasher. The others buffer their
+ * coins until MAX_BUFFERED_BYTES are buffered in total, and then wait until that drops or their turn comes.
+ */
+class OrderedHashWriter
+{
+public:
+    //! The coins of one partition, written by the thread scanning it.
+    class Partition
+    {
+        OrderedHashWriter* m_writer{nullptr};
+        size_t m_index{0};
+        //! Set once it is this partition's turn; the coins then go straight into the hasher.
+        bool m_streaming{false};
+        DataStream m_buffer{};
+        //! How much of m_buffer is included in m_writer->m_buffered.
+        size_t m_accounted{0};
+
+        void Account();
+
+        friend class OrderedHashWriter;
+
+    public:
+        void write(std::span<const std::byte> src)
+        {
+            if (m_streaming) return m_writer->m_hasher.write(src);
+            m_buffer.write(src);
+            if (m_buffer.size() - m_accounted >= ACCOUNT_BYTES) Account();
+        }
+
+        template <typename T>
+        Partition& operator<<(const T& obj)
+        {
+            ::Serialize(*this, obj);
+            return *this;
+        }
+    };
+
+    OrderedHashWriter(HashWriter& hasher, size_t partitions) : m_hasher{hasher}, m_partitions(partitions)
+    {
+        for (size_t i{0}; i < partitions; ++i) {
+            m_partitions[i].m_writer = this;
+            m_partitions[i].m_index = i;
+        }
+    }
+
+    /**
+     * Run scan on the given partition. If the scan fails, the partitions waiting for their turn are woken up and fail
+     * too, with the same exception if there is one.
+     */
+    template <typename F>
+    bool Scan(size_t partition, F&& scan) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        try {
+            if (scan(m_partitions[partition])) return true;
+            Abort(nullptr);
+            return false;
+        } catch (const Aborted&) {
+            if (const auto error{WITH_LOCK(m_mutex, return m_error)}) std::rethrow_exception(error);
+            return false;
+        } catch (...) {
+            Abort(std::current_exception());
+            throw;
+        }
+    }
+
+    //! Hash what is left of a scanned partition, and hand the turn to the next one. Called for the partitions in order.
+    void Merge(size_t partition) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Partition& part{m_partitions[partition]};
+        if (!part.m_streaming) m_hasher.write(part.m_buffer);
+        LOCK(m_mutex);
+        m_buffered -= part.m_accounted;
+        m_next = partition + 1;
+        m_cond.notify_all();
+        part = Partition{};
+    }
+
+private:
+    //! Thrown in the partitions waiting for their turn when another one failed.
+    struct Aborted {
+    };
+
+    static constexpr size_t MAX_BUFFERED_BYTES{256_MiB};
+    //! How much a partition buffers between updates of m_buffered.
+    static constexpr size_t ACCOUNT_BYTES{size_t{64} << 10};
+
+    HashWriter& m_hasher;
+    std::vector<Partition> m_partitions;
+    Mutex m_mutex;
+    std::condition_variable m_cond;
+    //! The partition whose turn it is.
+    size_t m_next GUARDED_BY(m_mutex){0};
+    size_t m_buffered GUARDED_BY(m_mutex){0};
+    bool m_aborted GUARDED_BY(m_mutex){false};
+    std::exception_ptr m_error GUARDED_BY(m_mutex);
+
+    void Abort(std::exception_ptr error) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        if (!m_aborted) m_error = std::move(error);
+        m_aborted = true;
+        m_cond.notify_all();
+    }
+};
+
+void OrderedHashWriter::Partition::Account()
+{
+    OrderedHashWriter& writer{*m_writer};
+    WAIT_LOCK(writer.m_mutex, lock);
+    writer.m_buffered += m_buffer.size() - m_accounted;
+    m_accounted = m_buffer.size();
+    writer.m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(writer.m_mutex) {
+        return writer.m_aborted || writer.m_next == m_index || writer.m_buffered < MAX_BUFFERED_BYTES;
+    });
+    if (writer.m_aborted) throw Aborted{};
+    if (writer.m_next != m_index) return;
+
+    // It is this partition's turn: hash what it buffered, and stream the rest.
+    writer.m_buffered -= m_accounted;
+    writer.m_cond.notify_all();
+    m_accounted = 0;
+    m_streaming = true;
+    REVERSE_LOCK(lock, writer.m_mutex);
+    writer.m_hasher.write(m_buffer);
+    m_buffer = DataStream{};
+}
+
+static void ApplyCoinHash(OrderedHashWriter::Partition& ss, const COutPoint& outpoint, const Coin& coin)
+{
+    TxOutSer(ss, outpoint, coin);
+}
+
+//! Hashes of the partitions of the UTXO set, combined into the hash of the whole set in key order.
 template <typename T>
-static std::optional<CCoinsStats> ComputeUTXOStats(T hash_obj, const CCoinsViewDB& view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+class PartitionedHash;
+
+template <>
+class PartitionedHash<HashWriter> : public OrderedHashWriter
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor;
-    CBlockIndex* pindex;
+public:
+    using OrderedHashWriter::OrderedHashWriter;
+};
+
+template <>
+class PartitionedHash<MuHash3072>
+{
+    MuHash3072& m_muhash;
+    std::vector<MuHash3072> m_partials;
+
+public:
+    PartitionedHash(MuHash3072& muhash, size_t partitions) : m_muhash{muhash}, m_partials(partitions) {}
+
+    template <typename F>
+    bool Scan(size_t partition, F&& scan) { return scan(m_partials[partition]); }
+
+    void Merge(size_t partition)
     {
-        LOCK(::cs_main);
-        pcursor = view.Cursor();
-        pindex = blockman.LookupBlockIndex(pcursor->GetBestBlock());
+        m_muhash *= m_partials[partition];
+        m_partials[partition] = MuHash3072{};
     }
-    CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
+};
+
+template <>
+class PartitionedHash<std::nullptr_t>
+{
+    std::nullptr_t m_null{nullptr};
+
+public:
+    PartitionedHash(std::nullptr_t, size_t) {}
 
+    template <typename F>
+    bool Scan(size_t, F&& scan) { return scan(m_null); }
+
+    void Merge(size_t) {}
+};
+
+//! Logs the progress of a scan of the UTXO set that takes a while.
+class ScanProgressLog
+{
+    static constexpr auto INTERVAL{10s};
+    SteadyClock::time_point m_next_log{SteadyClock::now() + INTERVAL};
+
+public:
+    void Update(double done)
+    {
+        const auto now{SteadyClock::now()};
+        if (now < m_next_log) return;
+        m_next_log = now + INTERVAL;
+        LogInfo("Computing UTXO set statistics: %d%% done", int(done * 100));
+    }
+};
+
+static void MergeStats(CCoinsStats& stats, const CCoinsStats& partial)
+{
+    stats.nTransactions += partial.nTransactions;
+    stats.nTransactionOutputs += partial.nTransactionOutputs;
+    stats.nBogoSize += partial.nBogoSize;
+    stats.coins_count += partial.coins_count;
+    if (stats.total_amount.has_value() && partial.total_amount.has_value()) {
+        stats.total_amount = CheckedAdd(*stats.total_amount, *partial.total_amount);
+    } else {
+        stats.total_amount.reset();
+    }
+}
+
+//! Calculate statistics about the part of the unspent transaction output set covered by pcursor
+template <typename T>
+static bool ComputePartitionStats(T& hash_obj, CCoinsStats& stats, CCoinsViewCursor& cursor, const std::function<void()>& interruption_point, ScanProgressLog* progress = nullptr)
+{
     Txid prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
+    while (cursor.Valid()) {
         if (interruption_point) interruption_point();
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
             if (!outputs.empty() && key.hash != prevkey) {
                 ApplyStats(stats, outputs);
                 ApplyHash(hash_obj, prevkey, outputs);
                 outputs.clear();
+                // The coins are ordered by txid, so its first bytes tell how far the scan is.
+                if (progress) progress->Update(ReadBE16(key.hash.data()) / 65536.0);
             }
             prevkey = key.hash;
             outputs[key.n] = std::move(coin);
             stats.coins_count++;
         } else {
             LogError("%s: unable to read value\n", __func__);
-            return std::nullopt;
+            return false;
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
         ApplyStats(stats, outputs);
         ApplyHash(hash_obj, prevkey, outputs);
     }
+    return true;
+}
+
+//! Calculate statistics about the unspent transaction output set
+template <typename T>
+static std::optional<CCoinsStats> ComputeUTXOStats(T hash_obj, const CCoinsViewDB& view, node::BlockManager& blockman, const std::function<void()>& interruption_point, int scan_threads)
+{
+    // Without worker threads the whole set is a single partition. Otherwise the partitions are scanned on the
+    // workers, and their statistics and hashes are merged in key order, which keeps HASH_SERIALIZED unchanged.
+    const int partitions{scan_threads > 0 ? UTXO_SCAN_PARTITIONS : 1};
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    CBlockIndex* pindex;
+    {
+        LOCK(::cs_main);
+        cursors = view.PartitionedCursors(partitions);
+        pindex = blockman.LookupBlockIndex(cursors.front()->GetBestBlock());
+    }
+    CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
+
+    std::optional<ThreadPool> thread_pool;
+    if (scan_threads > 0) {
+        thread_pool.emplace("utxoscan");
+        thread_pool->Start(scan_threads);
+    }
+
+    ScanProgressLog progress;
+    if (partitions == 1) {
+        if (!ComputePartitionStats(hash_obj, stats, *cursors.front(), interruption_point, &progress)) return std::nullopt;
+    } else {
+        PartitionedHash<T> hashes{hash_obj, size_t(partitions)};
+        std::vector<CCoinsStats> partial_stats(partitions);
+        const bool scanned{ScanPartitions(
+            partitions, thread_pool ? &*thread_pool : nullptr,
+            [&](size_t partition) {
+                return hashes.Scan(partition, [&](auto& partial_hash) {
+                    return ComputePartitionStats(partial_hash, partial_stats[partition], *cursors[partition], interruption_point);
+                });
+            },
+            [&](size_t partition) {
+                MergeStats(stats, partial_stats[partition]);
+                hashes.Merge(partition);
+                cursors[partition].reset();
+                progress.Update(double(partition + 1) / partitions);
+                return true;
+            })};
+        if (!scanned) return std::nullopt;
+    }
 
     FinalizeHash(hash_obj, stats);
 
@@ -152,20 +406,20 @@ static std::optional<CCoinsStats> ComputeUTXOStats(T hash_obj, const CCoinsViewD
     return stats;
 }
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, const CCoinsViewDB& view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, const CCoinsViewDB& view, node::BlockManager& blockman, const std::function<void()>& interruption_point, int scan_threads)
 {
     return [&]() -> std::optional<CCoinsStats> {
         switch (hash_type) {
         case(CoinStatsHashType::HASH_SERIALIZED): {
             HashWriter ss{};
-            return ComputeUTXOStats(ss, view, blockman, interruption_point);
+            return ComputeUTXOStats(ss, view, blockman, interruption_point, scan_threads);
         }
         case(CoinStatsHashType::MUHASH): {
             MuHash3072 muhash;
-            return ComputeUTXOStats(muhash, view, blockman, interruption_point);
+            return ComputeUTXOStats(muhash, view, blockman, interruption_point, scan_threads);
         }
         case(CoinStatsHashType::NONE): {
-            return ComputeUTXOStats(nullptr, view, blockman, interruption_point);
+            return ComputeUTXOStats(nullptr, view, blockman, interruption_point, scan_threads);
         }
         } // no default case, so the compiler can warn about missing cases
         assert(false);
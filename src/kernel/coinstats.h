@@ -17,6 +17,7 @@ class CCoinsViewDB;
 class Coin;
 class COutPoint;
 class CScript;
+class HashWriter;
 class MuHash3072;
 namespace node {
 class BlockManager;
@@ -74,10 +75,16 @@ struct CCoinsStats {
 
 uint64_t GetBogoSize(const CScript& script_pub_key);
 
+//! Add a coin to the HASH_SERIALIZED hash. ComputeUTXOStats adds the coins ordered by outpoint.
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, const CCoinsViewDB& view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+/**
+ * Calculate statistics about the unspent transaction output set in the coins database. With scan_threads > 0, the
+ * set is scanned in partitions on that many worker threads, in which case interruption_point is called from them.
+ */
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, const CCoinsViewDB& view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {}, int scan_threads = 0);
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_COINSTATS_H
@@ -25,6 +25,8 @@ inline constexpr unsigned int DEFAULT_MEMPOOL_EXPIRY_HOURS{336};
 inline constexpr bool DEFAULT_PERSIST_V1_DAT{false};
 /** Default for -acceptnonstdtxn */
 inline constexpr bool DEFAULT_ACCEPT_NON_STD_TXN{false};
+/** Default for -parmempool, whether input scripts of mempool transactions are verified by the script verification threads */
+inline constexpr bool DEFAULT_MEMPOOL_PARALLEL_SCRIPT_CHECKS{false};
 
 namespace kernel {
 /**
@@ -54,6 +56,8 @@ struct MemPoolOptions {
     bool permit_bare_multisig{DEFAULT_PERMIT_BAREMULTISIG};
     bool require_standard{true};
     bool persist_v1_dat{DEFAULT_PERSIST_V1_DAT};
+    /** Dispatch the input script checks of transactions with many inputs to the script verification threads */
+    bool parallel_script_checks{DEFAULT_MEMPOOL_PARALLEL_SCRIPT_CHECKS};
     MemPoolLimits limits{};
 
     ValidationSignals* signals{nullptr};
@@ -2090,12 +2090,12 @@ bool CConnman::InactivityCheck(const CNode& node, NodeClock::time_point now) con
     return false;
 }
 
-Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
+void CConnman::UpdateWaitSockets(SockWaitSet& wait_set, std::span<CNode* const> nodes, bool listening)
 {
-    Sock::EventsPerSock events_per_sock;
-
-    for (const ListenSocket& hListenSocket : vhListenSocket) {
-        events_per_sock.emplace(hListenSocket.sock, Sock::Events{Sock::RecvEvent});
+    if (listening) {
+        for (const ListenSocket& hListenSocket : vhListenSocket) {
+            wait_set.Set(hListenSocket.sock, Sock::RecvEvent);
+        }
     }
 
     for (CNode* pnode : nodes) {
@@ -2109,45 +2109,53 @@ Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
             const auto& [to_send, more, _msg_type] = pnode->m_transport->GetBytesToSend(!pnode->vSendMsg.empty());
             select_send = !to_send.empty() || more;
         }
-        if (!select_recv && !select_send) continue;
 
         LOCK(pnode->m_sock_mutex);
         if (pnode->m_sock) {
             Sock::Event event = (select_send ? Sock::SendEvent : 0) | (select_recv ? Sock::RecvEvent : 0);
-            events_per_sock.emplace(pnode->m_sock, Sock::Events{event});
+            wait_set.Set(pnode->m_sock, event);
         }
     }
-
-    return events_per_sock;
 }
 
-void CConnman::SocketHandler()
+void CConnman::SocketHandler(size_t shard)
 {
     AssertLockNotHeld(m_nodes_mutex);
     AssertLockNotHeld(m_total_bytes_sent_mutex);
 
     Sock::EventsPerSock events_per_sock;
+    const bool listening{shard == 0};
 
     {
         const NodesSnapshot snap{*this, /*shuffle=*/false};
 
+        // Only service the nodes owned by this I/O thread.
+        std::vector<CNode*> nodes;
+        if (m_sock_wait_sets.size() == 1) {
+            nodes = snap.Nodes();
+        } else {
+            for (CNode* pnode : snap.Nodes()) {
+                if (NodeIOShard(*pnode) == shard) nodes.push_back(pnode);
+            }
+        }
+
         const auto timeout = std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS);
 
         // Check for the readiness of the already connected sockets and the
         // listening sockets in one call ("readiness" as in poll(2) or
         // select(2)). If none are ready, wait for a short while and return
         // empty sets.
-        events_per_sock = GenerateWaitSockets(snap.Nodes());
-        if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) {
+        UpdateWaitSockets(m_sock_wait_sets[shard], nodes, listening);
+        if (!m_sock_wait_sets[shard].Wait(timeout, events_per_sock)) {
             m_interrupt_net->sleep_for(timeout);
         }
 
         // Service (send/receive) each of the already connected nodes.
-        SocketHandlerConnected(snap.Nodes(), events_per_sock);
+        SocketHandlerConnected(nodes, events_per_sock);
     }
 
     // Accept new connections from listening sockets.
-    SocketHandlerListening(events_per_sock);
+    if (listening) SocketHandlerListening(events_per_sock);
 }
 
 void CConnman::SocketHandlerConnected(const std::vector<CNode*>& nodes,
@@ -2222,7 +2230,7 @@ void CConnman::SocketHandlerConnected(const std::vector<CNode*>& nodes,
                 }
                 RecordBytesRecv(nBytes);
                 if (notify) {
-                    pnode->MarkReceivedMsgsForProcessing();
+                    if (pnode->MarkReceivedMsgsForProcessing()) m_block_relay_msgs_pending = true;
                     WakeMessageHandler();
                 }
             }
@@ -2274,8 +2282,19 @@ void CConnman::ThreadSocketHandler()
     while (!m_interrupt_net->interrupted()) {
         DisconnectNodes();
         NotifyNumConnectionsChanged();
-        SocketHandler();
+        SocketHandler(/*shard=*/0);
     }
+    m_sock_wait_sets[0].Clear();
+}
+
+void CConnman::ThreadSocketHandlerShard(size_t shard)
+{
+    AssertLockNotHeld(m_total_bytes_sent_mutex);
+
+    while (!m_interrupt_net->interrupted()) {
+        SocketHandler(shard);
+    }
+    m_sock_wait_sets[shard].Clear();
 }
 
 void CConnman::WakeMessageHandler()
@@ -3228,11 +3247,19 @@ void CConnman::ThreadMessageHandler()
             // This prevents attacks in which an attacker exploits having multiple
             // consecutive connections in the m_nodes list.
             const NodesSnapshot snap{*this, /*shuffle=*/true};
+            std::vector<bool> block_relay_processed(snap.Nodes().size());
 
             for (CNode* pnode : snap.Nodes()) {
                 if (pnode->fDisconnect)
                     continue;
 
+                // Block relay messages that arrived in the meantime go ahead of the remaining nodes of this round.
+                if (m_block_relay_msgs_pending.exchange(false)) {
+                    fMoreWork |= ProcessBlockRelayMessages(snap.Nodes(), block_relay_processed);
+                    if (flagInterruptMsgProc)
+                        return;
+                }
+
                 // Receive messages
                 bool fMoreNodeWork{m_msgproc->ProcessMessages(*pnode, flagInterruptMsgProc)};
                 fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
@@ -3244,6 +3271,11 @@ void CConnman::ThreadMessageHandler()
                 if (flagInterruptMsgProc)
                     return;
             }
+
+            // Block relay messages left over are processed in the next round.
+            if (std::ranges::any_of(snap.Nodes(), [](const CNode* pnode) { return pnode->HasBlockRelayMsgsToProcess(); })) {
+                m_block_relay_msgs_pending = true;
+            }
         }
 
         WAIT_LOCK(mutexMsgProc, lock);
@@ -3254,6 +3286,24 @@ void CConnman::ThreadMessageHandler()
     }
 }
 
+bool CConnman::ProcessBlockRelayMessages(std::span<CNode* const> nodes, std::vector<bool>& processed)
+{
+    bool more_work{false};
+    for (size_t i{0}; i < nodes.size(); ++i) {
+        CNode* pnode{nodes[i]};
+        if (processed[i] || pnode->fDisconnect || !pnode->HasBlockRelayMsgsToProcess()) continue;
+        processed[i] = true;
+
+        const bool more_node_work{m_msgproc->ProcessBlockRelayMessage(*pnode, flagInterruptMsgProc)};
+        if (flagInterruptMsgProc) return false;
+        m_msgproc->SendMessages(*pnode);
+        if (flagInterruptMsgProc) return false;
+
+        more_work |= more_node_work && !pnode->fPauseSend;
+    }
+    return more_work;
+}
+
 void CConnman::ThreadI2PAcceptIncoming()
 {
     AssertLockNotHeld(m_nodes_mutex);
@@ -3619,6 +3669,10 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
 
     // Send and receive from sockets, accept connections
     threadSocketHandler = std::thread(&util::TraceThread, "net", [this] { ThreadSocketHandler(); });
+    // Additional threads sharing the socket I/O (and transport encryption) for the connected nodes, if requested.
+    for (size_t shard{1}; shard < m_sock_wait_sets.size(); ++shard) {
+        m_socket_handler_shard_threads.emplace_back(&util::TraceThread, strprintf("net.%02d", shard), [this, shard] { ThreadSocketHandlerShard(shard); });
+    }
 
     if (!gArgs.GetBoolArg("-dnsseed", DEFAULT_DNSSEED))
         LogInfo("DNS seeding disabled\n");
@@ -3727,6 +3781,10 @@ void CConnman::StopThreads()
         threadDNSAddressSeed.join();
     if (threadSocketHandler.joinable())
         threadSocketHandler.join();
+    for (auto& thread : m_socket_handler_shard_threads) {
+        thread.join();
+    }
+    m_socket_handler_shard_threads.clear();
 }
 
 void CConnman::StopNodes()
@@ -4113,21 +4171,38 @@ CNode::CNode(NodeId idIn,
     }
 }
 
-void CNode::MarkReceivedMsgsForProcessing()
+bool IsBlockRelayMsgType(std::string_view msg_type)
+{
+    return msg_type == NetMsgType::CMPCTBLOCK || msg_type == NetMsgType::BLOCKTXN || msg_type == NetMsgType::HEADERS;
+}
+
+bool CNode::MarkReceivedMsgsForProcessing()
 {
     AssertLockNotHeld(m_msg_process_queue_mutex);
 
     size_t nSizeAdded = 0;
-    for (const auto& msg : vRecvMsg) {
+    std::list<CNetMessage> block_relay_msgs;
+    // Before the handshake, messages are processed in the order they were received.
+    const bool prioritize_block_relay{fSuccessfullyConnected};
+    for (auto it{vRecvMsg.begin()}; it != vRecvMsg.end();) {
         // vRecvMsg contains only completed CNetMessage
         // the single possible partially deserialized message are held by TransportDeserializer
-        nSizeAdded += msg.GetMemoryUsage();
+        nSizeAdded += it->GetMemoryUsage();
+        const auto next{std::next(it)};
+        if (prioritize_block_relay && IsBlockRelayMsgType(it->m_type)) {
+            block_relay_msgs.splice(block_relay_msgs.end(), vRecvMsg, it);
+        }
+        it = next;
     }
+    const bool added_block_relay_msgs{!block_relay_msgs.empty()};
 
     LOCK(m_msg_process_queue_mutex);
     m_msg_process_queue.splice(m_msg_process_queue.end(), vRecvMsg);
+    m_block_relay_msgs_to_process += block_relay_msgs.size();
+    m_block_relay_msg_queue.splice(m_block_relay_msg_queue.end(), block_relay_msgs);
     m_msg_process_queue_size += nSizeAdded;
     fPauseRecv = m_msg_process_queue_size > m_recv_flood_size;
+    return added_block_relay_msgs;
 }
 
 std::optional<std::pair<CNetMessage, bool>> CNode::PollMessage()
@@ -4144,6 +4219,20 @@ std::optional<std::pair<CNetMessage, bool>> CNode::PollMessage()
     return std::make_pair(std::move(msgs.front()), !m_msg_process_queue.empty());
 }
 
+std::optional<std::pair<CNetMessage, bool>> CNode::PollBlockRelayMessage()
+{
+    LOCK(m_msg_process_queue_mutex);
+    if (m_block_relay_msg_queue.empty()) return std::nullopt;
+
+    std::list<CNetMessage> msgs;
+    msgs.splice(msgs.begin(), m_block_relay_msg_queue, m_block_relay_msg_queue.begin());
+    --m_block_relay_msgs_to_process;
+    m_msg_process_queue_size -= msgs.front().GetMemoryUsage();
+    fPauseRecv = m_msg_process_queue_size > m_recv_flood_size;
+
+    return std::make_pair(std::move(msgs.front()), !m_block_relay_msg_queue.empty());
+}
+
 bool CConnman::NodeFullyConnected(const CNode* pnode)
 {
     return pnode && pnode->fSuccessfullyConnected && !pnode->fDisconnect;
@@ -33,6 +33,7 @@
 #include <util/sock.h>
 #include <util/threadinterrupt.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -87,6 +88,10 @@ inline const std::string DEFAULT_MAX_UPLOAD_TARGET{"0M"};
 inline constexpr bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
 inline constexpr int64_t DEFAULT_PEER_CONNECT_TIMEOUT = 60;
+/** Default for -netiothreads. */
+inline constexpr int DEFAULT_NET_IO_THREADS{1};
+/** Maximum number of threads doing socket I/O for peers. */
+inline constexpr int MAX_NET_IO_THREADS{16};
 /** Default for -privatebroadcast. */
 inline constexpr bool DEFAULT_PRIVATE_BROADCAST{false};
 /** Number of file descriptors required for message capture **/
@@ -678,6 +683,12 @@ struct CNodeOptions
     bool use_v2transport = false;
 };
 
+/**
+ * Whether a message type is one of the block relay messages (cmpctblock, blocktxn and headers), which the message
+ * handler processes ahead of other traffic.
+ */
+bool IsBlockRelayMsgType(std::string_view msg_type);
+
 /** Information about a peer */
 class CNode
 {
@@ -756,10 +767,18 @@ public:
 
     const ConnectionType m_conn_type;
 
-    /** Move all messages from the received queue to the processing queue. */
-    void MarkReceivedMsgsForProcessing()
+    /**
+     * Move all messages from the received queue to the processing queue. Once the connection completed its
+     * handshake, block relay messages (see IsBlockRelayMsgType()) go to a queue of their own instead, to be
+     * processed ahead of the other messages.
+     * @return whether any messages were added to the block relay queue
+     */
+    bool MarkReceivedMsgsForProcessing()
         EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
 
+    /** Whether the block relay queue of this connection holds messages. */
+    bool HasBlockRelayMsgsToProcess() const { return m_block_relay_msgs_to_process > 0; }
+
     /** Poll the next message from the processing queue of this connection.
      *
      * Returns std::nullopt if the processing queue is empty, or a pair
@@ -768,6 +787,10 @@ public:
     std::optional<std::pair<CNetMessage, bool>> PollMessage()
         EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
 
+    /** Poll the next message from the block relay queue of this connection, like PollMessage(). */
+    std::optional<std::pair<CNetMessage, bool>> PollBlockRelayMessage()
+        EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
+
     /** Account for the total size of a sent message in the per msg type connection stats. */
     void AccountForSentBytes(const std::string& msg_type, size_t sent_bytes)
         EXCLUSIVE_LOCKS_REQUIRED(cs_vSend)
@@ -1008,11 +1031,16 @@ private:
     std::atomic<int> m_greatest_common_version{INIT_PROTO_VERSION};
 
     const size_t m_recv_flood_size;
-    std::list<CNetMessage> vRecvMsg; // Used only by SocketHandler thread
+    std::list<CNetMessage> vRecvMsg; // Used only by the node's SocketHandler thread
 
     Mutex m_msg_process_queue_mutex;
     std::list<CNetMessage> m_msg_process_queue GUARDED_BY(m_msg_process_queue_mutex);
+    //! Block relay messages received after the handshake, processed ahead of m_msg_process_queue.
+    std::list<CNetMessage> m_block_relay_msg_queue GUARDED_BY(m_msg_process_queue_mutex);
+    //! Memory usage of both queues.
     size_t m_msg_process_queue_size GUARDED_BY(m_msg_process_queue_mutex){0};
+    //! Number of messages in m_block_relay_msg_queue, only changed with m_msg_process_queue_mutex held.
+    std::atomic<size_t> m_block_relay_msgs_to_process{0};
 
     // Our address, as reported by the peer
     CService m_addr_local GUARDED_BY(m_addr_local_mutex);
@@ -1064,6 +1092,16 @@ public:
      */
     virtual bool ProcessMessages(CNode& node, std::atomic<bool>& interrupt) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex) = 0;
 
+    /**
+     * Process the next block relay message received from a given node, ahead of its other messages
+     * (see CNode::PollBlockRelayMessage()).
+     *
+     * @param[in]   node            The node which we have received messages from.
+     * @param[in]   interrupt       Interrupt condition for processing threads
+     * @return                      True if there is more work to be done
+     */
+    virtual bool ProcessBlockRelayMessage(CNode& node, std::atomic<bool>& interrupt) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex) = 0;
+
     /**
      * Send queued protocol messages to a given node.
      *
@@ -1113,6 +1151,7 @@ public:
         bool whitelist_forcerelay = DEFAULT_WHITELISTFORCERELAY;
         bool whitelist_relay = DEFAULT_WHITELISTRELAY;
         bool m_capture_messages = false;
+        int m_net_io_threads = DEFAULT_NET_IO_THREADS;
     };
 
     void Init(const Options& connOptions) EXCLUSIVE_LOCKS_REQUIRED(!m_added_nodes_mutex, !m_total_bytes_sent_mutex)
@@ -1133,6 +1172,7 @@ public:
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = std::chrono::seconds{connOptions.m_peer_connect_timeout};
+        m_sock_wait_sets.resize(std::clamp(connOptions.m_net_io_threads, 1, MAX_NET_IO_THREADS));
         {
             LOCK(m_total_bytes_sent_mutex);
             nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
@@ -1473,6 +1513,17 @@ private:
 
     /// \anchor msghand
     void ThreadMessageHandler() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex, !mutexMsgProc);
+
+    /**
+     * Process one block relay message of each node that has some queued, and send their responses, ahead of the
+     * other nodes in the message handler round.
+     * @param[in] nodes Nodes of the round.
+     * @param[in,out] processed Which of the nodes had a block relay message processed in this round already. They
+     *                          are skipped, so that a node gets at most one per round.
+     * @return whether block relay messages that can be processed are left
+     */
+    bool ProcessBlockRelayMessages(std::span<CNode* const> nodes, std::vector<bool>& processed)
+        EXCLUSIVE_LOCKS_REQUIRED(NetEventsInterface::g_msgproc_mutex);
     /// \anchor i2paccept
     void ThreadI2PAcceptIncoming() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex);
     void ThreadPrivateBroadcast() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex, !m_unused_i2p_sessions_mutex);
@@ -1498,16 +1549,26 @@ private:
     bool InactivityCheck(const CNode& node, NodeClock::time_point now) const;
 
     /**
-     * Generate a collection of sockets to check for IO readiness.
-     * @param[in] nodes Select from these nodes' sockets.
-     * @return sockets to check for readiness
+     * Update the events to check for IO readiness on the nodes' sockets in a wait set. Only the sockets whose events
+     * changed since the last update are passed to the kernel.
+     * @param[in,out] wait_set Wait set of the calling I/O thread.
+     * @param[in] nodes Nodes serviced by the calling I/O thread.
+     * @param[in] listening Whether to also wait for connections on the listening sockets.
      */
-    Sock::EventsPerSock GenerateWaitSockets(std::span<CNode* const> nodes);
+    void UpdateWaitSockets(SockWaitSet& wait_set, std::span<CNode* const> nodes, bool listening);
 
     /**
-     * Check connected and listening sockets for IO readiness and process them accordingly.
+     * Index of the socket I/O thread that sends and receives for a node. Nodes are spread over the threads by id,
+     * so each node's socket, buffers and transport are only ever serviced by one of them.
      */
-    void SocketHandler() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex, !m_total_bytes_sent_mutex, !mutexMsgProc);
+    size_t NodeIOShard(const CNode& node) const { return static_cast<uint64_t>(node.GetId()) % m_sock_wait_sets.size(); }
+
+    /**
+     * Check the connected sockets of one I/O shard for IO readiness and process them accordingly. The first shard
+     * also checks and processes the listening sockets.
+     * @param[in] shard Index of the I/O thread calling this.
+     */
+    void SocketHandler(size_t shard = 0) EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex, !m_total_bytes_sent_mutex, !mutexMsgProc);
 
     /**
      * Do the read/write for connected sockets that are ready for IO.
@@ -1527,6 +1588,8 @@ private:
 
     /// \anchor net
     void ThreadSocketHandler() EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc, !m_nodes_mutex, !m_reconnections_mutex);
+    /** Socket I/O for the nodes of one of the additional I/O shards (see -netiothreads). */
+    void ThreadSocketHandlerShard(size_t shard) EXCLUSIVE_LOCKS_REQUIRED(!m_total_bytes_sent_mutex, !mutexMsgProc, !m_nodes_mutex);
     /// \anchor dnsseed
     void ThreadDNSAddressSeed() EXCLUSIVE_LOCKS_REQUIRED(!m_addr_fetches_mutex, !m_nodes_mutex);
 
@@ -1648,6 +1711,11 @@ private:
     unsigned int nReceiveFloodSize{0};
 
     std::vector<ListenSocket> vhListenSocket;
+    /**
+     * Sockets waited on by SocketHandler(), one set per I/O thread. Each set is only accessed from its own thread;
+     * the number of sets is the number of I/O threads and only changes while they are stopped.
+     */
+    std::vector<SockWaitSet> m_sock_wait_sets;
     std::atomic<bool> fNetworkActive{true};
     bool fAddressesInitialized{false};
     std::reference_wrapper<AddrMan> addrman;
@@ -1753,6 +1821,8 @@ private:
 
     /** flag for waking the message processor. */
     bool fMsgProcWake GUARDED_BY(mutexMsgProc);
+    /** Set when block relay messages were queued for processing, for the message handler to process them first. */
+    std::atomic<bool> m_block_relay_msgs_pending{false};
 
     std::condition_variable condMsgProc;
     Mutex mutexMsgProc;
@@ -1773,6 +1843,7 @@ private:
 
     std::thread threadDNSAddressSeed;
     std::thread threadSocketHandler;
+    std::vector<std::thread> m_socket_handler_shard_threads;
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
     std::thread threadMessageHandler;
@@ -61,6 +61,7 @@
 #include <util/strencodings.h>
 #include <util/time.h>
 #include <util/tokenbucket.h>
+#include <util/threadpool.h>
 #include <util/trace.h>
 #include <validation.h>
 
@@ -394,6 +395,11 @@ struct Peer {
     Mutex m_getdata_requests_mutex;
     /** Work queue of items requested by this peer **/
     std::deque<CInv> m_getdata_requests GUARDED_BY(m_getdata_requests_mutex);
+    /** Whether a block requested by this peer is being served on the block serving threads (see -blockservethreads).
+     *  Until it is done, no further messages of this peer are processed, so that responses stay in order. */
+    std::atomic<bool> m_block_serve_in_flight{false};
+    /** Completion of the block being served in the background, if any. */
+    std::future<void> m_block_serve_done GUARDED_BY(m_getdata_requests_mutex);
 
     /** Time of the last getheaders message to this peer */
     NodeClock::time_point m_last_getheaders_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){};
@@ -590,7 +596,9 @@ public:
     void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex, !m_tx_download_mutex);
     bool HasAllDesirableServiceFlags(ServiceFlags services) const override;
     bool ProcessMessages(CNode& node, std::atomic<bool>& interrupt) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex, !m_block_relay_latency_mutex);
+    bool ProcessBlockRelayMessage(CNode& node, std::atomic<bool>& interrupt) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex, !m_block_relay_latency_mutex);
     bool SendMessages(CNode& node) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex);
 
@@ -601,7 +609,7 @@ public:
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     bool GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     std::vector<node::TxOrphanage::OrphanInfo> GetOrphanTransactions() override EXCLUSIVE_LOCKS_REQUIRED(!m_tx_download_mutex);
-    PeerManagerInfo GetInfo() const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_inv_to_send_mutex);
+    PeerManagerInfo GetInfo() const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_inv_to_send_mutex, !m_block_relay_latency_mutex);
     std::vector<PrivateBroadcast::TxBroadcastInfo> GetPrivateBroadcastInfo() const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     std::vector<CTransactionRef> AbortPrivateBroadcast(const uint256& id) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void SendPings() override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
@@ -617,6 +625,14 @@ public:
     ServiceFlags GetDesirableServiceFlags(ServiceFlags services) const override;
 
 private:
+    /**
+     * Process a message polled from one of the queues of a node.
+     * @param[in] more_work Whether more messages are left in the queue
+     * @return True if there is more work to be done
+     */
+    bool ProcessPolledMessage(Peer& peer, CNode& node, CNetMessage& msg, bool more_work, std::atomic<bool>& interruptMsgProc)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex, !m_block_relay_latency_mutex);
+
     void ProcessMessage(Peer& peer, CNode& pfrom, const std::string& msg_type, DataStream& vRecv, NodeClock::time_point time_received,
                         const std::atomic<bool>& interruptMsgProc)
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex);
@@ -1049,7 +1065,7 @@ private:
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, !tx_relay.m_tx_inventory_mutex);
 
     void ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic<bool>& interruptMsgProc)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, peer.m_getdata_requests_mutex, NetEventsInterface::g_msgproc_mutex)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, !m_peer_mutex, peer.m_getdata_requests_mutex, NetEventsInterface::g_msgproc_mutex)
         LOCKS_EXCLUDED(::cs_main);
 
     /** Process a new block. Perform any post-processing housekeeping */
@@ -1112,6 +1128,24 @@ private:
     bool AlreadyHaveBlock(const uint256& block_hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
         EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex);
+    /**
+     * Serve a block request, without touching state guarded by g_msgproc_mutex, so that it can run on
+     * m_block_serve_pool.
+     * @param[in] cmpctblock_nonce Salt of the short ids, if a compact block has to be constructed for the request.
+     */
+    void ServeBlockRequest(CNode& pfrom, Peer& peer, const CInv& inv, uint64_t cmpctblock_nonce)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex);
+
+    /**
+     * Serve a block request on m_block_serve_pool instead of the message handler thread. The peer's messages are
+     * held back until it is done.
+     * @param[in,out] not_found Transactions requested before the block that were not found. The NOTFOUND message
+     *                          for them is sent after the block, like when it is served synchronously, so it is
+     *                          taken over on success.
+     * @return false if the request has to be served synchronously instead
+     */
+    bool ServeBlockInBackground(CNode& pfrom, Peer& peer, const CInv& inv, std::vector<CInv>& not_found)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, !m_peer_mutex, peer.m_getdata_requests_mutex);
 
     /**
      * Validation logic for compact filters request handling.
@@ -1195,6 +1229,14 @@ private:
     std::optional<NodeClock::time_point> m_next_inv_bucket_heartbeat GUARDED_BY(m_inv_to_send_mutex);
 
     void ProcessInvBacklog(NodeClock::time_point now, bool backlog_bumped=false) EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_inv_to_send_mutex);
+
+    mutable Mutex m_block_relay_latency_mutex;
+    /** Latency of the block relay messages processed so far, per message type (see IsBlockRelayMsgType()). */
+    std::map<std::string, BlockRelayLatency> m_block_relay_latency GUARDED_BY(m_block_relay_latency_mutex);
+
+    /** Threads serving historical block requests, if enabled (see -blockservethreads). Declared last, so it is
+     *  stopped, finishing queued requests, before the state they use is destroyed. */
+    ThreadPool m_block_serve_pool{"blockserve"};
 };
 
 const CNodeState* PeerManagerImpl::State(NodeId pnode) const
@@ -1778,6 +1820,12 @@ void PeerManagerImpl::ReattemptPrivateBroadcast(CScheduler& scheduler)
 void PeerManagerImpl::FinalizeNode(const CNode& node)
 {
     NodeId nodeid = node.GetId();
+    if (PeerRef peer{GetPeerRef(nodeid)}) {
+        // The node is about to be deleted; wait for a block of it that is still being served in the background.
+        std::future<void> block_serve_done;
+        WITH_LOCK(peer->m_getdata_requests_mutex, block_serve_done = std::move(peer->m_block_serve_done));
+        if (block_serve_done.valid()) block_serve_done.wait();
+    }
     {
     LOCK(cs_main);
     {
@@ -1971,6 +2019,7 @@ PeerManagerInfo PeerManagerImpl::GetInfo() const
         .tx_send_rate = m_opts.tx_send_rate,
         .inbound_bucket = m_inbound_inv_bucket.info(),
         .outbound_bucket = m_outbound_inv_bucket.info(),
+        .block_relay_latency = WITH_LOCK(m_block_relay_latency_mutex, return m_block_relay_latency),
     };
 }
 
@@ -2148,6 +2197,9 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
+    if (m_opts.block_serve_threads > 0) {
+        m_block_serve_pool.Start(m_opts.block_serve_threads);
+    }
 }
 
 void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
@@ -2558,6 +2610,11 @@ void PeerManagerImpl::RelayAddress(NodeId originator,
 }
 
 void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
+{
+    ServeBlockRequest(pfrom, peer, inv, /*cmpctblock_nonce=*/inv.IsMsgCmpctBlk() ? m_rng.rand64() : 0);
+}
+
+void PeerManagerImpl::ServeBlockRequest(CNode& pfrom, Peer& peer, const CInv& inv, uint64_t cmpctblock_nonce)
 {
     // First perform the stateless checks:
     // A filtered-block can only ever be requested if we offer NODE_BLOOM
@@ -2645,9 +2702,13 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
         pblock = a_recent_block;
     } else if (inv.IsMsgWitnessBlk()) {
         // Fast-path: in this case it is possible to serve the block directly from disk,
-        // as the network format matches the format on disk
-        if (const auto block_data{m_chainman.m_blockman.ReadRawBlock(block_pos)}) {
-            MakeAndPushMessage(pfrom, NetMsgType::BLOCK, std::span{*block_data});
+        // as the network format matches the format on disk,
+        // and the block is read straight into the message buffer.
+        if (auto block_data{m_chainman.m_blockman.ReadRawBlockForNetwork(block_pos)}) {
+            CSerializedNetMsg msg;
+            msg.m_type = NetMsgType::BLOCK;
+            msg.data = std::move(*block_data);
+            PushMessage(pfrom, std::move(msg));
         } else {
             if (WITH_LOCK(m_chainman.GetMutex(), return m_chainman.m_blockman.IsBlockPruned(*pindex))) {
                 LogDebug(BCLog::NET, "Block was pruned before it could be read, %s", pfrom.DisconnectMsg());
@@ -2709,7 +2770,7 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
                 if (a_recent_compact_block && a_recent_compact_block->header.GetHash() == inv.hash) {
                     MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, *a_recent_compact_block);
                 } else {
-                    CBlockHeaderAndShortTxIDs cmpctblock{*pblock, m_rng.rand64()};
+                    CBlockHeaderAndShortTxIDs cmpctblock{*pblock, cmpctblock_nonce};
                     MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, cmpctblock);
                 }
             } else {
@@ -2733,6 +2794,41 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     }
 }
 
+bool PeerManagerImpl::ServeBlockInBackground(CNode& pfrom, Peer& peer, const CInv& inv, std::vector<CInv>& not_found)
+{
+    if (m_opts.block_serve_threads == 0) return false;
+    // Compact blocks draw their short id salt from m_rng, which is only used from the message handler thread. They
+    // are also only served for recent blocks, which are usually cached in memory anyway.
+    if (inv.IsMsgCmpctBlk()) return false;
+    PeerRef peer_ref{GetPeerRef(pfrom.GetId())};
+    if (!peer_ref) return false;
+
+    // Keep the node alive until the block is sent.
+    pfrom.AddRef();
+    peer.m_block_serve_in_flight = true;
+    auto done{m_block_serve_pool.Submit([this, &pfrom, peer_ref, inv, not_found]() EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex) {
+        try {
+            ServeBlockRequest(pfrom, *peer_ref, inv, /*cmpctblock_nonce=*/0);
+            if (!not_found.empty()) MakeAndPushMessage(pfrom, NetMsgType::NOTFOUND, not_found);
+        } catch (const std::exception& e) {
+            LogDebug(BCLog::NET, "Exception '%s' while serving block %s, %s", e.what(), inv.hash.ToString(), pfrom.DisconnectMsg());
+            pfrom.fDisconnect = true;
+        }
+        peer_ref->m_block_serve_in_flight = false;
+        pfrom.Release();
+        // Resume processing the messages of this peer.
+        m_connman.WakeMessageHandler();
+    })};
+    if (!done) {
+        peer.m_block_serve_in_flight = false;
+        pfrom.Release();
+        return false;
+    }
+    peer.m_block_serve_done = std::move(*done);
+    not_found.clear();
+    return true;
+}
+
 CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay, const GenTxid& gtxid)
 {
     // If a tx was in the mempool prior to the last INV for this peer, permit the request.
@@ -2797,7 +2893,7 @@ void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic
     // expensive to process.
     if (it != peer.m_getdata_requests.end() && !pfrom.fPauseSend) {
         const CInv &inv = *it++;
-        if (inv.IsGenBlkMsg()) {
+        if (inv.IsGenBlkMsg() && !ServeBlockInBackground(pfrom, peer, inv, vNotFound)) {
             ProcessGetBlockData(pfrom, peer, inv);
         }
         // else: If the first item on the queue is an unknown type, we erase it
@@ -5413,6 +5509,9 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
     // has been sent first before processing any incoming messages
     if (!node.IsInboundConn() && !peer.m_outbound_version_message_sent) return false;
 
+    // Hold back the messages of this peer while a block it requested is being served in the background.
+    if (peer.m_block_serve_in_flight) return false;
+
     {
         LOCK(peer.m_getdata_requests_mutex);
         if (!peer.m_getdata_requests.empty()) {
@@ -5443,8 +5542,30 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
         return false;
     }
 
-    CNetMessage& msg{poll_result->first};
-    bool fMoreWork = poll_result->second;
+    return ProcessPolledMessage(peer, node, poll_result->first, /*more_work=*/poll_result->second, interruptMsgProc);
+}
+
+bool PeerManagerImpl::ProcessBlockRelayMessage(CNode& node, std::atomic<bool>& interruptMsgProc)
+{
+    AssertLockNotHeld(m_tx_download_mutex);
+    AssertLockHeld(g_msgproc_mutex);
+
+    PeerRef maybe_peer{GetPeerRef(node.GetId())};
+    if (maybe_peer == nullptr) return false;
+    Peer& peer{*maybe_peer};
+
+    // Same as for the other messages of the peer.
+    if (peer.m_block_serve_in_flight || node.fDisconnect || node.fPauseSend) return false;
+
+    auto poll_result{node.PollBlockRelayMessage()};
+    if (!poll_result) return false;
+
+    return ProcessPolledMessage(peer, node, poll_result->first, /*more_work=*/poll_result->second, interruptMsgProc);
+}
+
+bool PeerManagerImpl::ProcessPolledMessage(Peer& peer, CNode& node, CNetMessage& msg, bool more_work, std::atomic<bool>& interruptMsgProc)
+{
+    bool fMoreWork = more_work;
 
     TRACEPOINT(net, inbound_message,
         node.GetId(),
@@ -5461,6 +5582,11 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
 
     try {
         ProcessMessage(peer, node, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        if (IsBlockRelayMsgType(msg.m_type)) {
+            const auto latency{std::max(NodeClock::now() - msg.m_time, NodeClock::duration::zero())};
+            LOCK(m_block_relay_latency_mutex);
+            m_block_relay_latency[msg.m_type].Add(std::chrono::duration_cast<std::chrono::microseconds>(latency));
+        }
         if (interruptMsgProc) return false;
         {
             LOCK(peer.m_getdata_requests_mutex);
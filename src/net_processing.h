@@ -16,9 +16,12 @@
 #include <util/expected.h>
 #include <validationinterface.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -44,6 +47,10 @@ inline constexpr bool DEFAULT_TXRECONCILIATION_ENABLE{false};
 inline constexpr uint32_t DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN{100};
 /** Default maximum per-second rate for sending transaction inventory to peers. */
 inline constexpr unsigned int DEFAULT_TX_SEND_RATE{14};
+/** Default number of threads serving block requests of peers besides the message handler thread. */
+inline constexpr int DEFAULT_BLOCK_SERVE_THREADS{0};
+/** Maximum number of threads serving block requests of peers. */
+inline constexpr int MAX_BLOCK_SERVE_THREADS{16};
 inline constexpr bool DEFAULT_PEERBLOOMFILTERS = false;
 inline constexpr bool DEFAULT_PEERBLOCKFILTERS = false;
 /** Maximum number of outstanding CMPCTBLOCK requests for the same block. */
@@ -71,6 +78,21 @@ struct CNodeStateStats {
     std::chrono::seconds time_offset{0};
 };
 
+/** Histogram of the latency of block relay messages, from their receipt until the end of their processing. */
+struct BlockRelayLatency {
+    /** Upper bounds of the buckets. The last bucket counts the latencies above the last bound. */
+    static constexpr std::array<std::chrono::microseconds, 10> BUCKET_LIMITS{1ms, 2ms, 5ms, 10ms, 20ms, 50ms, 100ms, 200ms, 500ms, 1000ms};
+
+    uint64_t count{0};
+    std::array<uint64_t, BUCKET_LIMITS.size() + 1> buckets{};
+
+    void Add(std::chrono::microseconds latency)
+    {
+        ++count;
+        ++buckets[std::ranges::lower_bound(BUCKET_LIMITS, latency) - BUCKET_LIMITS.begin()];
+    }
+};
+
 struct PeerManagerInfo {
     struct InvBucketInfo {
         size_t backlog_count{0};
@@ -84,6 +106,8 @@ struct PeerManagerInfo {
     unsigned int tx_send_rate{0};
     InvBucketInfo inbound_bucket;
     InvBucketInfo outbound_bucket;
+    /** Block relay message latency per message type, for the types received so far. */
+    std::map<std::string, BlockRelayLatency> block_relay_latency;
 };
 
 class PeerManager : public CValidationInterface, public NetEventsInterface
@@ -109,6 +133,9 @@ public:
         bool private_broadcast{DEFAULT_PRIVATE_BROADCAST};
         //! Maximum per-second rate for sending transaction inventory to peers.
         unsigned int tx_send_rate{DEFAULT_TX_SEND_RATE};
+        //! Number of threads serving block requests of peers, off the message handler thread. 0 serves them on
+        //! the message handler thread.
+        int block_serve_threads{DEFAULT_BLOCK_SERVE_THREADS};
     };
 
     static std::unique_ptr<PeerManager> make(CConnman& connman, AddrMan& addrman,
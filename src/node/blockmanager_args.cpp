@@ -5,6 +5,8 @@
 #include <node/blockmanager_args.h>
 
 #include <common/args.h>
+#include <common/system.h>
+#include <kernel/blockmanager_opts.h>
 #include <node/blockstorage.h>
 #include <node/database_args.h>
 #include <tinyformat.h>
@@ -13,12 +15,14 @@
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstdint>
 
 namespace node {
 util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Options& opts)
 {
     if (auto value{args.GetBoolArg("-blocksxor")}) opts.use_xor = *value;
+    if (auto value{args.GetBoolArg("-blocksmmap")}) opts.use_mmap = *value;
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg{args.GetIntArg("-prune", opts.prune_target)};
     if (nPruneArg < 0) {
@@ -38,6 +42,8 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
 
     ReadDatabaseArgs(args, opts.block_tree_db_params.options);
 
+    opts.block_index_load_threads = std::clamp(GetNumCores() - 1, 0, kernel::MAX_BLOCK_INDEX_LOAD_THREADS);
+
     return {};
 }
 } // namespace node
@@ -30,22 +30,32 @@
 #include <util/check.h>
 #include <util/expected.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
 #include <util/log.h>
+#include <util/mappedfile.h>
 #include <util/obfuscation.h>
 #include <util/overflow.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <compare>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
+#include <deque>
 #include <exception>
+#include <future>
+#include <ios>
+#include <limits>
 #include <map>
 #include <optional>
 #include <ostream>
@@ -84,6 +94,34 @@ void BlockTreeDB::ReadReindexing(bool& fReindexing)
     fReindexing = Exists(DB_REINDEX_FLAG);
 }
 
+namespace {
+/**
+ * Value stored under DB_LAST_BLOCK: the last block file number, optionally followed by the token of the block index
+ * snapshot that matches the database. Versions that do not know about the snapshot read the file number and ignore
+ * the token. They write the file number alone with every block index change, which drops the token, so a snapshot
+ * is never trusted after a downgrade that touched the block index.
+ */
+struct LastBlockFileValue {
+    int file{0};
+    std::optional<uint64_t> snapshot_token;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << file;
+        if (snapshot_token) s << *snapshot_token;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> file;
+        snapshot_token.reset();
+        if (!s.empty()) snapshot_token.emplace(ser_readdata64(s));
+    }
+};
+} // namespace
+
 bool BlockTreeDB::ReadLastBlockFile(int& nFile)
 {
     return Read(DB_LAST_BLOCK, nFile);
@@ -95,7 +133,8 @@ void BlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFi
     for (const auto& [file, info] : fileInfo) {
         batch.Write(std::make_pair(DB_BLOCK_FILES, file), *info);
     }
-    batch.Write(DB_LAST_BLOCK, nLastFile);
+    // Written without a snapshot token, which invalidates any block index snapshot.
+    batch.Write(DB_LAST_BLOCK, LastBlockFileValue{.file = nLastFile, .snapshot_token = std::nullopt});
     for (const CBlockIndex* bi : blockinfo) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, bi->GetBlockHash()), CDiskBlockIndex{bi});
     }
@@ -117,21 +156,115 @@ bool BlockTreeDB::ReadFlag(const std::string& name, bool& fValue)
     return true;
 }
 
-bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
+void BlockTreeDB::WriteBlockIndexSnapshotToken(int last_file, uint64_t token)
+{
+    Write(DB_LAST_BLOCK, LastBlockFileValue{.file = last_file, .snapshot_token = token}, /*fSync=*/true);
+}
+
+std::optional<uint64_t> BlockTreeDB::ReadBlockIndexSnapshotToken()
+{
+    LastBlockFileValue value;
+    if (!Read(DB_LAST_BLOCK, value)) return std::nullopt;
+    return value.snapshot_token;
+}
+
+namespace {
+//! Serialized CDiskBlockIndex, which ends with the block header.
+struct RawBlockIndexEntry {
+    static constexpr size_t BLOCK_HEADER_SIZE{80};
+    std::vector<std::byte> data;
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        data.resize(s.size());
+        s.read(data);
+    }
+};
+} // namespace
+
+bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt, ThreadPool* thread_pool)
 {
     AssertLockHeld(::cs_main);
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
-
-    // Load m_block_index
-    while (pcursor->Valid()) {
-        if (interrupt) return false;
-        std::pair<uint8_t, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
-            CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
+
+    // Block index entries are keyed by block hash, so they are spread evenly over partitions by the first byte of the
+    // hash. Partitions are read, hashed and checked on the thread pool (if any), while this thread deserializes the
+    // entries of finished partitions and inserts them into the block index in order. Deserializing a CDiskBlockIndex
+    // takes cs_main, which this thread holds, so the workers only look at the block header that each entry ends with.
+    constexpr int PARTITIONS{64};
+    using Partition = std::vector<std::pair<uint256, RawBlockIndexEntry>>;
+    std::atomic<bool> failed{false};
+
+    const auto read_partition{[&](int partition) -> Partition {
+        const int begin{partition * 256 / PARTITIONS};
+        const int end{(partition + 1) * 256 / PARTITIONS};
+        Partition entries;
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        uint256 start;
+        start.data()[0] = begin;
+        pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, start));
+        while (pcursor->Valid()) {
+            if (interrupt || failed) break;
+            std::pair<uint8_t, uint256> key;
+            if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX || key.second.data()[0] >= end) break;
+            RawBlockIndexEntry entry;
+            if (!pcursor->GetValue(entry) || entry.data.size() < RawBlockIndexEntry::BLOCK_HEADER_SIZE) {
+                LogError("LoadBlockIndexGuts: failed to read value\n");
+                failed = true;
+                break;
+            }
+            CBlockHeader header;
+            SpanReader{std::span{entry.data}.last(RawBlockIndexEntry::BLOCK_HEADER_SIZE)} >> header;
+            const uint256 hash{header.GetHash()};
+            if (!CheckProofOfWork(hash, header.nBits, consensusParams)) {
+                LogError("LoadBlockIndexGuts: CheckProofOfWork failed: block %s\n", hash.ToString());
+                failed = true;
+                break;
+            }
+            entries.emplace_back(hash, std::move(entry));
+            pcursor->Next();
+        }
+        return entries;
+    }};
+
+    // Bound the number of partitions read ahead, so that not all of the index is held in memory twice.
+    const size_t max_in_flight{thread_pool ? 2 * thread_pool->WorkersCount() : 0};
+    std::deque<std::future<Partition>> in_flight;
+    int next_partition{0};
+    // Reading a partition or inserting its entries may throw. The partitions in flight are waited for first.
+    std::exception_ptr error;
+    try {
+        while (!failed && !interrupt) {
+            while (next_partition < PARTITIONS && in_flight.size() < max_in_flight) {
+                auto future{thread_pool->Submit([&read_partition, partition = next_partition] { return read_partition(partition); })};
+                if (!future) break;
+                in_flight.push_back(std::move(*future));
+                ++next_partition;
+            }
+            Partition entries;
+            if (!in_flight.empty()) {
+                auto future{std::move(in_flight.front())};
+                in_flight.pop_front();
+                entries = future.get();
+            } else if (next_partition < PARTITIONS) {
+                entries = read_partition(next_partition++);
+            } else {
+                break;
+            }
+            if (failed) break;
+
+            // Load m_block_index
+            for (const auto& [hash, entry] : entries) {
+                CDiskBlockIndex diskindex;
+                try {
+                    SpanReader{entry.data} >> diskindex;
+                } catch (const std::exception&) {
+                    LogError("LoadBlockIndexGuts: failed to read value\n");
+                    failed = true;
+                    break;
+                }
                 // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.ConstructBlockHash());
+                CBlockIndex* pindexNew = insertBlockIndex(hash);
                 pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
                 pindexNew->nHeight        = diskindex.nHeight;
                 pindexNew->nFile          = diskindex.nFile;
@@ -144,23 +277,17 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
                 pindexNew->nNonce         = diskindex.nNonce;
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
-
-                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams)) {
-                    LogError("%s: CheckProofOfWork failed: %s\n", __func__, pindexNew->ToString());
-                    return false;
-                }
-
-                pcursor->Next();
-            } else {
-                LogError("%s: failed to read value\n", __func__);
-                return false;
             }
-        } else {
-            break;
         }
+    } catch (...) {
+        error = std::current_exception();
+        failed = true;
     }
+    // Outstanding tasks refer to this stack frame.
+    for (auto& future : in_flight) future.wait();
+    if (error) std::rethrow_exception(error);
 
-    return true;
+    return !failed && !interrupt;
 }
 
 std::string CBlockFileInfo::ToString() const
@@ -437,13 +564,178 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
     return pindex;
 }
 
-bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
+fs::path BlockManager::BlockIndexSnapshotPath() const
+{
+    return m_opts.block_tree_db_params.path + ".snapshot";
+}
+
+namespace {
+//! Version of the block index snapshot format, to be increased whenever it changes.
+constexpr uint32_t BLOCK_INDEX_SNAPSHOT_VERSION{1};
+//! Serialized size of an entry in the block index snapshot.
+constexpr size_t BLOCK_INDEX_SNAPSHOT_ENTRY_BYTES{2 * uint256::size() + 11 * sizeof(uint32_t)};
+
+/** Formatter for the fields of a block index entry that are stored in the block tree database. */
+struct BlockIndexSnapshotFormatter {
+    FORMATTER_METHODS(CBlockIndex, obj)
+    {
+        READWRITE(obj.nHeight, obj.nStatus, obj.nTx, obj.nFile, obj.nDataPos, obj.nUndoPos,
+                  obj.nVersion, obj.hashMerkleRoot, obj.nTime, obj.nBits, obj.nNonce);
+    }
+};
+} // namespace
+
+bool BlockManager::LoadBlockIndexSnapshot()
 {
-    if (!m_block_tree_db->LoadBlockIndexGuts(
-            GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt)) {
+    AssertLockHeld(cs_main);
+    if (m_opts.block_tree_db_params.memory_only) return false;
+    const auto token{m_block_tree_db->ReadBlockIndexSnapshotToken()};
+    if (!token) return false;
+
+    const fs::path path{BlockIndexSnapshotPath()};
+    const auto mapped{m_opts.use_mmap ? MappedFile::Open(path) : nullptr};
+    std::vector<std::byte> buffer;
+    std::span<const std::byte> data;
+    if (mapped) {
+        data = mapped->Data();
+    } else {
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        if (file.IsNull()) return false;
+        try {
+            buffer.resize(file.size());
+            file.read(buffer);
+        } catch (const std::exception& e) {
+            LogWarning("Failed to read block index snapshot %s: %s", fs::PathToString(path), e.what());
+            return false;
+        }
+        data = buffer;
+    }
+
+    // The snapshot is followed by its hash.
+    if (data.size() < uint256::size() || Hash(data.first(data.size() - uint256::size())) != uint256{UCharSpanCast(data.last(uint256::size()))}) {
+        LogWarning("Block index snapshot %s is corrupted, loading the block index from the database", fs::PathToString(path));
         return false;
     }
 
+    const auto load{[&]() -> bool {
+        SpanReader reader{data.first(data.size() - uint256::size())};
+        MessageStartChars message_start;
+        uint32_t version;
+        uint64_t snapshot_token;
+        int last_file;
+        CBlockFileInfo last_file_info;
+        uint64_t count;
+        reader >> message_start >> version >> snapshot_token >> last_file >> last_file_info >> count;
+        if (message_start != GetParams().MessageStart() || version != BLOCK_INDEX_SNAPSHOT_VERSION || snapshot_token != *token) return false;
+        // The block files must not have changed since the snapshot was written either.
+        int db_last_file{0};
+        CBlockFileInfo db_last_file_info;
+        m_block_tree_db->ReadLastBlockFile(db_last_file);
+        m_block_tree_db->ReadBlockFileInfo(db_last_file, db_last_file_info);
+        if (db_last_file != last_file || db_last_file_info != last_file_info) return false;
+        if (reader.size() % BLOCK_INDEX_SNAPSHOT_ENTRY_BYTES != 0 || reader.size() / BLOCK_INDEX_SNAPSHOT_ENTRY_BYTES != count) return false;
+
+        // Entries are ordered by height, so parents precede their children and are referred to by position.
+        m_block_index.reserve(count);
+        std::vector<CBlockIndex*> entries;
+        entries.reserve(count);
+        for (uint64_t i{0}; i < count; ++i) {
+            if (m_interrupt) return false;
+            uint256 hash;
+            uint32_t prev;
+            reader >> hash >> prev;
+            CBlockIndex* pindex{InsertBlockIndex(hash)};
+            if (!pindex || prev > entries.size()) return false;
+            pindex->pprev = prev > 0 ? entries[prev - 1] : nullptr;
+            reader >> Using<BlockIndexSnapshotFormatter>(*pindex);
+            entries.push_back(pindex);
+        }
+        return m_block_index.size() == count;
+    }};
+
+    bool loaded{false};
+    try {
+        loaded = load();
+    } catch (const std::exception& e) {
+        LogWarning("Failed to deserialize block index snapshot %s: %s", fs::PathToString(path), e.what());
+    }
+    if (!loaded) {
+        m_block_index.clear();
+        return false;
+    }
+    LogInfo("Loaded %d block index entries from snapshot %s", m_block_index.size(), fs::PathToString(path));
+    return true;
+}
+
+void BlockManager::WriteBlockIndexSnapshot()
+{
+    AssertLockHeld(cs_main);
+    if (m_opts.block_tree_db_params.memory_only || !m_block_index_loaded) return;
+    // The snapshot must match the database exactly.
+    if (!m_dirty_blockindex.empty() || !m_dirty_fileinfo.empty()) return;
+    int last_file{0};
+    CBlockFileInfo last_file_info;
+    m_block_tree_db->ReadLastBlockFile(last_file);
+    m_block_tree_db->ReadBlockFileInfo(last_file, last_file_info);
+
+    std::vector<std::pair<int, const CBlockIndex*>> sorted_by_height;
+    sorted_by_height.reserve(m_block_index.size());
+    for (const auto& [_, block_index] : m_block_index) sorted_by_height.emplace_back(block_index.nHeight, &block_index);
+    std::sort(sorted_by_height.begin(), sorted_by_height.end());
+    std::unordered_map<const CBlockIndex*, uint32_t> positions;
+    positions.reserve(sorted_by_height.size());
+
+    const uint64_t token{FastRandomContext().rand64()};
+    const fs::path path{BlockIndexSnapshotPath()};
+    const fs::path path_tmp{path + ".new"};
+    AutoFile file{fsbridge::fopen(path_tmp, "wb")};
+    if (file.IsNull()) {
+        LogWarning("Failed to open block index snapshot %s for writing", fs::PathToString(path_tmp));
+        return;
+    }
+    try {
+        BufferedWriter buffered{file};
+        HashedSourceWriter writer{buffered};
+        writer << GetParams().MessageStart() << BLOCK_INDEX_SNAPSHOT_VERSION << token << last_file << last_file_info
+               << uint64_t(sorted_by_height.size());
+        for (const auto& [_, pindex] : sorted_by_height) {
+            // Position 0 means there is no parent. Parents have a lower height, so they have been written already.
+            const uint32_t prev{pindex->pprev ? positions.at(pindex->pprev) : 0};
+            writer << pindex->GetBlockHash() << prev << Using<BlockIndexSnapshotFormatter>(*pindex);
+            positions.emplace(pindex, positions.size() + 1);
+        }
+        buffered << writer.GetHash();
+    } catch (const std::exception& e) {
+        LogWarning("Failed to write block index snapshot %s: %s", fs::PathToString(path_tmp), e.what());
+        (void)file.fclose();
+        fs::remove(path_tmp);
+        return;
+    }
+    if (!file.Commit() || file.fclose() != 0 || !RenameOver(path_tmp, path)) {
+        LogWarning("Failed to write block index snapshot %s", fs::PathToString(path));
+        (void)file.fclose();
+        fs::remove(path_tmp);
+        return;
+    }
+    m_block_tree_db->WriteBlockIndexSnapshotToken(last_file, token);
+    LogInfo("Wrote %d block index entries to snapshot %s", sorted_by_height.size(), fs::PathToString(path));
+}
+
+bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
+{
+    if (!LoadBlockIndexSnapshot()) {
+        std::optional<ThreadPool> thread_pool;
+        if (m_opts.block_index_load_threads > 0) {
+            thread_pool.emplace("blockindex");
+            thread_pool->Start(m_opts.block_index_load_threads);
+        }
+        if (!m_block_tree_db->LoadBlockIndexGuts(
+                GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt,
+                thread_pool ? &*thread_pool : nullptr)) {
+            return false;
+        }
+    }
+
     if (snapshot_blockhash) {
         const std::optional<AssumeutxoData> maybe_au_data = GetParams().AssumeutxoForBlockhash(*snapshot_blockhash);
         if (!maybe_au_data) {
@@ -468,20 +760,25 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
 
     Assert(m_snapshot_height.has_value() == snapshot_blockhash.has_value());
 
-    // Calculate nChainWork
-    std::vector<CBlockIndex*> vSortedByHeight{GetAllBlockIndices()};
-    std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
-              CBlockIndexHeightOnlyComparator());
+    // Calculate nChainWork. Sorting by height is done on a copy of the heights, so that comparisons do not have to
+    // chase pointers into the block index.
+    std::vector<std::pair<int, CBlockIndex*>> vSortedByHeight;
+    vSortedByHeight.reserve(m_block_index.size());
+    for (CBlockIndex* pindex : GetAllBlockIndices()) vSortedByHeight.emplace_back(pindex->nHeight, pindex);
+    std::sort(vSortedByHeight.begin(), vSortedByHeight.end());
 
+    // The proof of a block only depends on nBits, which is the same for long runs of consecutive blocks.
+    std::optional<std::pair<uint32_t, arith_uint256>> last_proof;
     CBlockIndex* previous_index{nullptr};
-    for (CBlockIndex* pindex : vSortedByHeight) {
+    for (const auto& [_, pindex] : vSortedByHeight) {
         if (m_interrupt) return false;
         if (previous_index && pindex->nHeight > previous_index->nHeight + 1) {
             LogError("%s: block index is non-contiguous, index of height %d missing\n", __func__, previous_index->nHeight + 1);
             return false;
         }
         previous_index = pindex;
-        pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
+        if (!last_proof || last_proof->first != pindex->nBits) last_proof.emplace(pindex->nBits, GetBlockProof(*pindex));
+        pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + last_proof->second;
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
 
         // We can link the chain of blocks for which we've received transactions at some point, or
@@ -591,6 +888,7 @@ bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_block
             const auto last_height_in_file = m_blockfile_info[i].nHeightLast;
             m_blockfile_cursors[BlockfileTypeForHeight(last_height_in_file)] = {static_cast<int>(i), 0};
         }
+        UpdateFirstOpenBlockfile();
     }
 
     // Check whether we have ever pruned block & undo files
@@ -604,6 +902,7 @@ bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_block
     m_block_tree_db->ReadReindexing(fReindexing);
     if (fReindexing) m_blockfiles_indexed = false;
 
+    m_block_index_loaded = true;
     return true;
 }
 
@@ -820,6 +1119,10 @@ uint64_t BlockManager::CalculateCurrentUsage()
 
 void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
 {
+    {
+        LOCK(m_mapped_blockfiles_mutex);
+        for (const int file_num : setFilesToPrune) m_mapped_blockfiles.erase(file_num);
+    }
     std::error_code ec;
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
@@ -831,6 +1134,32 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
     }
 }
 
+void BlockManager::UpdateFirstOpenBlockfile()
+{
+    AssertLockHeld(::cs_main);
+    int first_open{std::numeric_limits<int>::max()};
+    for (const auto& cursor : m_blockfile_cursors) {
+        if (cursor) first_open = std::min(first_open, cursor->file_num);
+    }
+    m_first_open_blockfile.store(first_open == std::numeric_limits<int>::max() ? 0 : first_open, std::memory_order_release);
+}
+
+std::shared_ptr<const MappedFile> BlockManager::MapBlockFile(int file_num) const
+{
+    if (!MappedFile::SUPPORTED || !m_opts.use_mmap || file_num >= m_first_open_blockfile.load(std::memory_order_acquire)) return nullptr;
+    LOCK(m_mapped_blockfiles_mutex);
+    if (const auto it{m_mapped_blockfiles.find(file_num)}; it != m_mapped_blockfiles.end()) return it->second;
+    std::shared_ptr<const MappedFile> mapped{MappedFile::Open(m_block_file_seq.FileName({file_num, 0}))};
+    if (!mapped) {
+        LogDebug(BCLog::BLOCKSTORAGE, "Failed to map block file %05u, reading it without a memory map\n", file_num);
+        return nullptr;
+    }
+    // Readers keep the maps they use alive, so dropping all of them at once is safe.
+    if (m_mapped_blockfiles.size() >= MAX_MAPPED_BLOCKFILES) m_mapped_blockfiles.clear();
+    m_mapped_blockfiles.emplace(file_num, mapped);
+    return mapped;
+}
+
 AutoFile BlockManager::OpenBlockFile(const FlatFilePos& pos, bool fReadOnly) const
 {
     return AutoFile{m_block_file_seq.Open(pos, fReadOnly), m_obfuscation};
@@ -917,6 +1246,7 @@ FlatFilePos BlockManager::FindNextBlockPos(unsigned int nAddSize, unsigned int n
         }
         // No undo data yet in the new file, so reset our undo-height tracking.
         m_blockfile_cursors[chain_type] = BlockfileCursor{nFile};
+        UpdateFirstOpenBlockfile();
     }
 
     m_blockfile_info[nFile].AddBlock(nHeight, nTime);
@@ -944,6 +1274,7 @@ void BlockManager::UpdateBlockInfo(const CBlock& block, unsigned int nHeight, co
     auto& cursor{m_blockfile_cursors[chain_type]};
     if (!cursor || cursor->file_num < pos.nFile) {
         m_blockfile_cursors[chain_type] = BlockfileCursor{pos.nFile};
+        UpdateFirstOpenBlockfile();
     }
 
     // Update the file information with the current block.
@@ -1094,7 +1425,45 @@ bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
     return ReadBlock(block, block_pos, index.GetBlockHash());
 }
 
-BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
+namespace {
+/** Reads from a memory mapped block file like from an AutoFile positioned at the given offset. */
+class MappedBlockFileReader
+{
+    std::span<const std::byte> m_data;
+    size_t m_position;
+    const Obfuscation& m_obfuscation;
+
+public:
+    MappedBlockFileReader(std::span<const std::byte> data, size_t position, const Obfuscation& obfuscation)
+        : m_data{data}, m_position{position}, m_obfuscation{obfuscation} {}
+
+    void read(std::span<std::byte> dst)
+    {
+        if (m_position > m_data.size() || dst.size() > m_data.size() - m_position) {
+            throw std::ios_base::failure("MappedBlockFileReader::read: end of file");
+        }
+        std::memcpy(dst.data(), m_data.data() + m_position, dst.size());
+        m_obfuscation(dst, m_position);
+        m_position += dst.size();
+    }
+
+    void seek(int64_t offset, int origin)
+    {
+        Assume(origin == SEEK_CUR && offset >= 0);
+        m_position += offset;
+    }
+
+    template <typename T>
+    MappedBlockFileReader& operator>>(T&& obj)
+    {
+        ::Unserialize(*this, obj);
+        return *this;
+    }
+};
+} // namespace
+
+template <typename Byte>
+util::Expected<std::vector<Byte>, ReadRawError> BlockManager::ReadRawBlockInto(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
 {
     if (pos.nPos < STORAGE_HEADER_BYTES) {
         // If nPos is less than STORAGE_HEADER_BYTES, we can't read the header that precedes the block data
@@ -1103,46 +1472,67 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
         LogError("Failed for %s while reading raw block storage header", pos.ToString());
         return util::Unexpected{ReadRawError::IO};
     }
-    AutoFile filein{OpenBlockFile({pos.nFile, pos.nPos - STORAGE_HEADER_BYTES}, /*fReadOnly=*/true)};
-    if (filein.IsNull()) {
-        LogError("OpenBlockFile failed for %s while reading raw block", pos.ToString());
-        return util::Unexpected{ReadRawError::IO};
-    }
 
-    try {
-        MessageStartChars blk_start;
-        unsigned int blk_size;
+    const auto read_raw_block{[&](auto& filein) -> util::Expected<std::vector<Byte>, ReadRawError> {
+        try {
+            MessageStartChars blk_start;
+            unsigned int blk_size;
 
-        filein >> blk_start >> blk_size;
+            filein >> blk_start >> blk_size;
 
-        if (blk_start != GetParams().MessageStart()) {
-            LogError("Block magic mismatch for %s: %s versus expected %s while reading raw block",
-                pos.ToString(), HexStr(blk_start), HexStr(GetParams().MessageStart()));
-            return util::Unexpected{ReadRawError::IO};
-        }
+            if (blk_start != GetParams().MessageStart()) {
+                LogError("Block magic mismatch for %s: %s versus expected %s while reading raw block",
+                    pos.ToString(), HexStr(blk_start), HexStr(GetParams().MessageStart()));
+                return util::Unexpected{ReadRawError::IO};
+            }
 
-        if (blk_size > MAX_SIZE) {
-            LogError("Block data is larger than maximum deserialization size for %s: %s versus %s while reading raw block",
-                pos.ToString(), blk_size, MAX_SIZE);
-            return util::Unexpected{ReadRawError::IO};
-        }
+            if (blk_size > MAX_SIZE) {
+                LogError("Block data is larger than maximum deserialization size for %s: %s versus %s while reading raw block",
+                    pos.ToString(), blk_size, MAX_SIZE);
+                return util::Unexpected{ReadRawError::IO};
+            }
 
-        if (block_part) {
-            const auto [offset, size]{*block_part};
-            if (size == 0 || SaturatingAdd(offset, size) > blk_size) {
-                return util::Unexpected{ReadRawError::BadPartRange}; // Avoid logging - offset/size come from untrusted REST input
+            if (block_part) {
+                const auto [offset, size]{*block_part};
+                if (size == 0 || SaturatingAdd(offset, size) > blk_size) {
+                    return util::Unexpected{ReadRawError::BadPartRange}; // Avoid logging - offset/size come from untrusted REST input
+                }
+                filein.seek(offset, SEEK_CUR);
+                blk_size = size;
             }
-            filein.seek(offset, SEEK_CUR);
-            blk_size = size;
+
+            std::vector<Byte> data(blk_size); // Zeroing of memory is intentional here
+            filein.read(std::as_writable_bytes(std::span{data}));
+            return data;
+        } catch (const std::exception& e) {
+            LogError("Read from block file failed: %s for %s while reading raw block", e.what(), pos.ToString());
+            return util::Unexpected{ReadRawError::IO};
         }
+    }};
 
-        std::vector<std::byte> data(blk_size); // Zeroing of memory is intentional here
-        filein.read(data);
-        return data;
-    } catch (const std::exception& e) {
-        LogError("Read from block file failed: %s for %s while reading raw block", e.what(), pos.ToString());
+    // Block files that are no longer written to are read through a memory map, avoiding a system call and a copy
+    // through the stdio buffer for every block.
+    if (const auto mapped{MapBlockFile(pos.nFile)}) {
+        MappedBlockFileReader filein{mapped->Data(), pos.nPos - STORAGE_HEADER_BYTES, m_obfuscation};
+        return read_raw_block(filein);
+    }
+
+    AutoFile filein{OpenBlockFile({pos.nFile, pos.nPos - STORAGE_HEADER_BYTES}, /*fReadOnly=*/true)};
+    if (filein.IsNull()) {
+        LogError("OpenBlockFile failed for %s while reading raw block", pos.ToString());
         return util::Unexpected{ReadRawError::IO};
     }
+    return read_raw_block(filein);
+}
+
+BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
+{
+    return ReadRawBlockInto<std::byte>(pos, block_part);
+}
+
+BlockManager::ReadRawNetworkBlockResult BlockManager::ReadRawBlockForNetwork(const FlatFilePos& pos) const
+{
+    return ReadRawBlockInto<unsigned char>(pos, /*block_part=*/std::nullopt);
 }
 
 FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
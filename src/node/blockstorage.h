@@ -24,6 +24,7 @@
 #include <util/expected.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/mappedfile.h>
 #include <util/obfuscation.h>
 
 #include <algorithm>
@@ -48,6 +49,7 @@ class BlockValidationState;
 class CBlockUndo;
 class Chainstate;
 class ChainstateManager;
+class ThreadPool;
 namespace Consensus {
 struct Params;
 }
@@ -82,6 +84,8 @@ public:
 
     std::string ToString() const;
 
+    friend bool operator==(const CBlockFileInfo&, const CBlockFileInfo&) = default;
+
     /** update statistics (does not update nSize) */
     void AddBlock(unsigned int nHeightIn, uint64_t nTimeIn)
     {
@@ -109,7 +113,18 @@ public:
     void ReadReindexing(bool& fReindexing);
     void WriteFlag(const std::string& name, bool fValue);
     bool ReadFlag(const std::string& name, bool& fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
+    /**
+     * Record that the block index snapshot with the given token matches the database. The token is stored along with
+     * the last block file number, so any later WriteBatchSync() invalidates it, including one by an older version.
+     */
+    void WriteBlockIndexSnapshotToken(int last_file, uint64_t token);
+    std::optional<uint64_t> ReadBlockIndexSnapshotToken();
+    /**
+     * Load all block index entries, passing each through insertBlockIndex. If a thread pool with workers is given,
+     * entries are read, hashed and checked for proof of work on its threads, while they are deserialized and passed to
+     * insertBlockIndex on this one.
+     */
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt, ThreadPool* thread_pool = nullptr)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
 } // namespace kernel
@@ -124,6 +139,8 @@ inline constexpr unsigned int BLOCKFILE_CHUNK_SIZE{16_MiB};
 inline constexpr unsigned int UNDOFILE_CHUNK_SIZE{1_MiB};
 /** The maximum size of a blk?????.dat file (since 0.8) */
 inline constexpr unsigned int MAX_BLOCKFILE_SIZE{128_MiB};
+/** The maximum number of blk?????.dat files kept memory mapped for reading */
+inline constexpr size_t MAX_MAPPED_BLOCKFILES{1024};
 
 /** Size of header written by WriteBlock before a serialized CBlock (8 bytes) */
 inline constexpr uint32_t STORAGE_HEADER_BYTES{std::tuple_size_v<MessageStartChars> + sizeof(unsigned int)};
@@ -291,6 +308,21 @@ private:
 
     const Obfuscation m_obfuscation;
 
+    //! Block files numbered below this are no longer appended to, so they can be read through a memory map.
+    std::atomic<int> m_first_open_blockfile{0};
+    //! Recompute m_first_open_blockfile after the blockfile cursors have changed.
+    void UpdateFirstOpenBlockfile() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    mutable Mutex m_mapped_blockfiles_mutex;
+    //! Memory maps of block files that are no longer appended to, by file number.
+    mutable std::unordered_map<int, std::shared_ptr<const MappedFile>> m_mapped_blockfiles GUARDED_BY(m_mapped_blockfiles_mutex);
+    //! Return a memory map of the given block file, or nullptr if it may still be appended to or cannot be mapped.
+    std::shared_ptr<const MappedFile> MapBlockFile(int file_num) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_blockfiles_mutex);
+
+    //! Implementation of ReadRawBlock() and ReadRawBlockForNetwork(), reading into a vector of the given byte type.
+    template <typename Byte>
+    util::Expected<std::vector<Byte>, ReadRawError> ReadRawBlockInto(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_blockfiles_mutex);
+
     /**
      * Map from external index name to oldest block that must not be pruned.
      *
@@ -315,9 +347,20 @@ protected:
     /** Dirty block file entries. */
     std::set<int> m_dirty_fileinfo;
 
+    /** Whether m_block_index holds all entries of the block tree database, so that it can be written to a snapshot. */
+    bool m_block_index_loaded GUARDED_BY(::cs_main){false};
+
+    fs::path BlockIndexSnapshotPath() const;
+    /**
+     * Populate m_block_index from the snapshot written at the last clean shutdown, if the block tree database has not
+     * changed since. On failure, m_block_index is left empty, and it has to be loaded from the database instead.
+     */
+    bool LoadBlockIndexSnapshot() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
 public:
     using Options = kernel::BlockManagerOpts;
     using ReadRawBlockResult = util::Expected<std::vector<std::byte>, ReadRawError>;
+    using ReadRawNetworkBlockResult = util::Expected<std::vector<unsigned char>, ReadRawError>;
 
     explicit BlockManager(const util::SignalInterrupt& interrupt, Options opts);
 
@@ -359,6 +402,11 @@ public:
     std::unique_ptr<BlockTreeDB> m_block_tree_db GUARDED_BY(::cs_main);
 
     void WriteBlockIndexDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    /**
+     * Write the block index to a flat file next to the block tree database, from which it is loaded without hashing
+     * and looking up every entry at the next startup. Only done if all changes have been flushed to the database.
+     */
+    void WriteBlockIndexSnapshot() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     bool LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
@@ -470,12 +518,17 @@ public:
     /**
      *  Actually unlink the specified files
      */
-    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
+    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_blockfiles_mutex);
 
     /** Functions for disk access for blocks */
-    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const;
-    bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
-    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const;
+    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_blockfiles_mutex);
+    bool ReadBlock(CBlock& block, const CBlockIndex& index) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_blockfiles_mutex);
+    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_blockfiles_mutex);
+    /**
+     * Read a block in its serialized form into a buffer that can be moved into a network message as is. The block is
+     * read directly from the block file (or its memory map) into the buffer, so serving it to peers copies it once.
+     */
+    ReadRawNetworkBlockResult ReadRawBlockForNetwork(const FlatFilePos& pos) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_blockfiles_mutex);
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
@@ -67,6 +67,15 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
         opts.prevoutfetch_threads_num = std::min(*value, MAX_PREVOUTFETCH_THREADS);
     }
 
+    if (auto value{args.GetArg<int32_t>("-utxoscanthreads")}) {
+        if (*value < 0) {
+            return util::Error{Untranslated(strprintf("-utxoscanthreads must be non-negative (got %d). Use 0 to scan the UTXO set on a single thread.", *value))};
+        }
+        opts.utxo_scan_threads = std::min(*value, MAX_UTXO_SCAN_THREADS);
+    } else {
+        opts.utxo_scan_threads = std::clamp(GetNumCores() - 1, 0, MAX_UTXO_SCAN_THREADS);
+    }
+
     if (auto max_size = args.GetIntArg("-maxsigcachesize")) {
         // 1. When supplied with a max_size of 0, both the signature cache and
         //    script execution cache create the minimum possible cache (2
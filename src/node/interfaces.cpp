@@ -475,6 +475,13 @@ public:
     {
         m_notifications->transactionAddedToMempool(tx.info.m_tx);
     }
+    void TransactionsAddedToMempool(std::span<const std::pair<NewMempoolTransactionInfo, uint64_t>> txs) override
+    {
+        std::vector<CTransactionRef> added;
+        added.reserve(txs.size());
+        for (const auto& [tx, mempool_sequence] : txs) added.push_back(tx.info.m_tx);
+        m_notifications->transactionsAddedToMempool(added);
+    }
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override
     {
         m_notifications->transactionRemovedFromMempool(tx, reason);
@@ -501,10 +508,10 @@ public:
 class NotificationsHandlerImpl : public Handler
 {
 public:
-    explicit NotificationsHandlerImpl(ValidationSignals& signals, std::shared_ptr<Chain::Notifications> notifications)
+    explicit NotificationsHandlerImpl(ValidationSignals& signals, std::shared_ptr<Chain::Notifications> notifications, std::string name)
         : m_signals{signals}, m_proxy{std::make_shared<NotificationsProxy>(std::move(notifications))}
     {
-        m_signals.RegisterSharedValidationInterface(m_proxy);
+        m_signals.RegisterSharedValidationInterface(m_proxy, std::move(name));
     }
     ~NotificationsHandlerImpl() override { disconnect(); }
     void disconnect() override
@@ -791,9 +798,9 @@ public:
     {
         ::uiInterface.ShowProgress(title, progress, resume_possible);
     }
-    std::unique_ptr<Handler> handleNotifications(std::shared_ptr<Notifications> notifications) override
+    std::unique_ptr<Handler> handleNotifications(std::shared_ptr<Notifications> notifications, std::string name) override
     {
-        return std::make_unique<NotificationsHandlerImpl>(validation_signals(), std::move(notifications));
+        return std::make_unique<NotificationsHandlerImpl>(validation_signals(), std::move(notifications), std::move(name));
     }
     void waitForNotificationsIfTipChanged(const uint256& old_tip) override
     {
@@ -105,6 +105,8 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& argsman, const CChainP
 
     mempool_opts.persist_v1_dat = argsman.GetBoolArg("-persistmempoolv1", mempool_opts.persist_v1_dat);
 
+    mempool_opts.parallel_script_checks = argsman.GetBoolArg("-parmempool", mempool_opts.parallel_script_checks);
+
     ApplyArgsManOptions(argsman, mempool_opts.limits);
 
     if (mempool_opts.limits.cluster_count > MAX_CLUSTER_COUNT_LIMIT) {
@@ -6,6 +6,7 @@
 #ifndef BITCOIN_PRIMITIVES_BLOCK_H
 #define BITCOIN_PRIMITIVES_BLOCK_H
 
+#include <crypto/sha256.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <uint256.h>
@@ -92,9 +93,24 @@ public:
         *(static_cast<CBlockHeader*>(this)) = header;
     }
 
-    SERIALIZE_METHODS(CBlock, obj)
+    template <typename Stream>
+    void Serialize(Stream& s) const
     {
-        READWRITE(AsBase<CBlockHeader>(obj), obj.vtx);
+        ::SerializeMany(s, AsBase<CBlockHeader>(*this), vtx);
+    }
+
+    /** Where SHA-256 is computed in parallel lanes, the transactions are converted as a batch, so that their hashes
+     *  are computed together. */
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        if (!SHA256DMultiIsParallel()) {
+            ::UnserializeMany(s, AsBase<CBlockHeader>(*this), vtx);
+            return;
+        }
+        std::vector<CMutableTransaction> txs;
+        ::UnserializeMany(s, AsBase<CBlockHeader>(*this), txs);
+        vtx = MakeTransactionRefs(std::move(txs));
     }
 
     void SetNull()
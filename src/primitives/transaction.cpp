@@ -7,6 +7,7 @@
 
 #include <consensus/amount.h>
 #include <crypto/hex_base.h>
+#include <crypto/sha256.h>
 #include <hash.h>
 #include <primitives/transaction_identifier.h>
 #include <script/script.h>
@@ -15,8 +16,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <span>
 #include <stdexcept>
+#include <vector>
 
 std::string COutPoint::ToString() const
 {
@@ -94,6 +97,65 @@ Wtxid CTransaction::ComputeWitnessHash() const
 
 CTransaction::CTransaction(const CMutableTransaction& tx) : vin(tx.vin), vout(tx.vout), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
 CTransaction::CTransaction(CMutableTransaction&& tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
+CTransaction::CTransaction(CMutableTransaction&& tx, const PrecomputedHashes& hashes) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{hashes.hash}, m_witness_hash{hashes.witness_hash} {}
+
+namespace {
+/** Appends serialized objects to a byte vector. */
+class BatchWriter
+{
+    std::vector<unsigned char>& m_buffer;
+
+public:
+    explicit BatchWriter(std::vector<unsigned char>& buffer) : m_buffer{buffer} {}
+
+    void write(std::span<const std::byte> src) { m_buffer.insert(m_buffer.end(), UCharCast(src.data()), UCharCast(src.data() + src.size())); }
+
+    template <typename T>
+    BatchWriter& operator<<(const T& obj)
+    {
+        ::Serialize(*this, obj);
+        return *this;
+    }
+};
+} // namespace
+
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs)
+{
+    // Serialize all transactions back to back, each one without witness and, if it has one, with witness, and hash
+    // the resulting messages in one go.
+    std::vector<unsigned char> buffer;
+    std::vector<size_t> ends;
+    ends.reserve(2 * txs.size());
+    BatchWriter writer{buffer};
+    for (const auto& tx : txs) {
+        writer << TX_NO_WITNESS(tx);
+        ends.push_back(buffer.size());
+        if (tx.HasWitness()) {
+            writer << TX_WITH_WITNESS(tx);
+            ends.push_back(buffer.size());
+        }
+    }
+    std::vector<std::span<const unsigned char>> messages;
+    messages.reserve(ends.size());
+    for (size_t i{0}; i < ends.size(); ++i) {
+        const size_t begin{i == 0 ? 0 : ends[i - 1]};
+        messages.emplace_back(buffer.data() + begin, ends[i] - begin);
+    }
+    std::vector<unsigned char> digests(messages.size() * CSHA256::OUTPUT_SIZE);
+    SHA256DMulti(digests.data(), messages);
+
+    std::vector<CTransactionRef> ret;
+    ret.reserve(txs.size());
+    const unsigned char* digest{digests.data()};
+    for (auto& tx : txs) {
+        const uint256 hash{std::span{digest, CSHA256::OUTPUT_SIZE}};
+        if (tx.HasWitness()) digest += CSHA256::OUTPUT_SIZE;
+        const uint256 witness_hash{std::span{digest, CSHA256::OUTPUT_SIZE}};
+        digest += CSHA256::OUTPUT_SIZE;
+        ret.push_back(std::make_shared<const CTransaction>(std::move(tx), CTransaction::PrecomputedHashes{Txid::FromUint256(hash), Wtxid::FromUint256(witness_hash)}));
+    }
+    return ret;
+}
 
 CAmount CTransaction::GetValueOut() const
 {
@@ -305,9 +305,24 @@ private:
     bool ComputeHasWitness() const;
 
 public:
+    /** Txid and wtxid computed ahead of construction. Only MakeTransactionRefs can create them, so only it can use
+     *  the constructor taking them. */
+    class PrecomputedHashes
+    {
+        Txid hash;
+        Wtxid witness_hash;
+
+        PrecomputedHashes(const Txid& hash_in, const Wtxid& witness_hash_in) : hash{hash_in}, witness_hash{witness_hash_in} {}
+
+        friend class CTransaction;
+        friend std::vector<std::shared_ptr<const CTransaction>> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs);
+    };
+
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction& tx);
     explicit CTransaction(CMutableTransaction&& tx);
+    /** Convert a CMutableTransaction whose hashes are already known. */
+    CTransaction(CMutableTransaction&& tx, const PrecomputedHashes& hashes);
 
     template <typename Stream>
     inline void Serialize(Stream& s) const {
@@ -403,6 +418,10 @@ struct CMutableTransaction
 typedef std::shared_ptr<const CTransaction> CTransactionRef;
 template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
 
+/** Convert a batch of transactions, such as those of a block, computing the txids and wtxids of all of them together
+ *  so that several transactions are hashed in parallel (see SHA256DMulti). */
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs);
+
 namespace std {
 /** Disable default std::hash for CTransactionRef to prevent accidentally
  *  comparing by pointer. Use CTransactionRefHash or provide a custom
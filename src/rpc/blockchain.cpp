@@ -50,6 +50,7 @@
 #include <util/fs.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -57,6 +58,7 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <condition_variable>
 #include <iterator>
 #include <memory>
@@ -76,16 +78,20 @@ using node::NodeContext;
 using node::SnapshotMetadata;
 using util::MakeUnorderedList;
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
+//! Write buffer size for dumptxoutset.
+static constexpr size_t SNAPSHOT_WRITE_BUFFER_SIZE{1 << 20};
+
+std::tuple<std::unique_ptr<CCoinsViewCursor>, std::optional<CCoinsStats>, const CBlockIndex*>
 PrepareUTXOSnapshot(
     Chainstate& chainstate,
+    bool seekable,
     const std::function<void()>& interruption_point = {})
     EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
     CCoinsViewCursor* pcursor,
-    CCoinsStats* maybe_stats,
+    const std::optional<CCoinsStats>& maybe_stats,
     const CBlockIndex* tip,
     AutoFile&& afile,
     const fs::path& path,
@@ -991,12 +997,14 @@ CoinStatsHashType ParseHashType(std::string_view hash_type_input)
  * Calculate statistics about the unspent transaction output set
  *
  * @param[in] index_requested Signals if the coinstatsindex should be used (when available).
+ * @param[in] scan_threads Number of worker threads to scan the UTXO set on, if it is scanned.
  */
 static std::optional<kernel::CCoinsStats> GetUTXOStats(const CCoinsViewDB& view, node::BlockManager& blockman,
                                                        kernel::CoinStatsHashType hash_type,
                                                        const std::function<void()>& interruption_point = {},
                                                        const CBlockIndex* pindex = nullptr,
-                                                       bool index_requested = true)
+                                                       bool index_requested = true,
+                                                       int scan_threads = 0)
 {
     // Use CoinStatsIndex if it is requested and available and a hash_type of Muhash or None was requested
     if ((hash_type == kernel::CoinStatsHashType::MUHASH || hash_type == kernel::CoinStatsHashType::NONE) && g_coin_stats_index && index_requested) {
@@ -1014,7 +1022,7 @@ static std::optional<kernel::CCoinsStats> GetUTXOStats(const CCoinsViewDB& view,
     // best block.
     CHECK_NONFATAL(!pindex || pindex->GetBlockHash() == view.GetBestBlock());
 
-    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point);
+    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point, scan_threads);
 }
 
 static RPCMethod gettxoutsetinfo()
@@ -1114,7 +1122,7 @@ static RPCMethod gettxoutsetinfo()
         }
     }
 
-    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, blockman, hash_type, node.rpc_interruption_point, pindex, index_requested);
+    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, blockman, hash_type, node.rpc_interruption_point, pindex, index_requested, chainman.m_options.utxo_scan_threads);
     if (maybe_stats.has_value()) {
         const CCoinsStats& stats = maybe_stats.value();
         ret.pushKV("height", stats.nHeight);
@@ -2221,11 +2229,9 @@ static RPCMethod getblockstats()
 }
 
 namespace {
-//! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+//! Search for a given set of pubkey scripts in the coins of a cursor
+bool FindScriptPubKey(const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, const std::function<void()>& interruption_point)
 {
-    scan_progress = 0;
-    count = 0;
     while (cursor->Valid()) {
         COutPoint key;
         Coin coin;
@@ -2237,19 +2243,43 @@ bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>&
                 return false;
             }
         }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
-        }
         if (needles.contains(coin.out.scriptPubKey)) {
             out_results.emplace(key, coin);
         }
         cursor->Next();
     }
-    scan_progress = 100;
     return true;
 }
+
+//! Search the partitions of the UTXO set for a given set of pubkey scripts, on scan_threads worker threads
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, const std::function<void()>& interruption_point, int scan_threads)
+{
+    scan_progress = 0;
+    count = 0;
+
+    std::optional<ThreadPool> thread_pool;
+    if (scan_threads > 0) {
+        thread_pool.emplace("utxoscan");
+        thread_pool->Start(scan_threads);
+    }
+
+    std::vector<std::pair<int64_t, std::map<COutPoint, Coin>>> partials(cursors.size());
+    const bool res{ScanPartitions(
+        cursors.size(), thread_pool ? &*thread_pool : nullptr,
+        [&](size_t partition) {
+            auto& [partial_count, partial_results]{partials[partition]};
+            return FindScriptPubKey(should_abort, partial_count, cursors[partition].get(), needles, partial_results, interruption_point);
+        },
+        [&](size_t partition) {
+            auto& [partial_count, partial_results]{partials[partition]};
+            count += partial_count;
+            out_results.merge(partial_results);
+            cursors[partition].reset();
+            scan_progress = static_cast<int>((partition + 1) * 100 / cursors.size());
+            return !should_abort;
+        })};
+    return res;
+}
 } // namespace
 
 /** RAII object to prevent concurrency issue when scanning the txout set */
@@ -2434,18 +2464,18 @@ static RPCMethod scantxoutset()
         std::map<COutPoint, Coin> coins;
         g_should_abort_scan = false;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
+        ChainstateManager& chainman = EnsureChainman(node);
         {
-            ChainstateManager& chainman = EnsureChainman(node);
             LOCK(cs_main);
             Chainstate& active_chainstate = chainman.ActiveChainstate();
             active_chainstate.ForceFlushStateToDisk(/*wipe_cache=*/false);
-            pcursor = active_chainstate.CoinsDB().Cursor();
+            cursors = active_chainstate.CoinsDB().PartitionedCursors(UTXO_SCAN_PARTITIONS);
             tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, cursors, needles, coins, node.rpc_interruption_point, chainman.m_options.utxo_scan_threads);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -3322,14 +3352,22 @@ UniValue CreateRolledBackUTXOSnapshot(
     CHECK_NONFATAL(rollback_cache.GetBestBlock() == target->GetBlockHash());
     rollback_cache.Flush();
 
-    LogInfo("Rollback complete. Computing UTXO statistics for created txoutset dump.");
-    std::optional<CCoinsStats> maybe_stats = GetUTXOStats(*temp_db,
-                                                          chainstate.m_blockman,
-                                                          CoinStatsHashType::HASH_SERIALIZED,
-                                                          node.rpc_interruption_point);
+    // The statistics are computed while writing, unless the coins count is needed up front because the metadata
+    // cannot be rewritten afterwards.
+    std::optional<CCoinsStats> maybe_stats;
+    if (fs::is_fifo(fs::status(tmppath))) {
+        LogInfo("Rollback complete. Computing UTXO statistics for created txoutset dump.");
+        maybe_stats = GetUTXOStats(*temp_db,
+                                   chainstate.m_blockman,
+                                   CoinStatsHashType::HASH_SERIALIZED,
+                                   node.rpc_interruption_point,
+                                   /*pindex=*/nullptr,
+                                   /*index_requested=*/true,
+                                   chainstate.m_chainman.m_options.utxo_scan_threads);
 
-    if (!maybe_stats) {
-        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to compute UTXO statistics");
+        if (!maybe_stats) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to compute UTXO statistics");
+        }
     }
 
     std::unique_ptr<CCoinsViewCursor> pcursor{temp_db->Cursor()};
@@ -3337,7 +3375,7 @@ UniValue CreateRolledBackUTXOSnapshot(
     LogInfo("Writing snapshot to disk.");
     return WriteUTXOSnapshot(chainstate,
                              pcursor.get(),
-                             &(*maybe_stats),
+                             maybe_stats,
                              target,
                              std::move(afile),
                              path,
@@ -3345,9 +3383,10 @@ UniValue CreateRolledBackUTXOSnapshot(
                              node.rpc_interruption_point);
 }
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
+std::tuple<std::unique_ptr<CCoinsViewCursor>, std::optional<CCoinsStats>, const CBlockIndex*>
 PrepareUTXOSnapshot(
     Chainstate& chainstate,
+    bool seekable,
     const std::function<void()>& interruption_point)
 {
     std::unique_ptr<CCoinsViewCursor> pcursor;
@@ -3367,26 +3406,33 @@ PrepareUTXOSnapshot(
         // See discussion here:
         //   https://github.com/bitcoin/bitcoin/pull/15606#discussion_r274479369
         //
+        // The stats are only computed here, holding cs_main for a full pass
+        // over the UTXO set, when the output can't be seeked to fill in the
+        // coins count afterwards. Otherwise WriteUTXOSnapshot computes them
+        // from the cursor while writing.
         AssertLockHeld(::cs_main);
 
         chainstate.ForceFlushStateToDisk(/*wipe_cache=*/false);
 
-        maybe_stats = GetUTXOStats(chainstate.CoinsDB(), chainstate.m_blockman, CoinStatsHashType::HASH_SERIALIZED, interruption_point);
-        if (!maybe_stats) {
-            throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
+        if (!seekable) {
+            maybe_stats = GetUTXOStats(chainstate.CoinsDB(), chainstate.m_blockman, CoinStatsHashType::HASH_SERIALIZED, interruption_point,
+                                       /*pindex=*/nullptr, /*index_requested=*/true, chainstate.m_chainman.m_options.utxo_scan_threads);
+            if (!maybe_stats) {
+                throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
+            }
         }
 
         pcursor = chainstate.CoinsDB().Cursor();
-        tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(maybe_stats->hashBlock));
+        tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(pcursor->GetBestBlock()));
     }
 
-    return {std::move(pcursor), *CHECK_NONFATAL(maybe_stats), tip};
+    return {std::move(pcursor), std::move(maybe_stats), tip};
 }
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
     CCoinsViewCursor* pcursor,
-    CCoinsStats* maybe_stats,
+    const std::optional<CCoinsStats>& maybe_stats,
     const CBlockIndex* tip,
     AutoFile&& afile,
     const fs::path& path,
@@ -3397,7 +3443,9 @@ UniValue WriteUTXOSnapshot(
         tip->nHeight, tip->GetBlockHash().ToString(),
         fs::PathToString(path), fs::PathToString(temppath)));
 
-    SnapshotMetadata metadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), maybe_stats->coins_count};
+    // Without stats, the coins count is a placeholder that is overwritten
+    // once all coins have been written.
+    SnapshotMetadata metadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), maybe_stats ? maybe_stats->coins_count : 0};
 
     afile << metadata;
 
@@ -3407,6 +3455,7 @@ UniValue WriteUTXOSnapshot(
     unsigned int iter{0};
     size_t written_coins_count{0};
     std::vector<std::pair<uint32_t, Coin>> coins;
+    HashWriter coins_hash{};
 
     // To reduce space the serialization format of the snapshot avoids
     // duplication of tx hashes. The code takes advantage of the guarantee by
@@ -3415,37 +3464,57 @@ UniValue WriteUTXOSnapshot(
     // (key.hash) and when we have them all (key.hash != last_hash) we write
     // them to file using the below lambda function.
     // See also https://github.com/bitcoin/bitcoin/issues/25675
-    auto write_coins_to_file = [&](AutoFile& afile, const Txid& last_hash, const std::vector<std::pair<uint32_t, Coin>>& coins, size_t& written_coins_count) {
-        afile << last_hash;
-        WriteCompactSize(afile, coins.size());
+    //
+    // The coins of a tx hash are written ordered by output index, which is the
+    // order ComputeUTXOStats hashes them in (the VARINT keys of the database
+    // order them differently for very large indices), so that the content
+    // hash can be computed along the way and loadtxoutset can verify it
+    // without reading the coins back from disk.
+    auto write_coins_to_file = [&](BufferedWriter<AutoFile>& writer, const Txid& last_hash, std::vector<std::pair<uint32_t, Coin>>& coins, size_t& written_coins_count) {
+        std::ranges::sort(coins, {}, &std::pair<uint32_t, Coin>::first);
+        writer << last_hash;
+        WriteCompactSize(writer, coins.size());
         for (const auto& [n, coin] : coins) {
-            WriteCompactSize(afile, n);
-            afile << coin;
+            WriteCompactSize(writer, n);
+            writer << coin;
+            kernel::ApplyCoinHash(coins_hash, COutPoint{last_hash, n}, coin);
             ++written_coins_count;
         }
     };
 
-    pcursor->GetKey(key);
-    last_hash = key.hash;
-    while (pcursor->Valid()) {
-        if (iter % 5000 == 0) interruption_point();
-        ++iter;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
-            if (key.hash != last_hash) {
-                write_coins_to_file(afile, last_hash, coins, written_coins_count);
-                last_hash = key.hash;
-                coins.clear();
+    {
+        BufferedWriter writer{afile, SNAPSHOT_WRITE_BUFFER_SIZE};
+
+        pcursor->GetKey(key);
+        last_hash = key.hash;
+        while (pcursor->Valid()) {
+            if (iter % 5000 == 0) interruption_point();
+            ++iter;
+            if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+                if (key.hash != last_hash) {
+                    write_coins_to_file(writer, last_hash, coins, written_coins_count);
+                    last_hash = key.hash;
+                    coins.clear();
+                }
+                coins.emplace_back(key.n, coin);
             }
-            coins.emplace_back(key.n, coin);
+            pcursor->Next();
         }
-        pcursor->Next();
-    }
 
-    if (!coins.empty()) {
-        write_coins_to_file(afile, last_hash, coins, written_coins_count);
+        if (!coins.empty()) {
+            write_coins_to_file(writer, last_hash, coins, written_coins_count);
+        }
     }
 
-    CHECK_NONFATAL(written_coins_count == maybe_stats->coins_count);
+    const uint256 hash_serialized{coins_hash.GetHash()};
+    if (maybe_stats) {
+        CHECK_NONFATAL(written_coins_count == maybe_stats->coins_count);
+        CHECK_NONFATAL(hash_serialized == maybe_stats->hashSerialized);
+    } else {
+        metadata.m_coins_count = written_coins_count;
+        afile.seek(0, SEEK_SET);
+        afile << metadata;
+    }
 
     if (afile.fclose() != 0) {
         throw std::ios_base::failure(
@@ -3457,7 +3526,7 @@ UniValue WriteUTXOSnapshot(
     result.pushKV("base_hash", tip->GetBlockHash().ToString());
     result.pushKV("base_height", tip->nHeight);
     result.pushKV("path", path.utf8string());
-    result.pushKV("txoutset_hash", maybe_stats->hashSerialized.ToString());
+    result.pushKV("txoutset_hash", hash_serialized.ToString());
     result.pushKV("nchaintx", tip->m_chain_tx_count);
     return result;
 }
@@ -3469,10 +3538,11 @@ UniValue CreateUTXOSnapshot(
     const fs::path& path,
     const fs::path& tmppath)
 {
-    auto [cursor, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point))};
+    const bool seekable{!fs::is_fifo(fs::status(tmppath))};
+    auto [cursor, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, seekable, node.rpc_interruption_point))};
     return WriteUTXOSnapshot(chainstate,
                              cursor.get(),
-                             &stats,
+                             stats,
                              tip,
                              std::move(afile),
                              path,
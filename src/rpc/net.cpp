@@ -675,6 +675,24 @@ static RPCMethod getnetworkinfo()
                             }
                           }
                         }},
+                        {RPCResult::Type::OBJ, "block_relay_latency", "latency of the block relay messages (cmpctblock, blocktxn and headers) from their receipt until the end of their processing",
+                        {
+                            {RPCResult::Type::ARR, "bucket_limits_ms", "upper bound of each histogram bucket in milliseconds, the last bucket counts the latencies above the last bound",
+                            {
+                                {RPCResult::Type::NUM, "", "upper bound"},
+                            }},
+                            {RPCResult::Type::OBJ_DYN, "msg_types", "histograms per message type received so far",
+                            {
+                                {RPCResult::Type::OBJ, "msg_type", "",
+                                {
+                                    {RPCResult::Type::NUM, "count", "number of messages processed"},
+                                    {RPCResult::Type::ARR, "histogram", "number of messages per latency bucket",
+                                    {
+                                        {RPCResult::Type::NUM, "", "number of messages"},
+                                    }},
+                                }},
+                            }},
+                        }},
                         {RPCResult::Type::NUM, "connections", "the total number of connections"},
                         {RPCResult::Type::NUM, "connections_in", "the number of inbound connections"},
                         {RPCResult::Type::NUM, "connections_out", "the number of outbound connections"},
@@ -744,6 +762,23 @@ static RPCMethod getnetworkinfo()
         invbuckets.pushKV("inbound", buckjson(peerman_info.inbound_bucket));
         invbuckets.pushKV("outbound", buckjson(peerman_info.outbound_bucket));
         obj.pushKV("inv_buckets", invbuckets);
+        UniValue block_relay_latency{UniValue::VOBJ};
+        UniValue bucket_limits{UniValue::VARR};
+        for (const auto limit : BlockRelayLatency::BUCKET_LIMITS) {
+            bucket_limits.push_back(Ticks<std::chrono::milliseconds>(limit));
+        }
+        block_relay_latency.pushKV("bucket_limits_ms", std::move(bucket_limits));
+        UniValue msg_types{UniValue::VOBJ};
+        for (const auto& [msg_type, latency] : peerman_info.block_relay_latency) {
+            UniValue histogram{UniValue::VARR};
+            for (const auto count : latency.buckets) histogram.push_back(count);
+            UniValue msg_type_latency{UniValue::VOBJ};
+            msg_type_latency.pushKV("count", latency.count);
+            msg_type_latency.pushKV("histogram", std::move(histogram));
+            msg_types.pushKV(msg_type, std::move(msg_type_latency));
+        }
+        block_relay_latency.pushKV("msg_types", std::move(msg_types));
+        obj.pushKV("block_relay_latency", std::move(block_relay_latency));
     }
     if (node.connman) {
         obj.pushKV("networkactive", node.connman->GetNetworkActive());
@@ -27,6 +27,7 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validationinterface.h>
 
 #include <cstdint>
 #include <limits>
@@ -406,12 +407,54 @@ static RPCMethod getindexinfo()
     };
 }
 
+static RPCMethod getvalidationqueueinfo()
+{
+    return RPCMethod{
+        "getvalidationqueueinfo",
+        "Returns the backlog of validation notifications, both in the shared queue and in the queues of subscribers\n"
+        "that receive their notifications on a thread of their own (such as wallets, indices and ZMQ).\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "", {
+                {RPCResult::Type::NUM, "pending", "Notifications waiting in the shared queue"},
+                {RPCResult::Type::OBJ_DYN, "queues", "Subscriber queues", {
+                    {RPCResult::Type::OBJ, "name", "The name of the subscriber", {
+                        {RPCResult::Type::NUM, "pending", "Notifications waiting to be delivered, including one being delivered"},
+                        {RPCResult::Type::NUM, "delivered", "Notifications delivered so far"},
+                        {RPCResult::Type::NUM, "lag_ms", "How long ago the oldest pending notification was queued, in milliseconds (0 if none is pending)"},
+                    }},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getvalidationqueueinfo", "")
+          + HelpExampleRpc("getvalidationqueueinfo", "")
+        },
+        [](const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+    ValidationSignals& signals{*CHECK_NONFATAL(EnsureAnyNodeContext(request.context).validation_signals)};
+    UniValue queues_json(UniValue::VOBJ);
+    for (const auto& queue : signals.GetQueueInfo()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("pending", queue.pending);
+        entry.pushKV("delivered", queue.delivered);
+        entry.pushKV("lag_ms", queue.lag.value_or(0ms).count());
+        queues_json.pushKV(queue.name, std::move(entry));
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("pending", signals.SharedCallbacksPending());
+    result.pushKV("queues", std::move(queues_json));
+    return result;
+},
+    };
+}
+
 void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
         {"control", &logging},
         {"util", &getindexinfo},
+        {"util", &getvalidationqueueinfo},
         {"hidden", &setmocktime},
         {"hidden", &mockscheduler},
         {"hidden", &echo},
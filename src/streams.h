@@ -16,6 +16,7 @@
 #include <util/syserror.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -676,6 +677,16 @@ public:
         }
     }
 
+    void ignore(size_t num_bytes)
+    {
+        std::array<std::byte, 4096> sink;
+        while (num_bytes > 0) {
+            const size_t now{std::min(num_bytes, sink.size())};
+            read(std::span{sink}.first(now));
+            num_bytes -= now;
+        }
+    }
+
     template <typename T>
     BufferedReader& operator>>(T&& obj)
     {
@@ -226,6 +226,24 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, TestChain100Setup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_parallel_sync, TestChain100Setup)
+{
+    // Filters prepared on worker threads are chained to the same headers as those computed on the sync thread.
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1_MiB, true);
+    filter_index.SetSyncWorkers(3);
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.Sync();
+    BOOST_CHECK(filter_index.BlockUntilSyncedToCurrentChain());
+
+    uint256 last_header;
+    LOCK(cs_main);
+    const CChain& chain{m_node.chainman->ActiveChain()};
+    for (const CBlockIndex* block_index = chain.Genesis(); block_index; block_index = chain.Next(*block_index)) {
+        CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+    }
+    BOOST_CHECK_EQUAL(filter_index.GetSummary().best_block_height, chain.Height());
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <arith_uint256.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
@@ -9,8 +10,11 @@
 #include <node/context.h>
 #include <node/kernel_notifications.h>
 #include <script/solver.h>
+#include <pow.h>
 #include <primitives/block.h>
 #include <util/chaintype.h>
+#include <util/hasher.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -302,6 +306,249 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_read_mapped_block_file)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .use_xor = true,
+        .fast_prune = true,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    auto blockman{std::make_unique<BlockManager>(*Assert(m_node.shutdown_signal), blockman_opts)};
+
+    // Write blocks of about 10 kB into 64 kiB block files, so that earlier files are finalized and read through a
+    // memory map, while the last one is still read from the file.
+    std::vector<std::pair<FlatFilePos, DataStream>> blocks;
+    LOCK(::cs_main);
+    for (int i{0}; i < 20; ++i) {
+        CMutableTransaction tx;
+        tx.vout.emplace_back(i, CScript() << OP_RETURN << m_rng.randbytes(10'000));
+        CBlock block;
+        block.nVersion = i;
+        block.vtx.push_back(MakeTransactionRef(tx));
+        blocks.emplace_back(blockman->WriteBlock(block, /*nHeight=*/i), DataStream{});
+        blocks.back().second << TX_WITH_WITNESS(block);
+    }
+    BOOST_REQUIRE_GT(blocks.back().first.nFile, 1);
+
+    const auto check_reads{[&](const BlockManager& blockman) {
+        for (const auto& [pos, expected] : blocks) {
+            const auto block{blockman.ReadRawBlock(pos)};
+            BOOST_REQUIRE(block);
+            BOOST_CHECK(std::ranges::equal(*block, expected));
+
+            const auto network_block{blockman.ReadRawBlockForNetwork(pos)};
+            BOOST_REQUIRE(network_block);
+            BOOST_CHECK(std::ranges::equal(std::as_bytes(std::span{*network_block}), expected));
+
+            const auto part{blockman.ReadRawBlock(pos, std::pair{size_t{100}, size_t{50}})};
+            BOOST_REQUIRE(part);
+            BOOST_CHECK(std::ranges::equal(*part, std::span{expected}.subspan(100, 50)));
+            BOOST_CHECK(blockman.ReadRawBlock(pos, std::pair{expected.size() - 1, size_t{2}}).error() == node::ReadRawError::BadPartRange);
+        }
+
+        // Reading past the end of a finalized file fails without crashing.
+        const FlatFilePos past_end{blocks.front().first.nFile, MAX_BLOCKFILE_SIZE};
+        BOOST_CHECK(!blockman.ReadRawBlock(past_end));
+    }};
+    check_reads(*blockman);
+
+    // With memory maps disabled, finalized files are read from the file and give the same results.
+    blockman.reset();
+    blockman_opts.use_mmap = false;
+    blockman = std::make_unique<BlockManager>(*Assert(m_node.shutdown_signal), blockman_opts);
+    check_reads(*blockman);
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_load_block_index_parallel)
+{
+    const auto params{CreateChainParams(ArgsManager{}, ChainType::REGTEST)};
+    const auto& consensus{params->GetConsensus()};
+    kernel::BlockTreeDB block_tree_db{DBParams{.path = "", .cache_bytes = 1_MiB, .memory_only = true}};
+
+    // Write a chain of headers that spans all partitions of the key space.
+    constexpr int NUM_BLOCKS{1'000};
+    std::vector<uint256> hashes(NUM_BLOCKS);
+    std::vector<std::unique_ptr<CBlockIndex>> chain;
+    for (int i{0}; i < NUM_BLOCKS; ++i) {
+        CBlockHeader header;
+        header.hashPrevBlock = i > 0 ? hashes[i - 1] : uint256{};
+        header.nTime = i;
+        header.nBits = params->GenesisBlock().nBits;
+        while (!CheckProofOfWork(header.GetHash(), header.nBits, consensus)) ++header.nNonce;
+        hashes[i] = header.GetHash();
+        auto& index{*chain.emplace_back(std::make_unique<CBlockIndex>(header))};
+        index.phashBlock = &hashes[i];
+        index.pprev = i > 0 ? chain[i - 1].get() : nullptr;
+        index.nHeight = i;
+        index.nTx = 1 + i % 3;
+        index.nStatus = BLOCK_VALID_TREE;
+    }
+    const auto write{[&](const std::vector<std::unique_ptr<CBlockIndex>>& blocks) {
+        std::vector<const CBlockIndex*> block_info;
+        for (const auto& block : blocks) block_info.push_back(block.get());
+        block_tree_db.WriteBatchSync({}, 0, block_info);
+    }};
+    write(chain);
+
+    using BlockMap = std::unordered_map<uint256, CBlockIndex, BlockHasher>;
+    const auto load{[&](BlockMap& block_map, ThreadPool* thread_pool) {
+        const auto insert{[&](const uint256& hash) -> CBlockIndex* {
+            if (hash.IsNull()) return nullptr;
+            const auto [it, inserted]{block_map.try_emplace(hash)};
+            it->second.phashBlock = &it->first;
+            return &it->second;
+        }};
+        return WITH_LOCK(::cs_main, return block_tree_db.LoadBlockIndexGuts(consensus, insert, *Assert(m_node.shutdown_signal), thread_pool));
+    }};
+
+    ThreadPool thread_pool{"blockindex"};
+    thread_pool.Start(3);
+    BlockMap serial, parallel;
+    BOOST_REQUIRE(load(serial, nullptr));
+    BOOST_REQUIRE(load(parallel, &thread_pool));
+    BOOST_CHECK_EQUAL(serial.size(), size_t{NUM_BLOCKS});
+    BOOST_CHECK_EQUAL(parallel.size(), size_t{NUM_BLOCKS});
+    for (const auto& index : chain) {
+        for (const BlockMap* block_map : {&serial, &parallel}) {
+            const auto it{block_map->find(index->GetBlockHash())};
+            BOOST_REQUIRE(it != block_map->end());
+            BOOST_CHECK_EQUAL(it->second.nHeight, index->nHeight);
+            BOOST_CHECK_EQUAL(it->second.nTx, index->nTx);
+            BOOST_CHECK_EQUAL(it->second.nNonce, index->nNonce);
+            BOOST_CHECK_EQUAL(it->second.pprev ? it->second.pprev->GetBlockHash() : uint256{}, index->pprev ? index->pprev->GetBlockHash() : uint256{});
+        }
+    }
+
+    // An entry with invalid proof of work fails the load in both modes.
+    std::vector<std::unique_ptr<CBlockIndex>> invalid;
+    CBlockHeader header;
+    header.nBits = params->GenesisBlock().nBits;
+    while (CheckProofOfWork(header.GetHash(), header.nBits, consensus)) ++header.nNonce;
+    const uint256 invalid_hash{header.GetHash()};
+    invalid.emplace_back(std::make_unique<CBlockIndex>(header))->phashBlock = &invalid_hash;
+    write(invalid);
+    BlockMap failed_serial, failed_parallel;
+    BOOST_CHECK(!load(failed_serial, nullptr));
+    BOOST_CHECK(!load(failed_parallel, &thread_pool));
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_block_index_snapshot)
+{
+    const auto params{CreateChainParams(ArgsManager{}, ChainType::REGTEST)};
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    const BlockManager::Options blockman_opts{
+        .chainparams = *params,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    const fs::path snapshot_path{m_args.GetDataDirNet() / "blocks" / "index.snapshot"};
+    LOCK(::cs_main);
+
+    // Add headers to the block index and flush them to the block tree database.
+    std::vector<std::pair<uint256, arith_uint256>> expected;
+    const auto add_headers{[&](BlockManager& blockman, int count) {
+        CBlockIndex* best_header{nullptr};
+        for (int i{0}; i < count; ++i) {
+            CBlockHeader header;
+            header.hashPrevBlock = expected.empty() ? uint256{} : expected.back().first;
+            header.nTime = expected.size();
+            header.nBits = params->GenesisBlock().nBits;
+            while (!CheckProofOfWork(header.GetHash(), header.nBits, params->GetConsensus())) ++header.nNonce;
+            const CBlockIndex* index{blockman.AddToBlockIndex(header, best_header)};
+            expected.emplace_back(index->GetBlockHash(), index->nChainWork);
+        }
+        blockman.WriteBlockIndexDB();
+    }};
+    const auto check_index{[&](BlockManager& blockman) {
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), expected.size());
+        for (size_t height{0}; height < expected.size(); ++height) {
+            const CBlockIndex* index{blockman.LookupBlockIndex(expected[height].first)};
+            BOOST_REQUIRE(index);
+            BOOST_CHECK_EQUAL(index->nHeight, int(height));
+            BOOST_CHECK(index->nChainWork == expected[height].second);
+            BOOST_CHECK_EQUAL(index->pprev ? index->pprev->GetBlockHash() : uint256{}, height > 0 ? expected[height - 1].first : uint256{});
+            BOOST_CHECK(height < 2 || index->pskip);
+        }
+    }};
+
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        BOOST_REQUIRE(blockman.LoadBlockIndexDB({}));
+        add_headers(blockman, 50);
+        blockman.WriteBlockIndexSnapshot();
+        BOOST_CHECK(fs::exists(snapshot_path));
+    }
+    {
+        // The snapshot is used while the database has not changed.
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        {
+            ASSERT_DEBUG_LOG("Loaded 50 block index entries from snapshot");
+            BOOST_REQUIRE(blockman.LoadBlockIndexDB({}));
+        }
+        check_index(blockman);
+        BOOST_CHECK(blockman.m_block_tree_db->ReadBlockIndexSnapshotToken());
+
+        // Writing to the database invalidates it.
+        add_headers(blockman, 10);
+        BOOST_CHECK(!blockman.m_block_tree_db->ReadBlockIndexSnapshotToken());
+    }
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        BOOST_REQUIRE(blockman.LoadBlockIndexDB({}));
+        check_index(blockman);
+        blockman.WriteBlockIndexSnapshot();
+
+        // An older version changing a block index entry rewrites the last block file number without the token.
+        int last_file;
+        BOOST_REQUIRE(blockman.m_block_tree_db->ReadLastBlockFile(last_file));
+        BOOST_REQUIRE(blockman.m_block_tree_db->ReadBlockIndexSnapshotToken());
+        CDiskBlockIndex changed{blockman.LookupBlockIndex(expected.back().first)};
+        changed.nStatus |= BLOCK_OPT_WITNESS;
+        CDBBatch batch{*blockman.m_block_tree_db};
+        batch.Write(std::make_pair(uint8_t{'b'}, expected.back().first), changed);
+        batch.Write(uint8_t{'l'}, last_file);
+        blockman.m_block_tree_db->WriteBatch(batch, /*fSync=*/true);
+        BOOST_CHECK(!blockman.m_block_tree_db->ReadBlockIndexSnapshotToken());
+    }
+    {
+        // The stale snapshot is not used, and the change is loaded from the database.
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        BOOST_REQUIRE(blockman.LoadBlockIndexDB({}));
+        check_index(blockman);
+        BOOST_CHECK(blockman.LookupBlockIndex(expected.back().first)->nStatus & BLOCK_OPT_WITNESS);
+        blockman.WriteBlockIndexSnapshot();
+    }
+
+    // A corrupted snapshot is detected, and the block index is loaded from the database instead.
+    {
+        std::vector<std::byte> data(fs::file_size(snapshot_path));
+        AutoFile{fsbridge::fopen(snapshot_path, "rb")}.read(data);
+        data[data.size() / 2] ^= std::byte{1};
+        AutoFile file{fsbridge::fopen(snapshot_path, "wb")};
+        file.write(data);
+        BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+    }
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        {
+            ASSERT_DEBUG_LOG("is corrupted");
+            BOOST_REQUIRE(blockman.LoadBlockIndexDB({}));
+        }
+        check_index(blockman);
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(prune_lock_update_and_delete, TestingSetup)
 {
     LOCK(::cs_main);
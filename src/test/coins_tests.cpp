@@ -1044,6 +1044,30 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(coins_db_partial_batches, FlushTest)
+{
+    // Force many small batches, so that partial batches are written in the background while others are filled.
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 8_MiB, .memory_only = true}, {.batch_write_bytes = 1024}};
+    std::vector<std::pair<COutPoint, Coin>> coins;
+    for (uint256 block_hash : {m_rng.rand256(), m_rng.rand256()}) {
+        CCoinsViewCache cache{&base};
+        // Spend the coins added by the previous round, and add new ones.
+        for (const auto& [outpoint, coin] : coins) BOOST_CHECK(cache.SpendCoin(outpoint));
+        const auto spent{std::exchange(coins, {})};
+        for (int i{0}; i < 1000; ++i) {
+            coins.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), m_rng.rand32()}, MakeCoin());
+            cache.AddCoin(coins.back().first, Coin{coins.back().second}, /*possible_overwrite=*/false);
+        }
+        cache.SetBestBlock(block_hash);
+        cache.Sync();
+
+        BOOST_CHECK_EQUAL(base.GetBestBlock(), block_hash);
+        BOOST_CHECK(base.GetHeadBlocks().empty());
+        for (const auto& [outpoint, coin] : spent) BOOST_CHECK(!base.HaveCoin(outpoint));
+        for (const auto& [outpoint, coin] : coins) BOOST_CHECK_EQUAL(*Assert(base.GetCoin(outpoint)), coin);
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(coins_db_leveldb_layout, FlushTest)
 {
     auto level2_files{[](CCoinsViewDB& base) {
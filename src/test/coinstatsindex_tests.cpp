@@ -11,6 +11,7 @@
 #include <primitives/transaction.h>
 #include <script/script.h>
 #include <sync.h>
+#include <txdb.h>
 #include <test/util/setup_common.h>
 #include <util/check.h>
 #include <validation.h>
@@ -19,6 +20,7 @@
 
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <span>
 #include <vector>
 
@@ -75,4 +77,44 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_initial_sync, TestChain100Setup)
     coin_stats_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(coinstats_parallel_scan, TestChain100Setup)
+{
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    WITH_LOCK(cs_main, chainstate.ForceFlushStateToDisk(/*wipe_cache=*/false));
+    const CCoinsViewDB& coins_db{WITH_LOCK(cs_main, return chainstate.CoinsDB())};
+
+    // The partitions cover every coin exactly once, in key order.
+    std::vector<COutPoint> all_coins, partitioned_coins;
+    COutPoint key;
+    for (auto cursor{WITH_LOCK(cs_main, return coins_db.Cursor())}; cursor->Valid(); cursor->Next()) {
+        BOOST_REQUIRE(cursor->GetKey(key));
+        all_coins.push_back(key);
+    }
+    for (const auto& cursor : WITH_LOCK(cs_main, return coins_db.PartitionedCursors(UTXO_SCAN_PARTITIONS))) {
+        for (; cursor->Valid(); cursor->Next()) {
+            BOOST_REQUIRE(cursor->GetKey(key));
+            partitioned_coins.push_back(key);
+        }
+    }
+    BOOST_CHECK(partitioned_coins == all_coins);
+
+    for (const auto hash_type : {kernel::CoinStatsHashType::HASH_SERIALIZED, kernel::CoinStatsHashType::MUHASH, kernel::CoinStatsHashType::NONE}) {
+        const auto serial{kernel::ComputeUTXOStats(hash_type, coins_db, m_node.chainman->m_blockman)};
+        const auto parallel{kernel::ComputeUTXOStats(hash_type, coins_db, m_node.chainman->m_blockman, {}, /*scan_threads=*/3)};
+        BOOST_REQUIRE(serial && parallel);
+        BOOST_CHECK(serial->hashSerialized == parallel->hashSerialized);
+        BOOST_CHECK_EQUAL(serial->coins_count, all_coins.size());
+        BOOST_CHECK_EQUAL(serial->coins_count, parallel->coins_count);
+        BOOST_CHECK_EQUAL(serial->nTransactions, parallel->nTransactions);
+        BOOST_CHECK_EQUAL(serial->nTransactionOutputs, parallel->nTransactionOutputs);
+        BOOST_CHECK_EQUAL(serial->nBogoSize, parallel->nBogoSize);
+        BOOST_CHECK(serial->total_amount == parallel->total_amount);
+    }
+
+    // Interrupting the scan from a worker stops it and surfaces the exception.
+    BOOST_CHECK_THROW(kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, coins_db, m_node.chainman->m_blockman,
+                                               [] { throw std::runtime_error{"interrupted"}; }, /*scan_threads=*/2),
+                      std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -270,10 +270,53 @@ BOOST_AUTO_TEST_CASE(fetch_state_is_reusable_after_teardown)
     }
 }
 
+// Test that PrefetchCoins adds exactly the unspent, not yet cached outpoints to the cache without marking them dirty.
+BOOST_AUTO_TEST_CASE(prefetch_coins_into_cache)
+{
+    const auto block{CreateBlock()};
+    CCoinsViewDB db{{.path = "", .cache_bytes = 1_MiB, .memory_only = true}, {}};
+    PopulateView(block, db);
+    CCoinsViewCache cache{&db};
+
+    std::vector<COutPoint> outpoints;
+    for (const auto& tx : block.vtx | std::views::drop(1)) {
+        for (const auto& in : tx->vin) outpoints.push_back(in.prevout);
+    }
+    // Cache one outpoint up front and request another one twice; neither must be reported as added.
+    BOOST_REQUIRE(cache.HaveCoin(outpoints.front()));
+    outpoints.push_back(outpoints.back());
+
+    const auto thread_pool{MakeStartedThreadPool()};
+    const auto added{cache.PrefetchCoins(outpoints, *thread_pool)};
+    BOOST_CHECK_EQUAL(cache.GetDirtyCount(), 0U);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), added.size() + 1);
+    for (const auto& outpoint : added) {
+        BOOST_CHECK(outpoint != outpoints.front());
+        BOOST_CHECK(cache.HaveCoinInCache(outpoint));
+    }
+    CheckCache(block, cache);
+
+    // Nothing is left to fetch on a second call.
+    BOOST_CHECK(cache.PrefetchCoins(outpoints, *thread_pool).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(coinsviewoverlay_tests_noworkers)
 
+// Test that PrefetchCoins is a no-op without workers.
+BOOST_AUTO_TEST_CASE(prefetch_coins_unstarted_thread_pool)
+{
+    const auto block{CreateBlock()};
+    CCoinsViewDB db{{.path = "", .cache_bytes = 1_MiB, .memory_only = true}, {}};
+    PopulateView(block, db);
+    CCoinsViewCache cache{&db};
+    const std::vector<COutPoint> outpoints{block.vtx[1]->vin[0].prevout, block.vtx[2]->vin[0].prevout};
+    ThreadPool thread_pool{"fetch_none"};
+    BOOST_CHECK(cache.PrefetchCoins(outpoints, thread_pool).empty());
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+}
+
 // Test that disabled input fetching falls back to normal cache lookups via base->PeekCoin.
 BOOST_AUTO_TEST_CASE(fetch_unstarted_thread_pool)
 {
@@ -23,6 +23,8 @@
 #include <util/strencodings.h>
 
 #include <algorithm>
+#include <limits>
+#include <string>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -849,6 +851,32 @@ BOOST_AUTO_TEST_CASE(chacha20_midblock)
     BOOST_CHECK(std::ranges::equal(std::span{block}.last(52), b3));
 }
 
+BOOST_AUTO_TEST_CASE(chacha20_multiblock)
+{
+    // Messages of many blocks go through the vectorized implementation (where available), single blocks do not.
+    // Start close to 2^32 blocks too, so that the counter carries in the middle of a vectorized batch.
+    const auto key{m_rng.randbytes<std::byte>(32)};
+    const auto in{m_rng.randbytes<std::byte>(100 * ChaCha20Aligned::BLOCKLEN + 7)};
+    for (const uint32_t counter : {0U, 3U, 0xffffffffU - 40, 0xffffffffU - 5}) {
+        const ChaCha20::Nonce96 nonce{m_rng.rand32(), m_rng.rand64()};
+        std::vector<std::byte> expected(in.size()), out(in.size()), keystream(in.size());
+        ChaCha20 c20{key};
+        c20.Seek(nonce, counter);
+        for (size_t pos = 0; pos < in.size(); pos += ChaCha20Aligned::BLOCKLEN) {
+            const size_t len{std::min<size_t>(ChaCha20Aligned::BLOCKLEN, in.size() - pos)};
+            c20.Crypt(std::span{in}.subspan(pos, len), std::span{expected}.subspan(pos, len));
+        }
+        for (const size_t len : {size_t{0}, size_t{64 * 8}, size_t{64 * 16 + 1}, size_t{64 * 33}, in.size()}) {
+            c20.Seek(nonce, counter);
+            c20.Crypt(std::span{in}.first(len), std::span{out}.first(len));
+            BOOST_CHECK(std::ranges::equal(std::span{out}.first(len), std::span{expected}.first(len)));
+            c20.Seek(nonce, counter);
+            c20.Keystream(std::span{keystream}.first(len));
+            for (size_t i = 0; i < len; ++i) BOOST_CHECK(keystream[i] == (in[i] ^ expected[i]));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(poly1305_testvector)
 {
     // RFC 7539, section 2.5.2.
@@ -970,6 +998,42 @@ BOOST_AUTO_TEST_CASE(poly1305_testvector)
                  "0e410fa9d7a40ac582e77546be9a72bb");
 }
 
+BOOST_AUTO_TEST_CASE(poly1305_multiblock)
+{
+    // Long updates are processed several blocks at a time (where supported), block-sized ones are not. Messages of all
+    // ones maximize the limbs that the two need to agree on.
+    for (const bool all_ones : {false, true}) {
+        const auto key{all_ones ? std::vector<std::byte>(Poly1305::KEYLEN, std::byte{0xff}) : m_rng.randbytes<std::byte>(Poly1305::KEYLEN)};
+        const auto msg{all_ones ? std::vector<std::byte>(5000, std::byte{0xff}) : m_rng.randbytes<std::byte>(5000)};
+        for (const size_t len : {0, 15, 64, 255, 256, 257, 1000, 4096, 5000}) {
+            Poly1305 blockwise{key};
+            for (size_t pos = 0; pos < len; pos += POLY1305_BLOCK_SIZE) {
+                blockwise.Update(std::span{msg}.subspan(pos, std::min<size_t>(POLY1305_BLOCK_SIZE, len - pos)));
+            }
+            std::byte expected[Poly1305::TAGLEN], tag[Poly1305::TAGLEN];
+            blockwise.Finalize(expected);
+            Poly1305{key}.Update(std::span{msg}.first(len)).Finalize(tag);
+            BOOST_CHECK(std::ranges::equal(tag, expected));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chacha20poly1305_failed_decrypt)
+{
+    // A forged message must not be decrypted, even though decryption and authentication happen in the same pass.
+    const auto key{m_rng.randbytes<std::byte>(AEADChaCha20Poly1305::KEYLEN)};
+    const auto plain{m_rng.randbytes<std::byte>(10000)};
+    AEADChaCha20Poly1305 aead{key};
+    std::vector<std::byte> cipher(plain.size() + AEADChaCha20Poly1305::EXPANSION), decrypted(plain.size());
+    aead.Encrypt(plain, {}, {1, 2}, cipher);
+    BOOST_CHECK(aead.Decrypt(cipher, {}, {1, 2}, decrypted));
+    BOOST_CHECK(decrypted == plain);
+
+    cipher[m_rng.randrange(plain.size())] ^= std::byte{1};
+    BOOST_CHECK(!aead.Decrypt(cipher, {}, {1, 2}, std::span{decrypted}.first(3000), std::span{decrypted}.subspan(3000)));
+    BOOST_CHECK(std::ranges::all_of(decrypted, [](std::byte b) { return b == std::byte{0}; }));
+}
+
 BOOST_AUTO_TEST_CASE(chacha20poly1305_testvectors)
 {
     // Note that in our implementation, the authentication is suffixed to the ciphertext.
@@ -1087,6 +1151,34 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d_multi)
+{
+    // Lengths around the padding and chunk boundaries, and random ones, so that lanes finish at different times.
+    std::vector<std::vector<unsigned char>> messages;
+    for (size_t len : {0, 1, 32, 55, 56, 63, 64, 65, 119, 120, 128, 1000, 5000}) {
+        messages.push_back(m_rng.randbytes(len));
+    }
+    for (int i = 0; i < 40; ++i) {
+        messages.push_back(m_rng.randbytes(m_rng.randrange(300)));
+    }
+    std::shuffle(messages.begin(), messages.end(), m_rng);
+    const std::vector<std::span<const unsigned char>> inputs(messages.begin(), messages.end());
+
+    std::vector<unsigned char> expected(inputs.size() * 32);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        CHash256().Write(inputs[i]).Finalize(std::span{expected}.subspan(32 * i, 32));
+    }
+    for (const auto use_implementation : {sha256_implementation::STANDARD, sha256_implementation::USE_SSE4, sha256_implementation::USE_SSE4_AND_AVX2}) {
+        BOOST_TEST_MESSAGE("Using the '" << SHA256AutoDetect(use_implementation) << "' SHA256 implementation");
+        for (size_t count = 0; count <= inputs.size(); ++count) {
+            std::vector<unsigned char> out(count * 32);
+            SHA256DMulti(out.data(), std::span{inputs}.first(count));
+            BOOST_CHECK(std::equal(out.begin(), out.end(), expected.begin()));
+        }
+    }
+    SHA256AutoDetect();
+}
+
 void CryptoTest::TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
@@ -1281,4 +1373,75 @@ BOOST_AUTO_TEST_CASE(muhash_tests)
     BOOST_CHECK_EQUAL(HexStr(out4), "3a31e6903aff0de9f62f9a9f7f8b861de76ce2cda09822b90014319ae5dc2271");
 }
 
+static std::string Num3072Digest(Num3072 x)
+{
+    unsigned char data[Num3072::BYTE_SIZE];
+    x.ToBytes(data);
+    unsigned char digest[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(data, sizeof(data)).Finalize(digest);
+    return HexStr(digest);
+}
+
+BOOST_AUTO_TEST_CASE(num3072_multiply)
+{
+    // Expected results were computed with arbitrary precision integers, modulo 2^3072 - 1103717. They are the same
+    // whichever multiplication the CPU selects.
+    unsigned char a_data[Num3072::BYTE_SIZE], b_data[Num3072::BYTE_SIZE], ones_data[Num3072::BYTE_SIZE];
+    for (size_t i = 0; i < Num3072::BYTE_SIZE; ++i) {
+        a_data[i] = i * 7 + 3;
+        b_data[i] = i * 13 + 5;
+        ones_data[i] = 0xff;
+    }
+    const Num3072 a{a_data}, b{b_data}, ones{ones_data};
+
+    Num3072 x{a};
+    x.Multiply(b);
+    BOOST_CHECK_EQUAL(Num3072Digest(x), "3303f1f7cf0020122d5af75f367bc76b256a14977353d99e1bb0b1a0457be103");
+
+    // 2^3072 - 1 is not reduced, and its square is the small number 0x11ba1b91f10.
+    unsigned char small_data[Num3072::BYTE_SIZE]{0x10, 0x1f, 0xb9, 0xa1, 0x1b, 0x01};
+    x = ones;
+    x.Multiply(ones);
+    BOOST_CHECK(std::ranges::equal(x.limbs, Num3072{small_data}.limbs));
+
+    // (modulus - 1)^2 = 1
+    Num3072 minus_one{ones};
+    minus_one.limbs[0] -= 1103717;
+    x = minus_one;
+    x.Multiply(minus_one);
+    BOOST_CHECK(std::ranges::equal(x.limbs, Num3072{}.limbs));
+
+    x = a;
+    for (int i = 0; i < 100; ++i) x.Multiply(x);
+    BOOST_CHECK_EQUAL(Num3072Digest(x), "cefd5a1265f368ef34f709ba9b5194f91756a5ac5469ceb680d8c9c148e86e94");
+}
+
+BOOST_AUTO_TEST_CASE(num3072_multiply_implementations)
+{
+    // Compare the accelerated multiplication (if the CPU has one) against the generic one over random inputs,
+    // including unreduced ones with every limb saturated.
+    const std::string accelerated{MuHashSelectImplementation(true)};
+    BOOST_TEST_MESSAGE("Comparing Num3072 multiplication: " << accelerated << " vs standard");
+    for (int i = 0; i < 1000; ++i) {
+        unsigned char a_data[Num3072::BYTE_SIZE], b_data[Num3072::BYTE_SIZE];
+        m_rng.fillrand(MakeWritableByteSpan(a_data));
+        m_rng.fillrand(MakeWritableByteSpan(b_data));
+        Num3072 a{a_data}, b{b_data};
+        for (auto* num : {&a, &b}) {
+            if (m_rng.randbool()) continue;
+            for (auto& limb : num->limbs) {
+                if (m_rng.randbits(2) == 0) limb = std::numeric_limits<Num3072::limb_t>::max();
+            }
+        }
+
+        MuHashSelectImplementation(false);
+        Num3072 expected{a};
+        expected.Multiply(b);
+        MuHashSelectImplementation(true);
+        Num3072 actual{a};
+        actual.Multiply(b);
+        BOOST_CHECK(std::ranges::equal(actual.limbs, expected.limbs));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
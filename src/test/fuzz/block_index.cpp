@@ -22,17 +22,6 @@ const BasicTestingSetup* g_setup;
 // Hardcoded block hash and nBits to make sure the blocks we store pass the pow check.
 uint256 g_block_hash;
 
-bool operator==(const CBlockFileInfo& a, const CBlockFileInfo& b)
-{
-    return a.nBlocks == b.nBlocks &&
-        a.nSize == b.nSize &&
-        a.nUndoSize == b.nUndoSize &&
-        a.nHeightFirst == b.nHeightFirst &&
-        a.nHeightLast == b.nHeightLast &&
-        a.nTimeFirst == b.nTimeFirst &&
-        a.nTimeLast == b.nTimeLast;
-}
-
 CBlockHeader ConsumeBlockHeader(FuzzedDataProvider& provider)
 {
     CBlockHeader header;
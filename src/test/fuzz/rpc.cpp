@@ -153,6 +153,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "gettxout",
     "gettxoutsetinfo",
     "gettxspendingprevout",
+    "getvalidationqueueinfo",
     "help",
     "invalidateblock",
     "joinpsbts",
@@ -154,6 +154,8 @@ public:
 
     virtual bool ProcessMessages(CNode&, std::atomic<bool>&) override { return m_fdp.ConsumeBool(); }
 
+    virtual bool ProcessBlockRelayMessage(CNode&, std::atomic<bool>&) override { return m_fdp.ConsumeBool(); }
+
     virtual bool SendMessages(CNode&) override { return m_fdp.ConsumeBool(); }
 
 private:
@@ -4,6 +4,7 @@
 
 #include <addrman.h>
 #include <bip324.h>
+#include <blockencodings.h>
 #include <chainparams.h>
 #include <clientversion.h>
 #include <common/args.h>
@@ -14,9 +15,11 @@
 #include <netbase.h>
 #include <netmessagemaker.h>
 #include <node/protocol_version.h>
+#include <primitives/block.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <sync.h>
 #include <test/util/common.h>
 #include <test/util/net.h>
 #include <test/util/random.h>
@@ -31,9 +34,13 @@
 #include <algorithm>
 #include <cstdint>
 #include <ios>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace std::literals;
 using namespace util::hex_literals;
@@ -140,6 +147,131 @@ BOOST_AUTO_TEST_CASE(cnode_simple_test)
     BOOST_CHECK_EQUAL(pnode4->ConnectedThroughNetwork(), Network::NET_ONION);
 }
 
+BOOST_AUTO_TEST_CASE(cnode_block_relay_msgs)
+{
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+    CNode node{/*id=*/0,
+               /*sock=*/nullptr,
+               CAddress{},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               CAddress{},
+               /*addrNameIn=*/"",
+               ConnectionType::INBOUND,
+               /*inbound_onion=*/false,
+               /*network_key=*/0};
+    BOOST_CHECK(!node.HasBlockRelayMsgsToProcess());
+
+    // Before the handshake, block relay messages are processed in order with the other messages.
+    BOOST_CHECK(connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::PING, uint64_t{1})));
+    BOOST_CHECK(connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::HEADERS, std::vector<CBlockHeader>{})));
+    BOOST_CHECK(!node.HasBlockRelayMsgsToProcess());
+    BOOST_CHECK(!node.PollBlockRelayMessage());
+    BOOST_CHECK_EQUAL(node.PollMessage()->first.m_type, NetMsgType::PING);
+    BOOST_CHECK_EQUAL(node.PollMessage()->first.m_type, NetMsgType::HEADERS);
+
+    // Afterwards, they go to a queue of their own, ahead of the messages received before them.
+    node.fSuccessfullyConnected = true;
+    BOOST_CHECK(connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::PING, uint64_t{2})));
+    BOOST_CHECK(!node.HasBlockRelayMsgsToProcess());
+    BOOST_CHECK(connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::HEADERS, std::vector<CBlockHeader>{})));
+    BOOST_CHECK(connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::CMPCTBLOCK, CBlockHeaderAndShortTxIDs{})));
+    BOOST_CHECK(node.HasBlockRelayMsgsToProcess());
+    const auto headers{node.PollBlockRelayMessage()};
+    BOOST_CHECK_EQUAL(headers->first.m_type, NetMsgType::HEADERS);
+    BOOST_CHECK(headers->second);
+    const auto cmpctblock{node.PollBlockRelayMessage()};
+    BOOST_CHECK_EQUAL(cmpctblock->first.m_type, NetMsgType::CMPCTBLOCK);
+    BOOST_CHECK(!cmpctblock->second);
+    BOOST_CHECK(!node.HasBlockRelayMsgsToProcess());
+    const auto ping{node.PollMessage()};
+    BOOST_CHECK_EQUAL(ping->first.m_type, NetMsgType::PING);
+    BOOST_CHECK(!ping->second);
+
+    BOOST_CHECK(IsBlockRelayMsgType(NetMsgType::CMPCTBLOCK));
+    BOOST_CHECK(IsBlockRelayMsgType(NetMsgType::BLOCKTXN));
+    BOOST_CHECK(!IsBlockRelayMsgType(NetMsgType::TX));
+    BOOST_CHECK(!IsBlockRelayMsgType(NetMsgType::BLOCK));
+}
+
+BOOST_AUTO_TEST_CASE(cnode_io_threads)
+{
+    // Mocked socket that records the threads that receive from it.
+    class RecordingSock : public ZeroSock
+    {
+    public:
+        ssize_t Recv(void*, size_t, int) const override
+        {
+            LOCK(m_mutex);
+            m_threads.insert(std::this_thread::get_id());
+            errno = EAGAIN;
+            return -1;
+        }
+
+        std::set<std::thread::id> Threads() const
+        {
+            LOCK(m_mutex);
+            return m_threads;
+        }
+
+    private:
+        mutable Mutex m_mutex;
+        mutable std::set<std::thread::id> m_threads GUARDED_BY(m_mutex);
+
+        RecordingSock& operator=(Sock&&) override
+        {
+            assert(false && "Move of Sock into RecordingSock not allowed.");
+            return *this;
+        }
+    };
+
+    constexpr size_t NUM_IO_THREADS{3};
+    auto connman{std::make_unique<ConnmanTestMsg>(0x1337, 0x1337, *m_node.addrman, *m_node.netgroupman, Params())};
+    CConnman::Options options;
+    options.m_net_io_threads = NUM_IO_THREADS;
+    connman->Init(options);
+
+    std::vector<std::shared_ptr<RecordingSock>> socks;
+    for (NodeId id{0}; id < 10; ++id) {
+        socks.push_back(std::make_shared<RecordingSock>());
+        connman->AddTestNode(*new CNode{id,
+                                        socks.back(),
+                                        CAddress{},
+                                        /*nKeyedNetGroupIn=*/0,
+                                        /*nLocalHostNonceIn=*/0,
+                                        CAddress{},
+                                        /*addrNameIn=*/"",
+                                        ConnectionType::INBOUND,
+                                        /*inbound_onion=*/false,
+                                        /*network_key=*/0});
+    }
+
+    // Run the socket handler of every I/O thread concurrently, as CConnman does.
+    std::vector<std::thread> threads;
+    for (size_t shard{0}; shard < NUM_IO_THREADS; ++shard) {
+        threads.emplace_back([&connman, shard] {
+            for (int i{0}; i < 3; ++i) connman->SocketHandlerPublic(shard);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // Each connection is serviced by exactly one thread, which services all connections of its shard and no others.
+    std::map<size_t, std::thread::id> thread_per_shard;
+    std::set<std::thread::id> all_threads;
+    const auto nodes{connman->TestNodes()};
+    for (size_t i{0}; i < nodes.size(); ++i) {
+        const auto node_threads{socks[i]->Threads()};
+        BOOST_REQUIRE_EQUAL(node_threads.size(), 1U);
+        const auto it{thread_per_shard.try_emplace(connman->NodeIOShardPublic(*nodes[i]), *node_threads.begin()).first};
+        BOOST_CHECK(it->second == *node_threads.begin());
+        all_threads.insert(*node_threads.begin());
+    }
+    BOOST_CHECK_EQUAL(thread_per_shard.size(), NUM_IO_THREADS);
+    BOOST_CHECK_EQUAL(all_threads.size(), NUM_IO_THREADS);
+
+    connman->ClearTestNodes();
+}
+
 BOOST_AUTO_TEST_CASE(cnetaddr_basic)
 {
     CNetAddr addr;
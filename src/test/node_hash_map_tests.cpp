@@ -0,0 +1,153 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memusage.h>
+#include <support/allocators/pool.h>
+#include <test/util/poolresourcetester.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <util/node_hash_map.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+//! Maps all keys onto few hash values, so that long probe sequences and control byte collisions are exercised.
+struct CollidingHash {
+    size_t operator()(uint64_t key) const noexcept { return key % 61 * 0x9e3779b97f4a7c15; }
+};
+
+template <typename Hash>
+using Map = NodeHashMap<uint64_t, uint64_t, Hash, std::equal_to<uint64_t>,
+                        PoolAllocator<std::pair<const uint64_t, uint64_t>, sizeof(std::pair<const uint64_t, uint64_t>)>>;
+
+template <typename Hash>
+void CheckEqual(const Map<Hash>& map, const std::unordered_map<uint64_t, uint64_t>& expected)
+{
+    BOOST_REQUIRE_EQUAL(map.size(), expected.size());
+    size_t count{0};
+    for (const auto& [key, value] : map) {
+        const auto it{expected.find(key)};
+        BOOST_REQUIRE(it != expected.end());
+        BOOST_CHECK_EQUAL(it->second, value);
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(count, expected.size());
+}
+
+template <typename Hash>
+void RandomOperations(FastRandomContext& rng, uint64_t key_range)
+{
+    typename Map<Hash>::allocator_type::ResourceType resource;
+    {
+        Map<Hash> map{0, Hash{}, std::equal_to<uint64_t>{}, &resource};
+        std::unordered_map<uint64_t, uint64_t> expected;
+        std::unordered_map<uint64_t, const uint64_t*> addresses;
+
+        for (int i{0}; i < 20'000; ++i) {
+            const uint64_t key{rng.randrange(key_range)};
+            switch (rng.randrange(6)) {
+            case 0: {
+                const auto [it, inserted]{map.try_emplace(key, i)};
+                BOOST_CHECK_EQUAL(inserted, expected.try_emplace(key, i).second);
+                BOOST_CHECK_EQUAL(it->first, key);
+                if (inserted) addresses[key] = &it->second;
+                break;
+            }
+            case 1: {
+                const auto [it, inserted]{map.emplace(key, i)};
+                BOOST_CHECK_EQUAL(inserted, expected.emplace(key, i).second);
+                BOOST_CHECK_EQUAL(it->first, key);
+                if (inserted) addresses[key] = &it->second;
+                break;
+            }
+            case 2:
+                BOOST_CHECK_EQUAL(map.erase(key), expected.erase(key));
+                addresses.erase(key);
+                break;
+            case 3:
+                if (const auto it{map.find(key)}; it != map.end()) {
+                    BOOST_CHECK(expected.contains(key));
+                    map.erase(it);
+                    expected.erase(key);
+                    addresses.erase(key);
+                } else {
+                    BOOST_CHECK(!expected.contains(key));
+                }
+                break;
+            case 4:
+                map[key] = i;
+                expected[key] = i;
+                addresses.try_emplace(key, &map.find(key)->second);
+                break;
+            case 5:
+                BOOST_CHECK_EQUAL(map.contains(key), expected.contains(key));
+                break;
+            }
+            if (i % 1000 == 0) CheckEqual(map, expected);
+        }
+        CheckEqual(map, expected);
+
+        // Elements never move, even though the table was rebuilt many times.
+        for (const auto& [key, address] : addresses) {
+            BOOST_CHECK_EQUAL(&map.find(key)->second, address);
+        }
+
+        const size_t bucket_count{map.bucket_count()};
+        map.clear();
+        BOOST_CHECK(map.empty());
+        BOOST_CHECK(map.begin() == map.end());
+        BOOST_CHECK_EQUAL(map.bucket_count(), bucket_count);
+        PoolResourceTester::CheckAllDataAccountedFor(resource);
+    }
+    PoolResourceTester::CheckAllDataAccountedFor(resource);
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(node_hash_map_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(random_operations)
+{
+    RandomOperations<std::hash<uint64_t>>(m_rng, /*key_range=*/1'000);
+    RandomOperations<std::hash<uint64_t>>(m_rng, /*key_range=*/100'000);
+    RandomOperations<CollidingHash>(m_rng, /*key_range=*/500);
+}
+
+BOOST_AUTO_TEST_CASE(reserve_and_memusage)
+{
+    Map<std::hash<uint64_t>>::allocator_type::ResourceType resource;
+    {
+        Map<std::hash<uint64_t>> map{0, std::hash<uint64_t>{}, std::equal_to<uint64_t>{}, &resource};
+        BOOST_CHECK_EQUAL(map.bucket_count(), 0U);
+        BOOST_CHECK_EQUAL(map.table_bytes(), 0U);
+        BOOST_CHECK(map.find(1) == map.end());
+
+        map.reserve(1000);
+        const size_t bucket_count{map.bucket_count()};
+        BOOST_CHECK_GE(bucket_count, 1000U);
+        const size_t usage{memusage::DynamicUsage(map)};
+        for (uint64_t i{0}; i < 1000; ++i) map[i] = i;
+        // Neither the table nor the pool had to grow.
+        BOOST_CHECK_EQUAL(map.bucket_count(), bucket_count);
+        BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), usage);
+
+        // Erasing and inserting different keys reuses the freed slots and pool memory.
+        for (uint64_t i{0}; i < 10'000; ++i) {
+            BOOST_CHECK_EQUAL(map.erase(i), 1U);
+            BOOST_CHECK(map.try_emplace(i + 1000, i).second);
+        }
+        BOOST_CHECK_EQUAL(map.size(), 1000U);
+        BOOST_CHECK_EQUAL(map.bucket_count(), bucket_count);
+        BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), usage);
+    }
+    PoolResourceTester::CheckAllDataAccountedFor(resource);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
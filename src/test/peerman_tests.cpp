@@ -6,14 +6,17 @@
 #include <chainparams.h>
 #include <consensus/params.h>
 #include <interfaces/mining.h>
+#include <net.h>
 #include <net_processing.h>
 #include <pow.h>
 #include <primitives/block.h>
 #include <protocol.h>
 #include <sync.h>
+#include <test/util/net.h>
 #include <test/util/setup_common.h>
 #include <test/util/time.h>
 #include <util/check.h>
+#include <util/time.h>
 #include <validation.h>
 #include <validationinterface.h>
 
@@ -21,6 +24,9 @@
 
 #include <cstdint>
 #include <memory>
+#include <span>
+#include <string>
+#include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(peerman_tests, RegTestingSetup)
 
@@ -88,4 +94,67 @@ BOOST_AUTO_TEST_CASE(connections_desirable_service_flags)
     BOOST_CHECK(peerman->GetDesirableServiceFlags(peer_flags) == ServiceFlags(NODE_NETWORK | NODE_WITNESS));
 }
 
+BOOST_FIXTURE_TEST_CASE(serve_blocks_in_background, TestChain100Setup)
+{
+    LOCK(NetEventsInterface::g_msgproc_mutex);
+
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+    PeerManager::Options opts;
+    opts.block_serve_threads = 2;
+    opts.deterministic_rng = true;
+    auto peerman{PeerManager::make(connman, *m_node.addrman, nullptr, *m_node.chainman, *m_node.mempool, *m_node.warnings, opts)};
+    connman.SetMsgProc(peerman.get());
+
+    CNode node{/*id=*/0,
+               /*sock=*/nullptr,
+               CAddress{},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               CAddress{},
+               /*addrNameIn=*/"",
+               ConnectionType::INBOUND,
+               /*inbound_onion=*/false,
+               /*network_key=*/0};
+    connman.Handshake(node,
+                      /*successfully_connected=*/true,
+                      /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                      /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                      /*version=*/PROTOCOL_VERSION,
+                      /*relay_txs=*/true);
+    connman.FlushSendBuffer(node);
+
+    Mutex sent_mutex;
+    std::vector<std::string> sent;
+    const auto CaptureMessageOrig{CaptureMessage};
+    CaptureMessage = [&](const CAddress&, const std::string& msg_type, std::span<const unsigned char>, bool is_incoming) {
+        if (!is_incoming) WITH_LOCK(sent_mutex, sent.push_back(msg_type));
+    };
+    connman.SetCaptureMessages(true);
+
+    // Request an unknown transaction and two blocks, followed by a ping. The blocks are sent from the block serving
+    // threads, and the notfound and the ping are only sent after them, as if they had been served on the message
+    // handler thread.
+    std::vector<CInv> invs{CInv{MSG_WTX, uint256::ONE}};
+    for (const int height : {1, 2}) {
+        invs.emplace_back(MSG_WITNESS_BLOCK, WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[height]->GetBlockHash()));
+    }
+    (void)connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::GETDATA, invs));
+    (void)connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::PING, uint64_t{42}));
+
+    const auto deadline{SteadyClock::now() + 60s};
+    while (WITH_LOCK(sent_mutex, return sent.size()) < 4) {
+        BOOST_REQUIRE(SteadyClock::now() < deadline);
+        connman.FlushSendBuffer(node);
+        node.fPauseSend = false;
+        if (!connman.ProcessMessagesOnce(node)) UninterruptibleSleep(1ms);
+    }
+    BOOST_CHECK(WITH_LOCK(sent_mutex, return sent) == (std::vector<std::string>{NetMsgType::BLOCK, NetMsgType::NOTFOUND, NetMsgType::BLOCK, NetMsgType::PONG}));
+    BOOST_CHECK(!node.fDisconnect);
+
+    peerman->FinalizeNode(node);
+    connman.SetCaptureMessages(false);
+    CaptureMessage = CaptureMessageOrig;
+    connman.SetMsgProc(m_node.peerman.get());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
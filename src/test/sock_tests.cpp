@@ -155,6 +155,69 @@ BOOST_AUTO_TEST_CASE(wait)
     waiter.join();
 }
 
+BOOST_AUTO_TEST_CASE(wait_set)
+{
+    TcpSocketPair socks_a{};
+    TcpSocketPair socks_b{};
+    std::shared_ptr<const Sock> a{std::make_shared<Sock>(std::move(socks_a.receiver))};
+    const std::shared_ptr<const Sock> b{std::make_shared<Sock>(std::move(socks_b.receiver))};
+
+    SockWaitSet wait_set;
+    Sock::EventsPerSock ready;
+    BOOST_CHECK(!wait_set.Wait(0ms, ready));
+
+    wait_set.Set(a, Sock::RecvEvent);
+    wait_set.Set(b, Sock::RecvEvent);
+    BOOST_REQUIRE(wait_set.Wait(0ms, ready));
+    BOOST_CHECK(ready.empty());
+
+    // Only the socket with data to receive is reported.
+    BOOST_REQUIRE_EQUAL(socks_a.sender.Send("a", 1, 0), 1);
+    BOOST_REQUIRE(wait_set.Wait(24h, ready));
+    BOOST_CHECK_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready.at(a).occurred == Sock::RecvEvent);
+
+    // Setting the same events again changes nothing, and readiness is reported for as long as it lasts.
+    wait_set.Set(a, Sock::RecvEvent);
+    BOOST_REQUIRE(wait_set.Wait(24h, ready));
+    BOOST_CHECK_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready.at(a).occurred == Sock::RecvEvent);
+
+    // Changes to the requested events are picked up.
+    wait_set.Set(b, Sock::RecvEvent | Sock::SendEvent);
+    BOOST_REQUIRE(wait_set.Wait(24h, ready));
+    BOOST_CHECK_EQUAL(ready.size(), 2U);
+    BOOST_CHECK(ready.at(a).occurred == Sock::RecvEvent);
+    BOOST_CHECK(ready.at(b).occurred == Sock::SendEvent);
+
+    // Sockets set to no events are no longer waited on.
+    wait_set.Set(b, 0);
+    BOOST_REQUIRE(wait_set.Wait(24h, ready));
+    BOOST_CHECK_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready.at(a).occurred == Sock::RecvEvent);
+
+    // A socket whose peer went away becomes readable.
+    char buf[1];
+    BOOST_REQUIRE_EQUAL(a->Recv(buf, sizeof(buf), 0), 1);
+    { Sock closed{std::move(socks_a.sender)}; }
+    BOOST_REQUIRE(wait_set.Wait(24h, ready));
+    BOOST_CHECK(ready.at(a).occurred & Sock::RecvEvent);
+
+    // Destroyed sockets are no longer waited on, and the set does not keep them alive.
+    ready.clear();
+    const std::weak_ptr<const Sock> weak_a{a};
+    a.reset();
+    BOOST_CHECK(weak_a.expired());
+    wait_set.Set(b, Sock::SendEvent);
+    BOOST_REQUIRE(wait_set.Wait(24h, ready));
+    BOOST_CHECK_EQUAL(ready.size(), 1U);
+    BOOST_CHECK(ready.at(b).occurred == Sock::SendEvent);
+
+    wait_set.Clear();
+    BOOST_CHECK(!wait_set.Wait(0ms, ready));
+    BOOST_CHECK(ready.empty());
+}
+
 BOOST_AUTO_TEST_CASE(recv_until_terminator_limit)
 {
     constexpr auto timeout = 1min; // High enough so that it is never hit.
@@ -786,6 +786,17 @@ BOOST_AUTO_TEST_CASE(buffered_writer_reader)
         BOOST_CHECK_EXCEPTION(f.read(excess_byte), std::ios_base::failure, HasReason{"end of file"});
     }
 
+    // Skip over values, both within and across buffer refills
+    {
+        uint32_t _v3{0};
+        AutoFile file{fsbridge::fopen(test_file, "rb")};
+        BufferedReader f(std::move(file), sizeof(v1));
+        f.ignore(sizeof(v1) + sizeof(v2));
+        f >> _v3;
+        BOOST_CHECK_EQUAL(_v3, v3);
+        BOOST_CHECK_EXCEPTION(f.ignore(1), std::ios_base::failure, HasReason{"end of file"});
+    }
+
     fs::remove(test_file);
 }
 
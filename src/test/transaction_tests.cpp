@@ -1330,4 +1330,32 @@ BOOST_AUTO_TEST_CASE(spends_witness_prog)
     }
 }
 
+BOOST_AUTO_TEST_CASE(make_transaction_refs)
+{
+    std::vector<CMutableTransaction> txs;
+    for (int i{0}; i < 30; ++i) {
+        CMutableTransaction tx;
+        tx.version = i;
+        for (int j{0}, inputs{i % 5 + 1}; j < inputs; ++j) {
+            tx.vin.emplace_back(Txid::FromUint256(m_rng.rand256()), j);
+            tx.vin.back().scriptSig << m_rng.randbytes(m_rng.randrange(100));
+            // Give every other transaction a witness, of varying size.
+            if (i % 2) tx.vin.back().scriptWitness.stack.push_back(m_rng.randbytes(m_rng.randrange(1000)));
+        }
+        tx.vout.emplace_back(i * COIN, CScript() << OP_TRUE);
+        txs.push_back(tx);
+    }
+
+    const auto batch{MakeTransactionRefs(std::vector{txs})};
+    BOOST_REQUIRE_EQUAL(batch.size(), txs.size());
+    for (size_t i{0}; i < txs.size(); ++i) {
+        const CTransaction tx{txs[i]};
+        BOOST_CHECK(*batch[i] == tx);
+        BOOST_CHECK_EQUAL(batch[i]->HasWitness(), tx.HasWitness());
+        BOOST_CHECK_EQUAL(batch[i]->GetHash(), tx.GetHash());
+        BOOST_CHECK_EQUAL(batch[i]->GetWitnessHash(), tx.GetWitnessHash());
+    }
+    BOOST_CHECK(MakeTransactionRefs({}).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -174,6 +174,33 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_parallel_sync, TestChain100Setup)
+{
+    TxIndex txindex(interfaces::MakeChain(m_node), /*n_cache_size=*/1_MiB, /*f_memory=*/true);
+    txindex.SetSyncWorkers(2);
+    BOOST_REQUIRE(txindex.Init());
+    txindex.Sync();
+
+    // Entries buffered during the sync are written by the time it finishes.
+    for (const auto& txn : m_coinbase_txns) {
+        LookupTx(txindex, txn->GetHash());
+    }
+    for (const auto& txn : Params().GenesisBlock().vtx) {
+        BOOST_CHECK(!txindex.FindTx(txn->GetHash()));
+    }
+
+    // Blocks connected afterwards are written directly and get the following sequence numbers.
+    const CBlock& block = CreateAndProcessBlock({}, GetScriptForDestination(PKHash(coinbaseKey.GetPubKey())));
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    LookupTx(txindex, block.vtx[0]->GetHash());
+    // The 100 blocks after genesis got sequence numbers 0 to 99.
+    uint256 block_hash;
+    BOOST_REQUIRE(TxIndexTest::GetDB(txindex).Read(txindex::BlockSeqKey{100}, block_hash));
+    BOOST_CHECK(block_hash == block.GetHash());
+
+    txindex.Stop();
+}
+
 BOOST_FIXTURE_TEST_CASE(txindex_collision_scan_path, TestChain100Setup)
 {
     // On-disk, so the legacy-entry probe at construction runs against a fresh
@@ -74,4 +74,45 @@ BOOST_FIXTURE_TEST_CASE(txospenderindex_initial_sync, TestChain100Setup)
     txospenderindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txospenderindex_parallel_sync, TestChain100Setup)
+{
+    // Mine blocks for coinbase maturity, then spend two coinbase outputs per block, so that the workers prepare
+    // several blocks with spends ahead of the sync thread.
+    const CScript& coinbase_script = m_coinbase_txns[0]->vout[0].scriptPubKey;
+    for (int i = 0; i < 10; i++) CreateAndProcessBlock({}, coinbase_script);
+
+    std::vector<COutPoint> spent;
+    std::vector<std::pair<Txid, uint256>> spender;
+    for (int i = 0; i < 10; i += 2) {
+        std::vector<CMutableTransaction> txs;
+        for (int j = i; j < i + 2; ++j) {
+            txs.push_back(CreateValidMempoolTransaction(m_coinbase_txns[j], /*input_vout=*/0, /*input_height=*/j + 1, coinbaseKey,
+                                                        coinbase_script, /*output_amount=*/1 * COIN, /*submit=*/false));
+            spent.emplace_back(m_coinbase_txns[j]->GetHash(), 0);
+        }
+        const uint256 block_hash{CreateAndProcessBlock(txs, coinbase_script).GetHash()};
+        for (const auto& tx : txs) spender.emplace_back(tx.GetHash(), block_hash);
+    }
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    const uint256 tip_hash{WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip()->GetBlockHash())};
+
+    TxoSpenderIndex txospenderindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    txospenderindex.SetSyncWorkers(2);
+    BOOST_REQUIRE(txospenderindex.Init());
+    txospenderindex.Sync();
+    BOOST_CHECK_EQUAL(txospenderindex.GetSummary().best_block_hash, tip_hash);
+
+    for (size_t i = 0; i < spent.size(); i++) {
+        const auto tx_spender{txospenderindex.FindSpender(spent[i])};
+        BOOST_REQUIRE(tx_spender.has_value());
+        BOOST_REQUIRE(tx_spender->has_value());
+        BOOST_CHECK_EQUAL((*tx_spender)->tx->GetHash(), spender[i].first);
+        BOOST_CHECK_EQUAL((*tx_spender)->block_hash, spender[i].second);
+    }
+    // Outputs that were never spent are not found.
+    BOOST_CHECK(!txospenderindex.FindSpender(COutPoint{m_coinbase_txns[10]->GetHash(), 0}).value());
+
+    txospenderindex.Stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -565,4 +565,45 @@ BOOST_FIXTURE_TEST_CASE(version3_tests, RegTestingSetup)
     // equivalent to the tx with multiple generations of ancestors.
 }
 
+struct ParallelMempoolScriptChecksSetup : public TestChain100Setup {
+    ParallelMempoolScriptChecksSetup()
+        : TestChain100Setup{ChainType::REGTEST, {.extra_args = {"-parmempool=1"}}} {}
+};
+
+/**
+ * Ensure that scripts of transactions with many inputs are still verified correctly when they are dispatched to the
+ * script verification threads.
+ */
+BOOST_FIXTURE_TEST_CASE(parallel_script_checks, ParallelMempoolScriptChecksSetup)
+{
+    BOOST_REQUIRE(m_node.mempool->m_opts.parallel_script_checks);
+    BOOST_REQUIRE(WITH_LOCK(cs_main, return m_node.chainman->GetCheckQueue().HasThreads()));
+
+    // Fund enough P2PK outputs, whose signatures are in the scriptSig.
+    const CScript p2pk{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const size_t num_inputs{MIN_PARALLEL_MEMPOOL_SCRIPT_CHECK_INPUTS * 2};
+    const auto [funding_tx, _]{CreateValidTransaction({m_coinbase_txns[0]}, {COutPoint{m_coinbase_txns[0]->GetHash(), 0}}, /*input_height=*/1,
+                                                      {coinbaseKey}, std::vector<CTxOut>(num_inputs, CTxOut{COIN, p2pk}), {}, {})};
+    CreateAndProcessBlock({funding_tx}, p2pk);
+
+    std::vector<COutPoint> inputs;
+    for (uint32_t i{0}; i < num_inputs; ++i) inputs.emplace_back(funding_tx.GetHash(), i);
+    const auto [mtx, fee]{CreateValidTransaction({MakeTransactionRef(funding_tx)}, inputs, /*input_height=*/101, {coinbaseKey},
+                                                 {CTxOut{int64_t(num_inputs) * COIN - 10'000, p2pk}}, {}, {})};
+
+    // Swap the signatures of two inputs, so that each of them signs the wrong input.
+    CMutableTransaction bad_mtx{mtx};
+    std::swap(bad_mtx.vin[3].scriptSig, bad_mtx.vin[11].scriptSig);
+
+    LOCK(cs_main);
+    const auto bad_result{m_node.chainman->ProcessTransaction(MakeTransactionRef(bad_mtx), /*test_accept=*/true)};
+    BOOST_CHECK(bad_result.m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(bad_result.m_state.GetResult() == TxValidationResult::TX_NOT_STANDARD);
+    BOOST_CHECK(bad_result.m_state.GetRejectReason().starts_with("mempool-script-verify-flag-failed"));
+
+    const auto result{m_node.chainman->ProcessTransaction(MakeTransactionRef(mtx))};
+    BOOST_CHECK(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(m_node.mempool->exists(mtx.GetHash()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -89,11 +89,13 @@ struct ConnmanTestMsg : public CConnman {
         return InitBinds(options);
     }
 
-    void SocketHandlerPublic()
+    void SocketHandlerPublic(size_t shard = 0)
     {
-        SocketHandler();
+        SocketHandler(shard);
     }
 
+    size_t NodeIOShardPublic(const CNode& node) const { return NodeIOShard(node); }
+
     void Handshake(CNode& node,
                    bool successfully_connected,
                    ServiceFlags remote_services,
@@ -104,6 +106,11 @@ struct ConnmanTestMsg : public CConnman {
 
     bool ProcessMessagesOnce(CNode& node) EXCLUSIVE_LOCKS_REQUIRED(NetEventsInterface::g_msgproc_mutex)
     {
+        // Block relay messages go ahead of the others, as in the message handler thread.
+        if (node.HasBlockRelayMsgsToProcess() && !node.fDisconnect) {
+            (void)m_msgproc->ProcessBlockRelayMessage(node, flagInterruptMsgProc);
+            return true;
+        }
         return m_msgproc->ProcessMessages(node, flagInterruptMsgProc);
     }
 
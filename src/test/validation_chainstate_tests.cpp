@@ -7,8 +7,10 @@
 #include <coins.h>
 #include <consensus/amount.h>
 #include <consensus/validation.h>
+#include <flatfile.h>
 #include <node/blockstorage.h>
 #include <node/kernel_notifications.h>
+#include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -21,6 +23,7 @@
 #include <tinyformat.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -98,6 +101,70 @@ BOOST_FIXTURE_TEST_CASE(connect_tip_does_not_cache_inputs_on_failed_connect, Tes
     BOOST_CHECK(!chainstate.CoinsTip().HaveCoinInCache(outpoint));    // input not cached
 }
 
+//! Test that BlockLookahead reads upcoming blocks and adds their prevouts to the coins cache, unless the
+//! chainstate database was written to since they were fetched.
+BOOST_FIXTURE_TEST_CASE(block_lookahead, TestChain100Setup)
+{
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+
+    // Create three blocks on top of the tip, each spending a confirmed coinbase output.
+    std::vector<CBlock> blocks;
+    std::vector<COutPoint> prevouts;
+    for (int i{0}; i < 3; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(m_coinbase_txns[i]->GetHash(), 0);
+        tx.vout.emplace_back(1 * COIN, CScript{} << OP_TRUE);
+        prevouts.push_back(tx.vin[0].prevout);
+        blocks.push_back(CreateBlock({tx}, CScript{} << OP_TRUE));
+    }
+
+    LOCK(cs_main);
+    chainstate.ForceFlushStateToDisk();
+    // Write the blocks to disk as a chain without connecting them.
+    std::vector<const CBlockIndex*> indexes{chainstate.m_chain.Tip()};
+    for (auto& block : blocks) {
+        block.hashPrevBlock = indexes.back()->GetBlockHash();
+        while (!CheckProofOfWork(block.GetHash(), block.nBits, chainman.GetConsensus())) ++block.nNonce;
+        const FlatFilePos pos{chainman.m_blockman.WriteBlock(block, indexes.back()->nHeight + 1)};
+        CBlockIndex* index{chainman.m_blockman.AddToBlockIndex(block, chainman.m_best_header)};
+        index->nFile = pos.nFile;
+        index->nDataPos = pos.nPos;
+        index->nStatus |= BLOCK_HAVE_DATA;
+        indexes.push_back(index);
+    }
+
+    ThreadPool thread_pool{"lookahead_test"};
+    thread_pool.Start(6);
+    BlockLookahead lookahead{chainman.m_blockman, chainstate.CoinsErrorCatcher(), thread_pool};
+    auto& cache{chainstate.CoinsTip()};
+    const auto write_epoch{chainstate.CoinsDB().GetWriteEpoch()};
+
+    // Nothing is scheduled for the block about to be connected itself.
+    lookahead.Schedule(*indexes[0], *indexes[3], write_epoch);
+    BOOST_CHECK_EQUAL(lookahead.Size(), 3U);
+    BOOST_CHECK(!lookahead.Take(*indexes[0], cache, write_epoch));
+    BOOST_CHECK_EQUAL(lookahead.Size(), 3U);
+
+    auto block{lookahead.Take(*indexes[1], cache, write_epoch)};
+    BOOST_REQUIRE(block);
+    BOOST_CHECK_EQUAL(block->GetHash(), indexes[1]->GetBlockHash());
+    BOOST_CHECK(cache.HaveCoinInCache(prevouts[0]));
+    BOOST_CHECK(!cache.HaveCoinInCache(prevouts[1]));
+    BOOST_CHECK_EQUAL(cache.GetDirtyCount(), 0U);
+
+    // After a database write the block is still handed out, but its coins are dropped.
+    block = lookahead.Take(*indexes[2], cache, write_epoch + 1);
+    BOOST_REQUIRE(block);
+    BOOST_CHECK_EQUAL(block->GetHash(), indexes[2]->GetBlockHash());
+    BOOST_CHECK(!cache.HaveCoinInCache(prevouts[1]));
+
+    // Rescheduling from a block the remaining job does not continue from discards it.
+    lookahead.Schedule(*indexes[0], *indexes[0], write_epoch);
+    BOOST_CHECK_EQUAL(lookahead.Size(), 0U);
+    BOOST_CHECK(!lookahead.Take(*indexes[3], cache, write_epoch));
+}
+
 //! Test UpdateTip behavior for both active and background chainstates.
 //!
 //! When run on the background chainstate, UpdateTip should do a subset
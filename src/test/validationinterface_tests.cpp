@@ -4,14 +4,21 @@
 
 #include <boost/test/unit_test.hpp>
 #include <consensus/validation.h>
+#include <kernel/mempool_entry.h>
 #include <primitives/block.h>
+#include <primitives/transaction.h>
 #include <scheduler.h>
+#include <sync.h>
 #include <test/util/setup_common.h>
 #include <util/check.h>
 #include <validationinterface.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, ChainTestingSetup)
 
@@ -99,4 +106,85 @@ BOOST_AUTO_TEST_CASE(unregister_all_during_call)
     BOOST_CHECK(destroyed);
 }
 
+class QueuedSubscriber : public CValidationInterface
+{
+public:
+    Mutex m_mutex;
+    std::vector<uint64_t> m_sequences GUARDED_BY(m_mutex);
+    std::vector<size_t> m_batch_sizes GUARDED_BY(m_mutex);
+    //! Waited for before every callback, to simulate a slow subscriber.
+    std::shared_future<void> m_gate;
+    //! Set when the given number of transactions has been delivered.
+    std::promise<void> m_done;
+    size_t m_expected{0};
+
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo&, uint64_t mempool_sequence) override
+    {
+        if (m_gate.valid()) m_gate.wait();
+        LOCK(m_mutex);
+        m_sequences.push_back(mempool_sequence);
+        if (m_sequences.size() == m_expected) m_done.set_value();
+    }
+    void TransactionsAddedToMempool(std::span<const std::pair<NewMempoolTransactionInfo, uint64_t>> txs) override
+    {
+        WITH_LOCK(m_mutex, m_batch_sizes.push_back(txs.size()));
+        CValidationInterface::TransactionsAddedToMempool(txs);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(subscriber_queues)
+{
+    constexpr size_t NUM_TXS{10};
+    auto& signals{*m_node.validation_signals};
+    std::promise<void> gate;
+    QueuedSubscriber slow, fast;
+    slow.m_gate = gate.get_future().share();
+    slow.m_expected = fast.m_expected = NUM_TXS;
+    signals.RegisterValidationInterface(&slow, "slow");
+    signals.RegisterValidationInterface(&fast, "fast");
+
+    const NewMempoolTransactionInfo tx_info(MakeTransactionRef(CMutableTransaction{}), /*fee=*/0, /*vsize=*/0, /*height=*/0,
+                                            /*mempool_limit_bypassed=*/false, /*submitted_in_package=*/false,
+                                            /*chainstate_is_current=*/true, /*has_no_mempool_parents=*/true);
+    for (uint64_t i{0}; i < NUM_TXS; ++i) signals.TransactionAddedToMempool(tx_info, i);
+
+    // The fast subscriber gets everything while the slow one is stuck in its first callback.
+    fast.m_done.get_future().wait();
+    BOOST_CHECK(WITH_LOCK(slow.m_mutex, return slow.m_sequences.empty()));
+    const auto info{signals.GetQueueInfo()};
+    const auto slow_info{std::ranges::find(info, "slow", &ValidationSignals::QueueInfo::name)};
+    BOOST_REQUIRE(slow_info != info.end());
+    BOOST_CHECK_EQUAL(slow_info->pending, NUM_TXS);
+    BOOST_CHECK_EQUAL(slow_info->delivered, 0U);
+    BOOST_CHECK(slow_info->lag.has_value());
+    BOOST_CHECK_GE(signals.CallbacksPending(), NUM_TXS);
+
+    // Waiting for the slow subscriber to catch up does not hold up the shared queue.
+    std::promise<void> synced, checked;
+    signals.CallFunctionInValidationInterfaceQueue([&synced] { synced.set_value(); });
+    TestInterface shared_sub{signals, [&checked] { checked.set_value(); }};
+    signals.RegisterValidationInterface(&shared_sub);
+    shared_sub.Call();
+    checked.get_future().wait();
+    auto synced_future{synced.get_future()};
+    BOOST_CHECK(synced_future.wait_for(std::chrono::seconds{0}) == std::future_status::timeout);
+
+    // Once unblocked, the slow subscriber catches up in order, receiving the notifications that piled up as a batch.
+    gate.set_value();
+    synced_future.wait();
+    signals.SyncWithValidationInterfaceQueue();
+    signals.UnregisterValidationInterface(&shared_sub);
+    {
+        LOCK(slow.m_mutex);
+        BOOST_CHECK_EQUAL(slow.m_sequences.size(), NUM_TXS);
+        BOOST_CHECK(std::ranges::is_sorted(slow.m_sequences));
+        BOOST_CHECK(std::ranges::any_of(slow.m_batch_sizes, [](size_t size) { return size > 1; }));
+    }
+    BOOST_CHECK(WITH_LOCK(fast.m_mutex, return std::ranges::is_sorted(fast.m_sequences)));
+
+    signals.UnregisterValidationInterface(&slow);
+    signals.UnregisterValidationInterface(&fast);
+    BOOST_CHECK(signals.GetQueueInfo().empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
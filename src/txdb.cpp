@@ -15,11 +15,13 @@
 #include <util/byte_units.h>
 #include <util/log.h>
 #include <util/threadnames.h>
+#include <util/threadpool.h>
 #include <util/vector.h>
 
 #include <cassert>
 #include <chrono>
 #include <cstdlib>
+#include <deque>
 #include <exception>
 #include <future>
 #include <iterator>
@@ -76,6 +78,7 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
     // reset.
     if (!m_db_params.memory_only) {
         LOCK(m_db_mutex);
+        m_write_epoch.fetch_add(1, std::memory_order_relaxed);
         // Have to do a reset first to get the original `m_db` state to release its
         // filesystem lock.
         m_db.reset();
@@ -121,7 +124,26 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 
 void CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block_hash)
 {
-    CDBBatch batch(*m_db);
+    m_write_epoch.fetch_add(1, std::memory_order_relaxed);
+    // Partial batches are written by a persistent background thread while the next one is being filled, so that
+    // walking the cache and serializing coins overlaps with LevelDB writes. Batches are still written one at a time and in
+    // order, so the head blocks marker written first and the best block written last keep the database
+    // recoverable if the process stops at any point.
+    CDBBatch batches[2]{CDBBatch{*m_db}, CDBBatch{*m_db}};
+    CDBBatch* batch{&batches[0]};
+    // Destroyed before the batches, and waits for the pending write (if any) in its destructor.
+    std::future<void> pending_write;
+    const auto wait_for_pending_write{[&] {
+        if (!pending_write.valid()) return;
+        pending_write.get();
+        if (m_options.simulate_crash_ratio) {
+            static FastRandomContext rng;
+            if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
+                LogError("Simulating a crash. Goodbye.");
+                _Exit(0);
+            }
+        }
+    }};
     size_t count = 0;
     const size_t dirty_count{cursor.GetDirtyCount()};
     assert(!block_hash.IsNull());
@@ -147,41 +169,45 @@ void CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block
     // transition from old_tip to block_hash.
     // A vector is used for future extensibility, as we may want to support
     // interrupting after partial writes from multiple independent reorgs.
-    batch.Erase(DB_BEST_BLOCK);
-    batch.Write(DB_HEAD_BLOCKS, Vector(block_hash, old_tip));
+    batch->Erase(DB_BEST_BLOCK);
+    batch->Write(DB_HEAD_BLOCKS, Vector(block_hash, old_tip));
 
     for (auto it{cursor.Begin()}; it != cursor.End();) {
         if (it->second.IsDirty()) {
             CoinEntry entry(&it->first);
             if (it->second.coin.IsSpent()) {
-                batch.Erase(entry);
+                batch->Erase(entry);
             } else {
-                batch.Write(entry, it->second.coin);
+                batch->Write(entry, it->second.coin);
             }
         }
         count++;
         it = cursor.NextAndMaybeErase(*it);
-        if (batch.ApproximateSize() > m_options.batch_write_bytes) {
-            LogDebug(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.ApproximateSize() / double(1_MiB));
-
-            m_db->WriteBatch(batch);
-            batch.Clear();
-            if (m_options.simulate_crash_ratio) {
-                static FastRandomContext rng;
-                if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
-                    LogError("Simulating a crash. Goodbye.");
-                    _Exit(0);
-                }
+        if (batch->ApproximateSize() > m_options.batch_write_bytes) {
+            LogDebug(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch->ApproximateSize() / double(1_MiB));
+
+            wait_for_pending_write();
+            if (!m_batch_writer) {
+                m_batch_writer = std::make_unique<ThreadPool>("utxowrite");
+                m_batch_writer->Start(1);
             }
+            if (auto future{m_batch_writer->Submit([this, batch] { m_db->WriteBatch(*batch); })}) {
+                pending_write = std::move(*future);
+            } else {
+                m_db->WriteBatch(*batch);
+            }
+            batch = batch == &batches[0] ? &batches[1] : &batches[0];
+            batch->Clear();
         }
     }
 
     // In the last batch, mark the database as consistent with block_hash again.
-    batch.Erase(DB_HEAD_BLOCKS);
-    batch.Write(DB_BEST_BLOCK, block_hash);
+    batch->Erase(DB_HEAD_BLOCKS);
+    batch->Write(DB_BEST_BLOCK, block_hash);
 
-    LogDebug(BCLog::COINDB, "Writing final batch of %.2f MiB\n", batch.ApproximateSize() / double(1_MiB));
-    m_db->WriteBatch(batch);
+    wait_for_pending_write();
+    LogDebug(BCLog::COINDB, "Writing final batch of %.2f MiB\n", batch->ApproximateSize() / double(1_MiB));
+    m_db->WriteBatch(*batch);
     LogDebug(BCLog::COINDB, "Committed %u changed transaction outputs (out of %u) to coin database...", (unsigned int)dirty_count, (unsigned int)count);
 }
 
@@ -231,8 +257,13 @@ public:
     void Next() override;
 
 private:
+    //! Cache the key of the current record, or invalidate the cursor when it's past the last record of its range
+    void CacheKey();
+
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    //! Txids from this one on are outside of the cursor's range
+    std::optional<Txid> m_end;
 
     friend class CCoinsViewDB;
 };
@@ -246,16 +277,36 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
-    } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
-    }
+    i->CacheKey();
     return i;
 }
 
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsViewDB::PartitionedCursors(int partitions) const
+{
+    constexpr int PREFIXES{1 << 16};
+    assert(partitions > 0 && partitions <= PREFIXES);
+    const auto prefix_hash{[](int prefix) {
+        uint256 hash;
+        hash.data()[0] = prefix >> 8;
+        hash.data()[1] = prefix & 0xff;
+        return hash;
+    }};
+
+    const uint256 best_block{GetBestBlock()};
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    cursors.reserve(partitions);
+    for (int partition{0}; partition < partitions; ++partition) {
+        const int begin{partition * PREFIXES / partitions};
+        const int end{(partition + 1) * PREFIXES / partitions};
+        auto i = std::make_unique<CCoinsViewDBCursor>(const_cast<CDBWrapper&>(*m_db).NewIterator(), best_block);
+        if (end < PREFIXES) i->m_end = Txid::FromUint256(prefix_hash(end));
+        i->pcursor->Seek(std::make_pair(DB_COIN, prefix_hash(begin)));
+        i->CacheKey();
+        cursors.push_back(std::move(i));
+    }
+    return cursors;
+}
+
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 {
     // Return cached key
@@ -279,10 +330,55 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
+    CacheKey();
+}
+
+void CCoinsViewDBCursor::CacheKey()
+{
     CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) || (m_end && keyTmp.second.hash >= *m_end)) {
         keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
     } else {
         keyTmp.first = entry.key;
     }
 }
+
+bool ScanPartitions(size_t partitions, ThreadPool* thread_pool,
+                    const std::function<bool(size_t)>& scan_partition,
+                    const std::function<bool(size_t)>& merge_partition)
+{
+    const size_t max_in_flight{thread_pool ? 2 * thread_pool->WorkersCount() : 0};
+    std::deque<std::future<bool>> in_flight;
+    size_t next_partition{0};
+    size_t merged{0};
+    bool ok{true};
+    std::exception_ptr error;
+
+    while (ok && merged < partitions) {
+        while (next_partition < partitions && in_flight.size() < max_in_flight) {
+            auto future{thread_pool->Submit([&scan_partition, partition = next_partition] { return scan_partition(partition); })};
+            if (!future) break;
+            in_flight.push_back(std::move(*future));
+            ++next_partition;
+        }
+        try {
+            bool scanned;
+            if (!in_flight.empty()) {
+                auto future{std::move(in_flight.front())};
+                in_flight.pop_front();
+                scanned = future.get();
+            } else {
+                scanned = scan_partition(next_partition++);
+            }
+            ok = scanned && merge_partition(merged++);
+        } catch (...) {
+            error = std::current_exception();
+            ok = false;
+        }
+    }
+
+    // The partitions still in flight refer to the caller's state, so they have to finish before returning.
+    for (auto& future : in_flight) future.wait();
+    if (error) std::rethrow_exception(error);
+    return ok;
+}
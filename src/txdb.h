@@ -13,8 +13,10 @@
 #include <sync.h>
 #include <util/fs.h>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <future>
 #include <memory>
 #include <optional>
@@ -22,8 +24,12 @@
 #include <vector>
 
 class COutPoint;
+class ThreadPool;
 class uint256;
 
+//! Number of key ranges the UTXO set is split into for scanning it in parallel, see CCoinsViewDB::PartitionedCursors.
+static constexpr int UTXO_SCAN_PARTITIONS{1024};
+
 //! User-controlled performance and debug options.
 struct CoinsViewOptions {
     //! Maximum database write batch size in bytes.
@@ -42,6 +48,10 @@ protected:
     Mutex m_db_mutex;
     std::unique_ptr<CDBWrapper> m_db;
     std::shared_future<void> m_compaction;
+    //! Incremented before every write to the coins database, see GetWriteEpoch().
+    std::atomic<uint64_t> m_write_epoch{0};
+    //! Writes partial batches in the background during BatchWrite(). Started on the first partial batch.
+    std::unique_ptr<ThreadPool> m_batch_writer;
 public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
     ~CCoinsViewDB() override;
@@ -54,6 +64,14 @@ public:
     void BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block_hash) override;
     //! Get a cursor to iterate over the whole state.
     std::unique_ptr<CCoinsViewCursor> Cursor() const;
+    //! Get cursors over `partitions` consecutive ranges of the state, split by the first two bytes of the txid, which
+    //! together cover the whole state. All of them see the same state if the database isn't written to while they
+    //! are created, which callers make sure of like for Cursor().
+    std::vector<std::unique_ptr<CCoinsViewCursor>> PartitionedCursors(int partitions) const;
+
+    //! Return a counter that changes whenever the database is written to. Coins read from the database
+    //! while the counter kept the same value reflect the state of the database as of that value.
+    uint64_t GetWriteEpoch() const { return m_write_epoch.load(std::memory_order_relaxed); }
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
@@ -69,4 +87,16 @@ public:
     std::optional<std::string> GetDBProperty(const std::string& property);
 };
 
+/**
+ * Run scan_partition for partitions 0 to partitions - 1, on the workers of thread_pool if one is given (with up to
+ * two partitions per worker in flight) or on the calling thread otherwise, and merge_partition for every scanned
+ * partition in order on the calling thread. The scan stops early when either function returns false or throws: no
+ * more partitions are started, the ones in flight are waited for and the exception, if any, is rethrown.
+ *
+ * @returns whether all partitions were scanned and merged
+ */
+bool ScanPartitions(size_t partitions, ThreadPool* thread_pool,
+                    const std::function<bool(size_t)>& scan_partition,
+                    const std::function<bool(size_t)>& merge_partition);
+
 #endif // BITCOIN_TXDB_H
@@ -0,0 +1,41 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/mappedfile.h>
+
+#include <util/fs.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::unique_ptr<const MappedFile> MappedFile::Open(const fs::path& path)
+{
+#ifndef WIN32
+    if constexpr (!SUPPORTED) return nullptr;
+    const int fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd == -1) return nullptr;
+    struct stat st;
+    void* addr{MAP_FAILED};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    if (addr == MAP_FAILED) return nullptr;
+    return std::unique_ptr<const MappedFile>{new MappedFile{{static_cast<const std::byte*>(addr), static_cast<size_t>(st.st_size)}}};
+#else
+    return nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef WIN32
+    munmap(const_cast<std::byte*>(m_data.data()), m_data.size());
+#endif
+}
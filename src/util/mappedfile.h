@@ -0,0 +1,47 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_MAPPEDFILE_H
+#define BITCOIN_UTIL_MAPPEDFILE_H
+
+#include <util/fs.h>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+/**
+ * Read-only memory map of a whole file.
+ *
+ * Reading through the map avoids a read() system call and the copy into a stdio buffer for every access. The file
+ * must not be truncated while mapped: accessing a page past its end raises SIGBUS instead of an I/O error. The same
+ * happens when the underlying medium fails to read a page, e.g. a bad disk sector or a network file system that
+ * went away, so such errors terminate the process rather than being reported to the caller. Users that need to
+ * survive them must read the file instead.
+ */
+class MappedFile
+{
+    std::span<const std::byte> m_data;
+
+    explicit MappedFile(std::span<const std::byte> data) noexcept : m_data{data} {}
+
+public:
+    //! Mapping is only supported on POSIX systems with a 64-bit address space.
+#if !defined(WIN32)
+    static constexpr bool SUPPORTED{sizeof(void*) >= 8};
+#else
+    static constexpr bool SUPPORTED{false};
+#endif
+
+    /** Map the file at path into memory. Returns nullptr if it is not supported, the file cannot be opened, or is empty. */
+    static std::unique_ptr<const MappedFile> Open(const fs::path& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    std::span<const std::byte> Data() const noexcept { return m_data; }
+};
+
+#endif // BITCOIN_UTIL_MAPPEDFILE_H
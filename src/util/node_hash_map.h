@@ -0,0 +1,380 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_NODE_HASH_MAP_H
+#define BITCOIN_UTIL_NODE_HASH_MAP_H
+
+#include <util/check.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/** Hash map largely mimicking std::unordered_map, using open addressing over a flat table of node pointers.
+ *
+ * Elements are allocated one by one through Allocator and never move, so pointers and references to them stay
+ * valid until they are erased, exactly as with std::unordered_map. This allows elements to be linked together
+ * externally (see CoinsCachePair).
+ *
+ * The table is an array of groups, each holding GROUP_SIZE slots. Every slot has a control byte, which is either
+ * EMPTY, DELETED or the low 7 bits of the hash of the element it points to. A lookup picks a group using the
+ * remaining hash bits, and compares the control bytes of all of its slots against the 7 hash bits at once (with
+ * SSE2 where available), so only elements whose fingerprint matches are dereferenced. Groups are probed
+ * quadratically until a group with an EMPTY slot is found.
+ *
+ * Compared to std::unordered_map:
+ * - Elements do not carry a next pointer, and there is no separate bucket array.
+ * - A lookup loads the 16 control bytes of one group, and only reads the slot pointers whose fingerprint matches,
+ *   before touching an element, instead of chasing a bucket pointer and a chain of nodes.
+ * - The hash is never recomputed for elements other than the one being inserted, except when the table grows.
+ * - Iterators are invalidated by any insertion that may grow the table. Pointers and references are not.
+ * - Only the subset of the std::unordered_map interface needed by its users is provided.
+ */
+template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+class NodeHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+    static constexpr size_t GROUP_SIZE{16};
+
+private:
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, value_type>);
+
+    static constexpr int8_t EMPTY{-128};
+    static constexpr int8_t DELETED{-2};
+
+    struct Group {
+        alignas(GROUP_SIZE) std::array<int8_t, GROUP_SIZE> ctrl;
+        std::array<value_type*, GROUP_SIZE> slots;
+
+        Group() noexcept { ctrl.fill(EMPTY); }
+
+        //! Bitmask of the slots whose control byte equals c.
+        uint32_t Match(int8_t c) const noexcept
+        {
+#if defined(__SSE2__)
+            const __m128i ctrl_bytes{_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl.data()))};
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_bytes, _mm_set1_epi8(c))));
+#else
+            uint32_t mask{0};
+            for (size_t i{0}; i < GROUP_SIZE; ++i) mask |= uint32_t{ctrl[i] == c} << i;
+            return mask;
+#endif
+        }
+
+        //! Bitmask of the slots that are EMPTY or DELETED, i.e. whose control byte has the sign bit set.
+        uint32_t MatchFree() const noexcept
+        {
+#if defined(__SSE2__)
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl.data()))));
+#else
+            uint32_t mask{0};
+            for (size_t i{0}; i < GROUP_SIZE; ++i) mask |= uint32_t{ctrl[i] < 0} << i;
+            return mask;
+#endif
+        }
+    };
+    static_assert(sizeof(Group) == GROUP_SIZE * (1 + sizeof(value_type*)));
+
+    std::vector<Group> m_groups;
+    //! Number of elements.
+    size_t m_size{0};
+    //! Number of elements that can still be inserted into EMPTY slots before the table must grow.
+    size_t m_growth_left{0};
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_key_equal;
+    [[no_unique_address]] Allocator m_alloc;
+
+    //! Keep the load, including DELETED slots, at or below 7/8.
+    static constexpr size_t MaxLoad(size_t capacity) noexcept { return capacity - capacity / 8; }
+
+    //! The low 7 bits of the hash are stored in the control byte, the rest selects the first group to probe.
+    static int8_t H2(size_t hash) noexcept { return static_cast<int8_t>(hash & 0x7f); }
+    size_t H1(size_t hash) const noexcept { return (hash >> 7) & (m_groups.size() - 1); }
+
+    size_t Capacity() const noexcept { return m_groups.size() * GROUP_SIZE; }
+
+    //! Position of the element with the given key, or Capacity() if not found.
+    template <typename K>
+    size_t FindPos(const K& key, size_t hash) const noexcept
+    {
+        if (m_groups.empty()) return 0;
+        const int8_t h2{H2(hash)};
+        for (size_t g{H1(hash)}, step{0};; g = (g + ++step) & (m_groups.size() - 1)) {
+            const Group& group{m_groups[g]};
+            for (uint32_t mask{group.Match(h2)}; mask; mask &= mask - 1) {
+                const auto i{static_cast<size_t>(std::countr_zero(mask))};
+                if (m_key_equal(group.slots[i]->first, key)) return g * GROUP_SIZE + i;
+            }
+            if (group.Match(EMPTY)) return Capacity();
+        }
+    }
+
+    //! Position of the first EMPTY or DELETED slot in the probe sequence for hash.
+    size_t FindFreePos(size_t hash) const noexcept
+    {
+        for (size_t g{H1(hash)}, step{0};; g = (g + ++step) & (m_groups.size() - 1)) {
+            if (const uint32_t mask{m_groups[g].MatchFree()}) return g * GROUP_SIZE + std::countr_zero(mask);
+        }
+    }
+
+    //! Make sure one more element can be inserted without growing the table. May throw, so it is called before a
+    //! node is handed to InsertNode().
+    void PrepareInsert()
+    {
+        if (m_growth_left > 0) return;
+        // Only DELETED slots are left to reuse if the table is not that full, so rebuild it at the same size to
+        // reclaim them. Otherwise double it.
+        const bool in_place{!m_groups.empty() && m_size * 32 <= Capacity() * 25};
+        Rehash(in_place ? Capacity() : std::max(Capacity() * 2, GROUP_SIZE));
+    }
+
+    //! Store node in a free slot for hash. PrepareInsert() must have been called since the last insertion.
+    size_t InsertNode(value_type* node, size_t hash) noexcept
+    {
+        Assume(m_growth_left > 0);
+        const size_t pos{FindFreePos(hash)};
+        Group& group{m_groups[pos / GROUP_SIZE]};
+        m_growth_left -= group.ctrl[pos % GROUP_SIZE] == EMPTY;
+        group.ctrl[pos % GROUP_SIZE] = H2(hash);
+        group.slots[pos % GROUP_SIZE] = node;
+        ++m_size;
+        return pos;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        Assume(std::has_single_bit(capacity / GROUP_SIZE) && MaxLoad(capacity) > m_size);
+        std::vector<Group> old_groups(capacity / GROUP_SIZE);
+        old_groups.swap(m_groups);
+        m_growth_left = MaxLoad(capacity) - m_size;
+        for (const Group& group : old_groups) {
+            for (uint32_t mask{~group.MatchFree() & 0xffff}; mask; mask &= mask - 1) {
+                value_type* node{group.slots[std::countr_zero(mask)]};
+                const size_t hash{m_hash(node->first)};
+                const size_t pos{FindFreePos(hash)};
+                m_groups[pos / GROUP_SIZE].ctrl[pos % GROUP_SIZE] = H2(hash);
+                m_groups[pos / GROUP_SIZE].slots[pos % GROUP_SIZE] = node;
+            }
+        }
+    }
+
+    template <typename... Args>
+    value_type* NewNode(Args&&... args)
+    {
+        value_type* node{AllocTraits::allocate(m_alloc, 1)};
+        try {
+            AllocTraits::construct(m_alloc, node, std::forward<Args>(args)...);
+        } catch (...) {
+            AllocTraits::deallocate(m_alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void DeleteNode(value_type* node) noexcept
+    {
+        AllocTraits::destroy(m_alloc, node);
+        AllocTraits::deallocate(m_alloc, node, 1);
+    }
+
+    void EraseAt(size_t pos) noexcept
+    {
+        Group& group{m_groups[pos / GROUP_SIZE]};
+        DeleteNode(group.slots[pos % GROUP_SIZE]);
+        // If the group still has an EMPTY slot, no probe sequence ever continued past it, so the slot can be
+        // made EMPTY again. Otherwise it must stay occupied as far as lookups are concerned.
+        if (group.Match(EMPTY)) {
+            group.ctrl[pos % GROUP_SIZE] = EMPTY;
+            ++m_growth_left;
+        } else {
+            group.ctrl[pos % GROUP_SIZE] = DELETED;
+        }
+        --m_size;
+    }
+
+    template <bool IsConst>
+    class Iterator
+    {
+        friend class NodeHashMap;
+        template <bool>
+        friend class Iterator;
+        using MapPtr = std::conditional_t<IsConst, const NodeHashMap*, NodeHashMap*>;
+        MapPtr m_map{nullptr};
+        size_t m_pos{0};
+
+        Iterator(MapPtr map, size_t pos) noexcept : m_map{map}, m_pos{pos} {}
+
+        void SkipFree() noexcept
+        {
+            while (m_pos < m_map->Capacity() && m_map->m_groups[m_pos / GROUP_SIZE].ctrl[m_pos % GROUP_SIZE] < 0) ++m_pos;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = NodeHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+        Iterator() noexcept = default;
+        //! Allow conversion from iterator to const_iterator.
+        template <bool C = IsConst>
+            requires C
+        Iterator(const Iterator<false>& other) noexcept : m_map{other.m_map}, m_pos{other.m_pos} {}
+
+        reference operator*() const noexcept { return *m_map->m_groups[m_pos / GROUP_SIZE].slots[m_pos % GROUP_SIZE]; }
+        pointer operator->() const noexcept { return &**this; }
+
+        Iterator& operator++() noexcept
+        {
+            ++m_pos;
+            SkipFree();
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            Iterator ret{*this};
+            ++*this;
+            return ret;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.m_pos == b.m_pos; }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit NodeHashMap(size_t bucket_count, const Hash& hash = Hash{}, const KeyEqual& key_equal = KeyEqual{}, const Allocator& alloc = Allocator{})
+        : m_hash{hash}, m_key_equal{key_equal}, m_alloc{alloc}
+    {
+        reserve(bucket_count);
+    }
+
+    NodeHashMap(const NodeHashMap&) = delete;
+    NodeHashMap& operator=(const NodeHashMap&) = delete;
+
+    ~NodeHashMap() { clear(); }
+
+    iterator begin() noexcept
+    {
+        iterator it{this, 0};
+        it.SkipFree();
+        return it;
+    }
+    const_iterator begin() const noexcept
+    {
+        const_iterator it{this, 0};
+        it.SkipFree();
+        return it;
+    }
+    iterator end() noexcept { return {this, Capacity()}; }
+    const_iterator end() const noexcept { return {this, Capacity()}; }
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    //! Number of slots in the table.
+    size_t bucket_count() const noexcept { return Capacity(); }
+    //! Number of bytes allocated for the table, not including the elements.
+    size_t table_bytes() const noexcept { return m_groups.capacity() * sizeof(Group); }
+
+    const Hash& hash_function() const noexcept { return m_hash; }
+    const Allocator& get_allocator() const noexcept { return m_alloc; }
+
+    iterator find(const Key& key) noexcept { return {this, FindPos(key, m_hash(key))}; }
+    const_iterator find(const Key& key) const noexcept { return {this, FindPos(key, m_hash(key))}; }
+    bool contains(const Key& key) const noexcept { return FindPos(key, m_hash(key)) != Capacity(); }
+    size_t count(const Key& key) const noexcept { return contains(key); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        const size_t hash{m_hash(key)};
+        if (const size_t pos{FindPos(key, hash)}; pos != Capacity()) return {{this, pos}, false};
+        PrepareInsert();
+        value_type* node{NewNode(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...))};
+        return {{this, InsertNode(node, hash)}, true};
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        value_type* node{NewNode(std::forward<Args>(args)...)};
+        const size_t hash{m_hash(node->first)};
+        if (const size_t pos{FindPos(node->first, hash)}; pos != Capacity()) {
+            DeleteNode(node);
+            return {{this, pos}, false};
+        }
+        try {
+            PrepareInsert();
+        } catch (...) {
+            DeleteNode(node);
+            throw;
+        }
+        return {{this, InsertNode(node, hash)}, true};
+    }
+
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    void erase(const_iterator it) noexcept
+    {
+        Assume(it.m_map == this && it.m_pos < Capacity());
+        EraseAt(it.m_pos);
+    }
+
+    size_t erase(const Key& key) noexcept
+    {
+        const size_t pos{FindPos(key, m_hash(key))};
+        if (pos == Capacity()) return 0;
+        EraseAt(pos);
+        return 1;
+    }
+
+    //! Destroy all elements. The table keeps its capacity.
+    void clear() noexcept
+    {
+        if (m_size == 0 && m_growth_left == MaxLoad(Capacity())) return;
+        for (Group& group : m_groups) {
+            for (uint32_t mask{~group.MatchFree() & 0xffff}; mask; mask &= mask - 1) {
+                DeleteNode(group.slots[std::countr_zero(mask)]);
+            }
+            group.ctrl.fill(EMPTY);
+        }
+        m_size = 0;
+        m_growth_left = MaxLoad(Capacity());
+    }
+
+    //! Make room for at least count elements without growing the table.
+    void reserve(size_t count)
+    {
+        if (count <= m_size + m_growth_left) return;
+        size_t capacity{GROUP_SIZE};
+        while (MaxLoad(capacity) < count) capacity *= 2;
+        Rehash(capacity);
+    }
+};
+
+#endif // BITCOIN_UTIL_NODE_HASH_MAP_H
@@ -19,6 +19,8 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -26,6 +28,11 @@
 #include <poll.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
 Sock::Sock(SOCKET s) : m_socket(s) {}
 
 Sock::Sock(Sock&& other)
@@ -246,6 +253,158 @@ bool Sock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per
 #endif /* USE_POLL */
 }
 
+struct SockWaitSet::Impl {
+    struct Registration {
+        std::weak_ptr<const Sock> sock;
+        Sock::Event requested;
+    };
+    //! Sockets waited on, by address. The entry of a socket that was destroyed since is stale: closing the socket
+    //! removed it from the epoll set, and the entry is dropped when it is replaced or swept.
+    std::unordered_map<const Sock*, Registration> registered;
+    //! Size of `registered` from which stale entries are swept, to keep it proportional to the live sockets.
+    size_t sweep_size{MIN_SWEEP_SIZE};
+    static constexpr size_t MIN_SWEEP_SIZE{64};
+
+#ifdef USE_EPOLL
+    //! epoll instance the sockets are registered with, or -1 when falling back to Sock::WaitMany().
+    int epoll_fd{-1};
+    std::vector<epoll_event> ready;
+
+    ~Impl() { FallBack(); }
+
+    void FallBack()
+    {
+        if (epoll_fd != -1) close(epoll_fd);
+        epoll_fd = -1;
+    }
+
+    static uint32_t ToEpollEvents(Sock::Event requested)
+    {
+        uint32_t events{0};
+        if (requested & Sock::RecvEvent) events |= EPOLLIN;
+        if (requested & Sock::SendEvent) events |= EPOLLOUT;
+        return events;
+    }
+
+    //! Pass a new or changed registration to the kernel, or fall back to Sock::WaitMany() for good if it fails.
+    void Register(const std::shared_ptr<const Sock>& sock, Sock::Event requested, bool known)
+    {
+        if (epoll_fd == -1) return;
+        if (typeid(*sock) != typeid(Sock)) {
+            // Not a plain OS socket, like mocks in tests.
+            FallBack();
+            return;
+        }
+        epoll_event event{};
+        event.events = ToEpollEvents(requested);
+        event.data.ptr = const_cast<Sock*>(sock.get());
+        if (epoll_ctl(epoll_fd, known ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, sock->m_socket, &event) != 0) {
+            LogWarning("epoll_ctl() failed, falling back to poll(): %s", NetworkErrorString(WSAGetLastError()));
+            FallBack();
+        }
+    }
+
+    void Unregister(const Sock& sock)
+    {
+        if (epoll_fd != -1) epoll_ctl(epoll_fd, EPOLL_CTL_DEL, sock.m_socket, nullptr);
+    }
+#else
+    void Register(const std::shared_ptr<const Sock>&, Sock::Event, bool) {}
+    void Unregister(const Sock&) {}
+#endif /* USE_EPOLL */
+
+    void Sweep()
+    {
+        if (registered.size() < sweep_size) return;
+        std::erase_if(registered, [](const auto& entry) { return entry.second.sock.expired(); });
+        sweep_size = std::max(MIN_SWEEP_SIZE, 2 * registered.size());
+    }
+};
+
+SockWaitSet::SockWaitSet() : m_impl{std::make_unique<Impl>()}
+{
+#ifdef USE_EPOLL
+    m_impl->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_impl->epoll_fd == SOCKET_ERROR) {
+        LogWarning("epoll_create1() failed, falling back to poll(): %s", NetworkErrorString(WSAGetLastError()));
+        m_impl->epoll_fd = -1;
+    }
+#endif /* USE_EPOLL */
+}
+
+SockWaitSet::~SockWaitSet() = default;
+
+SockWaitSet::SockWaitSet(SockWaitSet&&) noexcept = default;
+
+SockWaitSet& SockWaitSet::operator=(SockWaitSet&&) noexcept = default;
+
+void SockWaitSet::Set(const std::shared_ptr<const Sock>& sock, Sock::Event requested)
+{
+    const auto it{m_impl->registered.find(sock.get())};
+    const bool known{it != m_impl->registered.end() && it->second.sock.lock() == sock};
+    if (requested == 0) {
+        if (known) m_impl->Unregister(*sock);
+        if (it != m_impl->registered.end()) m_impl->registered.erase(it);
+        return;
+    }
+    if (known && it->second.requested == requested) return;
+
+    m_impl->Register(sock, requested, known);
+    if (it != m_impl->registered.end()) {
+        it->second = Impl::Registration{sock, requested};
+    } else {
+        m_impl->Sweep();
+        m_impl->registered.emplace(sock.get(), Impl::Registration{sock, requested});
+    }
+}
+
+bool SockWaitSet::Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& ready)
+{
+    ready.clear();
+    if (m_impl->registered.empty()) return false;
+
+#ifdef USE_EPOLL
+    if (m_impl->epoll_fd != -1) {
+        m_impl->ready.resize(m_impl->registered.size());
+        const int num_ready{epoll_wait(m_impl->epoll_fd, m_impl->ready.data(), m_impl->ready.size(), count_milliseconds(timeout))};
+        if (num_ready == SOCKET_ERROR) return false;
+
+        for (const epoll_event& event : std::span{m_impl->ready}.first(num_ready)) {
+            const auto it{m_impl->registered.find(static_cast<const Sock*>(event.data.ptr))};
+            if (it == m_impl->registered.end()) continue;
+            auto sock{it->second.sock.lock()};
+            if (!sock) continue;
+            Sock::Events events{it->second.requested};
+            if (event.events & EPOLLIN) events.occurred |= Sock::RecvEvent;
+            if (event.events & EPOLLOUT) events.occurred |= Sock::SendEvent;
+            if (event.events & (EPOLLERR | EPOLLHUP)) events.occurred |= Sock::ErrorEvent;
+            ready.emplace(std::move(sock), events);
+        }
+        return true;
+    }
+#endif /* USE_EPOLL */
+
+    Sock::EventsPerSock events_per_sock;
+    for (const auto& [_, registration] : m_impl->registered) {
+        if (auto sock{registration.sock.lock()}) events_per_sock.emplace(std::move(sock), Sock::Events{registration.requested});
+    }
+    if (events_per_sock.empty()) return false;
+    // WaitMany() may as well be a static method, the context of the first Sock in the map is not relevant.
+    if (!events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) return false;
+    for (const auto& [sock, events] : events_per_sock) {
+        if (events.occurred) ready.emplace(sock, events);
+    }
+    return true;
+}
+
+void SockWaitSet::Clear()
+{
+    for (const auto& [_, registration] : m_impl->registered) {
+        if (const auto sock{registration.sock.lock()}) m_impl->Unregister(*sock);
+    }
+    m_impl->registered.clear();
+}
+
 void Sock::SendComplete(std::span<const unsigned char> data,
                         std::chrono::milliseconds timeout,
                         CThreadInterrupt& interrupt) const
@@ -283,12 +283,63 @@ protected:
     SOCKET m_socket;
 
 private:
+    friend class SockWaitSet;
+
     /**
      * Close `m_socket` if it is not `INVALID_SOCKET`.
      */
     void Close();
 };
 
+/**
+ * Persistent set of sockets to wait on, for an I/O loop that waits on mostly the same sockets over and over.
+ *
+ * On Linux it is backed by epoll(7): sockets stay registered with the kernel between calls, only sockets that are
+ * added or removed, or whose requested events change, are passed to it, and the kernel only reports the sockets that
+ * are ready. Waiting on thousands of mostly idle sockets thus does not cost a scan over all of them, as poll(2) does.
+ * Elsewhere, or once a socket that is not a plain OS socket (like mocks in tests) is added, it falls back to
+ * `Sock::WaitMany()`.
+ *
+ * The set does not keep sockets alive: a socket that is destroyed is no longer waited on.
+ *
+ * Not thread safe: it is meant to be owned by the thread running the I/O loop.
+ */
+class SockWaitSet
+{
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+
+public:
+    SockWaitSet();
+    ~SockWaitSet();
+
+    SockWaitSet(const SockWaitSet&) = delete;
+    SockWaitSet& operator=(const SockWaitSet&) = delete;
+
+    SockWaitSet(SockWaitSet&&) noexcept;
+    SockWaitSet& operator=(SockWaitSet&&) noexcept;
+
+    /**
+     * Wait for `requested` events on `sock` from now on, or no longer wait on it if `requested` is 0. Cheap if the
+     * requested events did not change since the last call for this socket.
+     * @param[in] sock Socket owned by the shared pointer, so that the set can tell when it is destroyed.
+     */
+    void Set(const std::shared_ptr<const Sock>& sock, Sock::Event requested);
+
+    /**
+     * Wait for the requested events on the sockets in the set, like `Sock::WaitMany()`.
+     * @param[in] timeout Wait this much for at least one of the requested events to occur.
+     * @param[out] ready The sockets on which some of the requested events occurred.
+     * @return true on success (or timeout, if `ready` is empty) and false on error or if the set is empty.
+     */
+    [[nodiscard]] bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& ready);
+
+    /**
+     * Remove all sockets from the set.
+     */
+    void Clear();
+};
+
 /** Return readable error string for a network error code */
 std::string NetworkErrorString(int err);
 
@@ -17,6 +17,7 @@
 #include <consensus/tx_check.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <cuckoocache.h>
 #include <flatfile.h>
 #include <hash.h>
@@ -43,6 +44,7 @@
 #include <script/script.h>
 #include <script/sigcache.h>
 #include <signet.h>
+#include <streams.h>
 #include <tinyformat.h>
 #include <txdb.h>
 #include <txmempool.h>
@@ -76,6 +78,7 @@
 #include <span>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <utility>
 
 using kernel::CCoinsStats;
@@ -849,6 +852,20 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
 
     m_view.SetBackend(m_viewmempool);
 
+    // Warm the coins cache with the confirmed prevouts of this transaction in parallel, rather than letting the
+    // loop below hit the chainstate database once per input. Prevouts created by mempool transactions are
+    // skipped since they are served by m_viewmempool. Anything added here was not cached before, so it is
+    // tracked in coins_to_uncache just like coins fetched on demand below.
+    if (tx.vin.size() > 1) {
+        std::vector<COutPoint> prevouts;
+        prevouts.reserve(tx.vin.size());
+        for (const CTxIn& txin : tx.vin) {
+            if (!m_pool.exists(txin.prevout.hash)) prevouts.push_back(txin.prevout);
+        }
+        auto prefetched{m_active_chainstate.CoinsTip().PrefetchCoins(prevouts, m_active_chainstate.PrevoutThreadPool())};
+        coins_to_uncache.insert(coins_to_uncache.end(), prefetched.begin(), prefetched.end());
+    }
+
     const CCoinsViewCache& coins_cache = m_active_chainstate.CoinsTip();
     // do all inputs exist?
     for (const CTxIn& txin : tx.vin) {
@@ -1146,7 +1163,21 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
 
     // Check input scripts and signatures.
     // This is done last to help prevent CPU exhaustion denial-of-service attacks.
-    if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache())) {
+    // For transactions with many inputs, the per-input checks may be run by the script verification threads
+    // (otherwise only used by ConnectBlock) rather than serially on this thread.
+    auto& check_queue{m_active_chainstate.m_chainman.GetCheckQueue()};
+    const bool parallel{m_pool.m_opts.parallel_script_checks && tx.vin.size() >= MIN_PARALLEL_MEMPOOL_SCRIPT_CHECK_INPUTS && check_queue.HasThreads()};
+    std::vector<CScriptCheck> checks;
+    bool scripts_ok{CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache(), parallel ? &checks : nullptr)};
+    if (scripts_ok && !checks.empty()) {
+        CCheckQueueControl<CScriptCheck> control{check_queue};
+        control.Add(std::move(checks));
+        if (const auto result{control.Complete()}) {
+            // Same as CheckInputScripts() for STANDARD_SCRIPT_VERIFY_FLAGS, which include non-mandatory flags.
+            scripts_ok = state.Invalid(TxValidationResult::TX_NOT_STANDARD, strprintf("mempool-script-verify-flag-failed (%s)", ScriptErrorString(result->first)), result->second);
+        }
+    }
+    if (!scripts_ok) {
         // Detect a failure due to a missing witness so that p2p code can handle rejection caching appropriately.
         if (!tx.HasWitness() && SpendsNonAnchorWitnessProg(tx, m_view)) {
             state.Invalid(TxValidationResult::TX_WITNESS_STRIPPED,
@@ -1854,20 +1885,118 @@ CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
     return nSubsidy;
 }
 
+BlockLookahead::Result BlockLookahead::Fetch(const node::BlockManager& blockman, const CCoinsView& base, const FlatFilePos& pos, const uint256& hash)
+{
+    auto block{std::make_shared<CBlock>()};
+    if (!blockman.ReadBlock(*block, pos, hash)) return {};
+
+    Result result;
+    // Prevouts created earlier in the same block are not in the database yet.
+    std::unordered_set<Txid, SaltedTxidHasher> earlier_txids;
+    earlier_txids.reserve(block->vtx.size());
+    for (const auto& tx : block->vtx | std::views::drop(1)) {
+        for (const auto& input : tx->vin) {
+            if (earlier_txids.contains(input.prevout.hash)) continue;
+            if (auto coin{base.PeekCoin(input.prevout)}) result.coins.emplace_back(input.prevout, std::move(*coin));
+        }
+        earlier_txids.emplace(tx->GetHash());
+    }
+    result.block = std::move(block);
+    return result;
+}
+
+void BlockLookahead::Collect()
+{
+    for (auto& job : m_jobs) {
+        if (job.result || job.future.wait_for(std::chrono::seconds{0}) != std::future_status::ready) continue;
+        job.result = job.future.get();
+        size_t usage{RecursiveDynamicUsage(job.result->block) + memusage::DynamicUsage(job.result->coins)};
+        for (const auto& [_, coin] : job.result->coins) usage += coin.DynamicMemoryUsage();
+        m_usage = m_usage - job.usage + usage;
+        job.usage = usage;
+    }
+}
+
+void BlockLookahead::Schedule(const CBlockIndex& next, const CBlockIndex& target, uint64_t write_epoch)
+{
+    AssertLockHeld(::cs_main);
+    const auto workers_count{m_thread_pool.WorkersCount()};
+    if (workers_count == 0) return;
+    Collect();
+
+    // Existing jobs must continue the path from next to target, starting at next or its child.
+    if (!m_jobs.empty()) {
+        const CBlockIndex& front{*m_jobs.front().index};
+        const CBlockIndex& back{*m_jobs.back().index};
+        if (front.nHeight > next.nHeight + 1 || front.GetAncestor(next.nHeight) != &next ||
+            target.GetAncestor(back.nHeight) != &back) {
+            Clear();
+        }
+    }
+    // Leave at least half of the workers to the CoinsViewOverlay of the block being connected.
+    const auto max_in_flight{std::max<size_t>(1, workers_count / 2)};
+    size_t in_flight(std::ranges::count_if(m_jobs, [](const Job& job) { return !job.result; }));
+    int height{m_jobs.empty() ? next.nHeight : m_jobs.back().index->nHeight};
+    while (height < target.nHeight && m_jobs.size() < MAX_BLOCK_LOOKAHEAD_DEPTH && in_flight < max_in_flight &&
+           m_usage + MAX_BLOCK_SERIALIZED_SIZE <= MAX_BLOCK_LOOKAHEAD_BYTES) {
+        const CBlockIndex* index{Assert(target.GetAncestor(++height))};
+        if (!(index->nStatus & BLOCK_HAVE_DATA)) break;
+        auto future{m_thread_pool.Submit([&blockman = m_blockman, &base = m_base, pos = index->GetBlockPos(), hash = index->GetBlockHash()] {
+            return Fetch(blockman, base, pos, hash);
+        })};
+        if (!future) break;
+        m_jobs.push_back({.index = index, .write_epoch = write_epoch, .future = std::move(*future), .usage = MAX_BLOCK_SERIALIZED_SIZE});
+        m_usage += MAX_BLOCK_SERIALIZED_SIZE;
+        ++in_flight;
+    }
+}
+
+std::shared_ptr<const CBlock> BlockLookahead::Take(const CBlockIndex& index, CCoinsViewCache& cache, uint64_t write_epoch)
+{
+    if (m_jobs.empty()) return nullptr;
+    if (m_jobs.front().index != &index) {
+        // Keep the jobs if they are for descendants of index, otherwise the chain moved elsewhere.
+        if (m_jobs.front().index->GetAncestor(index.nHeight) != &index) Clear();
+        return nullptr;
+    }
+
+    Job job{std::move(m_jobs.front())};
+    m_jobs.pop_front();
+    m_usage -= job.usage;
+    Result result{job.result ? std::move(*job.result) : job.future.get()};
+    if (job.write_epoch == write_epoch) {
+        for (auto& [outpoint, coin] : result.coins) cache.EmplaceFetchedCoin(outpoint, std::move(coin));
+    } else {
+        LogDebug(BCLog::COINDB, "Discarding %u prefetched coins for block %s after a chainstate write", result.coins.size(), index.GetBlockHash().ToString());
+    }
+    return std::move(result.block);
+}
+
+void BlockLookahead::Clear()
+{
+    for (auto& job : m_jobs) {
+        if (job.future.valid()) job.future.wait();
+    }
+    m_jobs.clear();
+    m_usage = 0;
+}
+
 CoinsViews::CoinsViews(DBParams db_params, CoinsViewOptions options)
     : m_dbview{std::move(db_params), std::move(options)},
       m_catcherview(&m_dbview) {}
 
-void CoinsViews::InitCache(int32_t prevoutfetch_threads)
+void CoinsViews::InitCache(int32_t prevoutfetch_threads, const node::BlockManager& blockman)
 {
     AssertLockHeld(::cs_main);
+    m_block_lookahead.reset();
     m_cacheview = std::make_unique<CCoinsViewCache>(&m_catcherview);
-    auto thread_pool{std::make_shared<ThreadPool>("prevout")};
+    m_prevout_thread_pool = std::make_shared<ThreadPool>("prevout");
     if (prevoutfetch_threads > 0) {
-        thread_pool->Start(prevoutfetch_threads);
-        LogInfo("Block input prevout fetching uses %d additional threads", prevoutfetch_threads);
+        m_prevout_thread_pool->Start(prevoutfetch_threads);
+        LogInfo("Block and mempool input prevout fetching uses %d additional threads", prevoutfetch_threads);
     }
-    m_connect_block_view = std::make_unique<CoinsViewOverlay>(&*m_cacheview, std::move(thread_pool));
+    m_block_lookahead = std::make_unique<BlockLookahead>(blockman, m_catcherview, *m_prevout_thread_pool);
+    m_connect_block_view = std::make_unique<CoinsViewOverlay>(&*m_cacheview, m_prevout_thread_pool);
 }
 
 Chainstate::Chainstate(
@@ -1943,7 +2072,7 @@ void Chainstate::InitCoinsCache(size_t cache_size_bytes)
     AssertLockHeld(::cs_main);
     assert(m_coins_views != nullptr);
     m_coinstip_cache_size_bytes = cache_size_bytes;
-    m_coins_views->InitCache(m_chainman.m_options.prevoutfetch_threads_num);
+    m_coins_views->InitCache(m_chainman.m_options.prevoutfetch_threads_num, m_blockman);
 }
 
 // Lock-free: depends on `m_cached_is_ibd`, which is latched by `UpdateIBDStatus()`.
@@ -3033,6 +3162,8 @@ bool Chainstate::ConnectTip(
     assert(pindexNew->pprev == m_chain.Tip());
     // Read block from disk.
     const auto time_1{SteadyClock::now()};
+    auto block_lookahead{m_coins_views->m_block_lookahead->Take(*pindexNew, CoinsTip(), CoinsDB().GetWriteEpoch())};
+    if (!block_to_connect) block_to_connect = std::move(block_lookahead);
     if (!block_to_connect) {
         std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
         if (!m_blockman.ReadBlock(*pblockNew, *pindexNew)) {
@@ -3252,6 +3383,9 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex&
 
         // Connect new blocks.
         for (CBlockIndex* pindexConnect : vpindexToConnect | std::views::reverse) {
+            if (m_chainman.IsInitialBlockDownload()) {
+                m_coins_views->m_block_lookahead->Schedule(*pindexConnect, index_most_work, CoinsDB().GetWriteEpoch());
+            }
             if (!ConnectTip(state, pindexConnect, pindexConnect == &index_most_work ? pblock : std::shared_ptr<const CBlock>(), connected_blocks, disconnectpool)) {
                 if (state.IsInvalid()) {
                     // The block violates a consensus rule.
@@ -5496,6 +5630,8 @@ bool Chainstate::ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
     size_t old_coinstip_size = m_coinstip_cache_size_bytes;
     m_coinstip_cache_size_bytes = coinstip_size;
     m_coinsdb_cache_size_bytes = coinsdb_size;
+    // Lookahead jobs read from the database that is about to be reopened.
+    m_coins_views->m_block_lookahead->Clear();
     CoinsDB().ResizeCache(coinsdb_size);
 
     LogInfo("[%s] resized coinsdb cache to %.1f MiB",
@@ -5767,6 +5903,9 @@ static void FlushSnapshotToDisk(CCoinsViewCache& coins_cache, bool snapshot_load
     coins_cache.Flush();
 }
 
+/** Read buffer size for loading a UTXO snapshot. */
+static constexpr size_t SNAPSHOT_READ_BUFFER_SIZE{1 << 20};
+
 struct StopHashingException : public std::exception
 {
     const char* what() const noexcept override
@@ -5823,12 +5962,20 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     LogInfo("[snapshot] loading %d coins from snapshot %s", coins_left, base_blockhash.ToString());
     int64_t coins_processed{0};
 
+    // Coins that come in the order of the coins database, as dumptxoutset writes them, are hashed while they are
+    // loaded, which saves reading the whole set back from disk to validate it.
+    HashWriter coins_hash{};
+    std::optional<COutPoint> last_outpoint;
+    bool coins_in_order{true};
+
+    BufferedReader coins_reader{std::move(coins_file), SNAPSHOT_READ_BUFFER_SIZE};
+
     while (coins_left > 0) {
         try {
             Txid txid;
-            coins_file >> txid;
+            coins_reader >> txid;
             size_t coins_per_txid{0};
-            coins_per_txid = ReadCompactSize(coins_file);
+            coins_per_txid = ReadCompactSize(coins_reader);
 
             if (coins_per_txid > coins_left) {
                 return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
@@ -5837,9 +5984,9 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
             for (size_t i = 0; i < coins_per_txid; i++) {
                 COutPoint outpoint;
                 Coin coin;
-                outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
+                outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_reader));
                 outpoint.hash = txid;
-                coins_file >> coin;
+                coins_reader >> coin;
                 if (coin.nHeight > base_height ||
                     outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
                 ) {
@@ -5850,6 +5997,13 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
                     return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value",
                               coins_count - coins_left))};
                 }
+                if (coins_in_order) {
+                    // A strictly increasing order also rules out duplicates, so the hashed coins are exactly the
+                    // ones that end up in the database.
+                    coins_in_order = !last_outpoint || *last_outpoint < outpoint;
+                    if (coins_in_order) kernel::ApplyCoinHash(coins_hash, outpoint, coin);
+                    last_outpoint = outpoint;
+                }
                 coins_cache.EmplaceCoinInternalDANGER(outpoint, std::move(coin));
 
                 --coins_left;
@@ -5901,7 +6055,7 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     bool out_of_coins{false};
     try {
         std::byte left_over_byte;
-        coins_file >> left_over_byte;
+        coins_reader >> left_over_byte;
     } catch (const std::ios_base::failure&) {
         // We expect an exception since we should be out of coins.
         out_of_coins = true;
@@ -5921,26 +6075,35 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
 
     assert(coins_cache.GetBestBlock() == base_blockhash);
 
-    // As above, okay to immediately release cs_main here since no other context knows
-    // about the snapshot_chainstate.
-    const CCoinsViewDB& snapshot_coinsdb = WITH_LOCK(::cs_main, return snapshot_chainstate.CoinsDB());
+    uint256 hash_serialized;
+    if (coins_in_order) {
+        hash_serialized = coins_hash.GetHash();
+    } else {
+        LogInfo("[snapshot] coins are not in database order, hashing them from disk");
 
-    std::optional<CCoinsStats> maybe_stats;
+        // As above, okay to immediately release cs_main here since no other context knows
+        // about the snapshot_chainstate.
+        const CCoinsViewDB& snapshot_coinsdb = WITH_LOCK(::cs_main, return snapshot_chainstate.CoinsDB());
 
-    try {
-        maybe_stats = ComputeUTXOStats(
-            CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
-    } catch (StopHashingException const&) {
-        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-    }
-    if (!maybe_stats.has_value()) {
-        return util::Error{Untranslated("Failed to generate coins stats")};
+        std::optional<CCoinsStats> maybe_stats;
+
+        try {
+            maybe_stats = ComputeUTXOStats(
+                CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); },
+                m_options.utxo_scan_threads);
+        } catch (StopHashingException const&) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
+        if (!maybe_stats.has_value()) {
+            return util::Error{Untranslated("Failed to generate coins stats")};
+        }
+        hash_serialized = maybe_stats->hashSerialized;
     }
 
     // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
+    if (AssumeutxoHash{hash_serialized} != au_data.hash_serialized) {
         return util::Error{Untranslated(strprintf("Bad snapshot content hash: expected %s, got %s",
-            au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString()))};
+            au_data.hash_serialized.ToString(), hash_serialized.ToString()))};
     }
 
     snapshot_chainstate.m_chain.SetTip(*snapshot_start_block);
@@ -6066,7 +6229,8 @@ SnapshotCompletionResult ChainstateManager::MaybeValidateSnapshot(Chainstate& va
             CoinStatsHashType::HASH_SERIALIZED,
             validated_coins_db,
             m_blockman,
-            [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
+            [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); },
+            m_options.utxo_scan_threads);
     } catch (StopHashingException const&) {
         return SnapshotCompletionResult::STATS_FAILED;
     }
@@ -41,6 +41,8 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <map>
 #include <memory>
 #include <optional>
@@ -89,9 +91,16 @@ inline constexpr uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES{550_MiB};
 /** Maximum number of dedicated script-checking threads allowed */
 inline constexpr int MAX_SCRIPTCHECK_THREADS{15};
 
+/** Minimum number of inputs for a mempool transaction's scripts to be verified by the script-checking threads,
+ * if enabled. Below this, dispatching the checks costs more than running them directly. */
+inline constexpr size_t MIN_PARALLEL_MEMPOOL_SCRIPT_CHECK_INPUTS{8};
+
 /** Maximum number of dedicated threads allowed for prefetching block input prevouts */
 inline constexpr int32_t MAX_PREVOUTFETCH_THREADS{16};
 
+/** Maximum number of threads used to scan the UTXO set */
+inline constexpr int32_t MAX_UTXO_SCAN_THREADS{15};
+
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
     INIT_REINDEX,
@@ -470,6 +479,93 @@ enum class FlushStateMode: uint8_t {
     FORCE_SYNC,
 };
 
+/** Maximum number of blocks read ahead of the tip by BlockLookahead. */
+static constexpr int MAX_BLOCK_LOOKAHEAD_DEPTH{16};
+/** Memory budget for blocks and coins held by BlockLookahead. */
+static constexpr size_t MAX_BLOCK_LOOKAHEAD_BYTES{64_MiB};
+
+/**
+ * Reads blocks that are about to be connected from disk and fetches their input prevouts from the chainstate
+ * database on the prevout thread pool, while earlier blocks are still being connected.
+ *
+ * Schedule() is called with the block about to be connected and the block the chain is moving towards, and
+ * starts one background job per upcoming block as long as the budget allows. Take() hands the result for a
+ * block back to the validation thread right before that block is connected, and adds the fetched coins to the
+ * coins cache. Coins are only added if the chainstate database was not written to since the job was started
+ * (see CCoinsViewDB::GetWriteEpoch()), and never replace an entry that is already cached, so they can't shadow
+ * changes made by blocks connected in the meantime.
+ *
+ * Memory is bounded by MAX_BLOCK_LOOKAHEAD_BYTES: jobs in flight are accounted for at the worst case size of a
+ * serialized block, completed jobs at their measured memory usage.
+ *
+ * All methods must be called from the validation thread.
+ */
+class BlockLookahead
+{
+private:
+    struct Result {
+        //! The block read from disk, or nullptr if it could not be read.
+        std::shared_ptr<const CBlock> block;
+        //! The unspent prevouts of the block that exist in the chainstate database.
+        std::vector<std::pair<COutPoint, Coin>> coins;
+    };
+
+    struct Job {
+        const CBlockIndex* index;
+        //! CCoinsViewDB::GetWriteEpoch() at the time the job was started.
+        uint64_t write_epoch;
+        std::future<Result> future;
+        //! Set once the job is completed.
+        std::optional<Result> result{};
+        //! Memory accounted for this job.
+        size_t usage;
+    };
+
+    const node::BlockManager& m_blockman;
+    const CCoinsView& m_base;
+    ThreadPool& m_thread_pool;
+    //! Jobs in ascending height order.
+    std::deque<Job> m_jobs;
+    size_t m_usage{0};
+
+    static Result Fetch(const node::BlockManager& blockman, const CCoinsView& base, const FlatFilePos& pos, const uint256& hash);
+
+    //! Move the results of completed jobs out of their futures and account for their actual memory usage.
+    void Collect();
+
+public:
+    BlockLookahead(const node::BlockManager& blockman LIFETIMEBOUND, const CCoinsView& base LIFETIMEBOUND, ThreadPool& thread_pool LIFETIMEBOUND)
+        : m_blockman{blockman}, m_base{base}, m_thread_pool{thread_pool} {}
+    ~BlockLookahead() { Clear(); }
+
+    /**
+     * Start jobs for the blocks after next on the way to target that have data on disk.
+     *
+     * @param[in] next         The block about to be connected.
+     * @param[in] target       A descendant of next that the chain is moving towards.
+     * @param[in] write_epoch  The current CCoinsViewDB::GetWriteEpoch().
+     */
+    void Schedule(const CBlockIndex& next, const CBlockIndex& target, uint64_t write_epoch) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /**
+     * Wait for the job for index, if any, and add its coins to cache.
+     *
+     * Jobs that are not for index or one of its descendants are discarded.
+     *
+     * @param[in] index        The block about to be connected.
+     * @param[in] cache        The cache on top of the chainstate database to add the coins to.
+     * @param[in] write_epoch  The current CCoinsViewDB::GetWriteEpoch().
+     * @returns the block read from disk, or nullptr if no job for index was scheduled or the block could not be read.
+     */
+    std::shared_ptr<const CBlock> Take(const CBlockIndex& index, CCoinsViewCache& cache, uint64_t write_epoch);
+
+    //! Wait for and discard all jobs. Must be called before the chainstate database is reopened.
+    void Clear();
+
+    //! Number of blocks scheduled or completed.
+    size_t Size() const { return m_jobs.size(); }
+};
+
 /**
  * A convenience class for constructing the CCoinsView* hierarchy used
  * to facilitate access to the UTXO set.
@@ -493,6 +589,14 @@ public:
     //! can fit per the dbcache setting.
     std::unique_ptr<CCoinsViewCache> m_cacheview GUARDED_BY(cs_main);
 
+    //! Workers used to fetch input prevouts from the chainstate database in parallel, both for blocks connected
+    //! through m_connect_block_view and for transactions submitted to the mempool. May have zero workers.
+    std::shared_ptr<ThreadPool> m_prevout_thread_pool;
+
+    //! Reads upcoming blocks and their prevouts ahead of ConnectTip(). Declared after m_prevout_thread_pool so
+    //! its jobs are waited for before the pool is destroyed.
+    std::unique_ptr<BlockLookahead> m_block_lookahead;
+
     //! Reused CoinsViewOverlay layered on top of m_cacheview and passed to ConnectBlock().
     //! Reset between calls and flushed only on success, so invalid blocks don't pollute the underlying cache.
     std::unique_ptr<CoinsViewOverlay> m_connect_block_view GUARDED_BY(cs_main);
@@ -506,7 +610,7 @@ public:
     CoinsViews(DBParams db_params, CoinsViewOptions options);
 
     //! Initialize the CCoinsViewCache member.
-    void InitCache(int32_t prevoutfetch_threads) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    void InitCache(int32_t prevoutfetch_threads, const node::BlockManager& blockman) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
 
 enum class CoinsCacheSizeState
@@ -700,6 +804,13 @@ public:
         return Assert(m_coins_views)->m_dbview;
     }
 
+    //! @returns A reference to the thread pool used to fetch input prevouts in parallel.
+    ThreadPool& PrevoutThreadPool() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        AssertLockHeld(::cs_main);
+        return *Assert(Assert(m_coins_views)->m_prevout_thread_pool);
+    }
+
     //! @returns A pointer to the mempool.
     CTxMemPool* GetMempool()
     {
@@ -15,14 +15,27 @@
 #include <util/check.h>
 #include <util/log.h>
 #include <util/task_runner.h>
+#include <util/thread.h>
+#include <util/time.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <future>
+#include <list>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
 using kernel::ChainstateRole;
 
+void CValidationInterface::TransactionsAddedToMempool(std::span<const std::pair<NewMempoolTransactionInfo, uint64_t>> txs)
+{
+    for (const auto& [tx, mempool_sequence] : txs) TransactionAddedToMempool(tx, mempool_sequence);
+}
+
 /**
  * ValidationSignalsImpl manages a list of shared_ptr<CValidationInterface> callbacks.
  *
@@ -30,41 +43,217 @@ using kernel::ChainstateRole;
  * registered, and a std::list is used to store the callbacks that are
  * currently registered as well as any callbacks that are just unregistered
  * and about to be deleted when they are done executing.
+ *
+ * Callbacks registered with a queue of their own are handed their
+ * notifications through a SubscriberQueue instead of being called directly.
  */
 class ValidationSignalsImpl
 {
+public:
+    /** A notification on its way to the subscribers. */
+    struct Notification {
+        //! Delivers the notification to one subscriber.
+        std::function<void(CValidationInterface&)> call{};
+        //! Set instead of call for TransactionAddedToMempool, so that subscriber queues can deliver those in batches.
+        std::optional<std::pair<NewMempoolTransactionInfo, uint64_t>> tx_added{};
+
+        void Deliver(CValidationInterface& callbacks) const
+        {
+            if (tx_added) {
+                callbacks.TransactionAddedToMempool(tx_added->first, tx_added->second);
+            } else {
+                call(callbacks);
+            }
+        }
+    };
+
 private:
+    //! Maximum number of TransactionAddedToMempool notifications coalesced into one TransactionsAddedToMempool call.
+    static constexpr size_t MAX_TX_ADDED_BATCH{1000};
+
+    /**
+     * Delivers the notifications of one subscriber on a thread of its own, in order, so that a slow subscriber only holds
+     * up itself. TransactionAddedToMempool notifications that piled up behind each other are delivered in one call.
+     */
+    class SubscriberQueue
+    {
+    public:
+        const std::string m_name;
+
+    private:
+        struct Entry {
+            std::shared_ptr<const Notification> notification;
+            SteadyClock::time_point queued;
+        };
+
+        Mutex m_mutex;
+        std::condition_variable m_cond;
+        std::deque<Entry> m_entries GUARDED_BY(m_mutex);
+        //! Time at which the notifications being delivered right now were queued, and how many of them there are.
+        std::optional<SteadyClock::time_point> m_in_flight GUARDED_BY(m_mutex);
+        size_t m_in_flight_count GUARDED_BY(m_mutex){0};
+        //! Number of notifications pushed, and number of those delivered or dropped.
+        uint64_t m_pushed GUARDED_BY(m_mutex){0};
+        uint64_t m_done GUARDED_BY(m_mutex){0};
+        bool m_stopped GUARDED_BY(m_mutex){false};
+        //! Only accessed by the queue's thread, which releases it after the last callback.
+        std::shared_ptr<CValidationInterface> m_callbacks;
+        std::thread m_thread;
+
+        void Run() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+        {
+            WAIT_LOCK(m_mutex, lock);
+            while (true) {
+                m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stopped || !m_entries.empty(); });
+                if (m_stopped) break;
+
+                std::vector<std::shared_ptr<const Notification>> batch;
+                m_in_flight = m_entries.front().queued;
+                do {
+                    batch.push_back(std::move(m_entries.front().notification));
+                    m_entries.pop_front();
+                } while (batch.front()->tx_added && batch.size() < MAX_TX_ADDED_BATCH && !m_entries.empty() && m_entries.front().notification->tx_added);
+                m_in_flight_count = batch.size();
+                {
+                    REVERSE_LOCK(lock, m_mutex);
+                    if (batch.size() == 1) {
+                        batch.front()->Deliver(*m_callbacks);
+                    } else {
+                        std::vector<std::pair<NewMempoolTransactionInfo, uint64_t>> txs;
+                        txs.reserve(batch.size());
+                        for (const auto& notification : batch) txs.push_back(*notification->tx_added);
+                        m_callbacks->TransactionsAddedToMempool(txs);
+                    }
+                }
+                m_in_flight.reset();
+                m_in_flight_count = 0;
+                m_done += batch.size();
+                m_cond.notify_all();
+                // Releasing a marker may call a function, see CallAfterQueues().
+                REVERSE_LOCK(lock, m_mutex);
+                batch.clear();
+            }
+            // Notifications that were not delivered yet are dropped, like they are for unregistered subscribers without
+            // a queue of their own.
+            m_done += m_entries.size();
+            auto dropped{std::move(m_entries)};
+            m_entries.clear();
+            m_cond.notify_all();
+            REVERSE_LOCK(lock, m_mutex);
+            dropped.clear();
+            m_callbacks.reset();
+        }
+
+    public:
+        SubscriberQueue(std::string name, std::shared_ptr<CValidationInterface> callbacks)
+            : m_name{std::move(name)}, m_callbacks{std::move(callbacks)} {}
+
+        //! Start the thread delivering the notifications. The thread keeps the queue alive until it exits.
+        static std::shared_ptr<SubscriberQueue> Start(std::string name, std::shared_ptr<CValidationInterface> callbacks)
+        {
+            auto queue{std::make_shared<SubscriberQueue>(std::move(name), std::move(callbacks))};
+            queue->m_thread = std::thread(&util::TraceThread, "valq." + queue->m_name, [queue] { queue->Run(); });
+            return queue;
+        }
+
+        void Push(std::shared_ptr<const Notification> notification) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+        {
+            LOCK(m_mutex);
+            if (m_stopped) return;
+            m_entries.push_back({std::move(notification), SteadyClock::now()});
+            ++m_pushed;
+            m_cond.notify_all();
+        }
+
+        //! Wait until everything pushed so far has been delivered (or dropped).
+        void WaitForPushed() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+        {
+            WAIT_LOCK(m_mutex, lock);
+            const uint64_t target{m_pushed};
+            m_cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_done >= target; });
+        }
+
+        /**
+         * Stop delivering notifications, and wait for a callback in progress to return. Must be called exactly once.
+         * When called from within a callback of this queue, the thread is left to exit on its own after it returns.
+         */
+        void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+        {
+            WITH_LOCK(m_mutex, m_stopped = true; m_cond.notify_all());
+            if (m_thread.get_id() == std::this_thread::get_id()) {
+                m_thread.detach();
+            } else {
+                m_thread.join();
+            }
+        }
+
+        ValidationSignals::QueueInfo GetInfo() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+        {
+            LOCK(m_mutex);
+            ValidationSignals::QueueInfo info{.name = m_name, .pending = m_entries.size() + m_in_flight_count, .delivered = m_done};
+            const auto oldest{m_in_flight ? m_in_flight : m_entries.empty() ? std::nullopt : std::optional{m_entries.front().queued}};
+            if (oldest) info.lag = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - *oldest);
+            return info;
+        }
+    };
+
     Mutex m_mutex;
     //! List entries consist of a callback pointer and reference count. The
     //! count is equal to the number of current executions of that entry, plus 1
     //! if it's registered. It cannot be 0 because that would imply it is
     //! unregistered and also not being executed (so shouldn't exist).
-    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; };
+    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; std::shared_ptr<SubscriberQueue> queue; };
     std::list<ListEntry> m_list GUARDED_BY(m_mutex);
     std::unordered_map<CValidationInterface*, std::list<ListEntry>::iterator> m_map GUARDED_BY(m_mutex);
 
+    std::vector<std::shared_ptr<SubscriberQueue>> GetQueues() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        std::vector<std::shared_ptr<SubscriberQueue>> queues;
+        for (const auto& entry : m_list) {
+            if (entry.queue) queues.push_back(entry.queue);
+        }
+        return queues;
+    }
+
+    //! Drop the registration of an entry. Returns its queue, which the caller must stop outside of m_mutex.
+    std::shared_ptr<SubscriberQueue> Release(std::list<ListEntry>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        auto queue{std::move(it->queue)};
+        if (!--it->count) m_list.erase(it);
+        return queue;
+    }
+
 public:
     std::unique_ptr<util::TaskRunnerInterface> m_task_runner;
 
     explicit ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner)
         : m_task_runner{std::move(Assert(task_runner))} {}
 
-    void Register(std::shared_ptr<CValidationInterface> callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    ~ValidationSignalsImpl() { Clear(); }
+
+    void Register(std::shared_ptr<CValidationInterface> callbacks, std::optional<std::string> queue_name) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         LOCK(m_mutex);
         auto inserted = m_map.emplace(callbacks.get(), m_list.end());
         if (inserted.second) inserted.first->second = m_list.emplace(m_list.end());
-        inserted.first->second->callbacks = std::move(callbacks);
+        auto& entry{*inserted.first->second};
+        if (queue_name && !entry.queue) entry.queue = SubscriberQueue::Start(std::move(*queue_name), callbacks);
+        entry.callbacks = std::move(callbacks);
     }
 
     void Unregister(CValidationInterface* callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        LOCK(m_mutex);
-        auto it = m_map.find(callbacks);
-        if (it != m_map.end()) {
-            if (!--it->second->count) m_list.erase(it->second);
-            m_map.erase(it);
+        std::shared_ptr<SubscriberQueue> queue;
+        {
+            LOCK(m_mutex);
+            auto it = m_map.find(callbacks);
+            if (it != m_map.end()) {
+                queue = Release(it->second);
+                m_map.erase(it);
+            }
         }
+        if (queue) queue->Stop();
     }
 
     //! Clear unregisters every previously registered callback, erasing every
@@ -73,11 +262,15 @@ public:
     //! executing.
     void Clear() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        LOCK(m_mutex);
-        for (const auto& entry : m_map) {
-            if (!--entry.second->count) m_list.erase(entry.second);
+        std::vector<std::shared_ptr<SubscriberQueue>> queues;
+        {
+            LOCK(m_mutex);
+            for (const auto& entry : m_map) {
+                if (auto queue{Release(entry.second)}) queues.push_back(std::move(queue));
+            }
+            m_map.clear();
         }
-        m_map.clear();
+        for (const auto& queue : queues) queue->Stop();
     }
 
     template<typename F> void Iterate(F&& f) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
@@ -92,6 +285,55 @@ public:
             it = --it->count ? std::next(it) : m_list.erase(it);
         }
     }
+
+    //! Call the subscribers without a queue of their own, and push the notification onto the other ones' queues.
+    void Deliver(const std::shared_ptr<const Notification>& notification) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        for (auto it = m_list.begin(); it != m_list.end();) {
+            if (it->queue) {
+                it->queue->Push(notification);
+                ++it;
+                continue;
+            }
+            ++it->count;
+            {
+                REVERSE_LOCK(lock, m_mutex);
+                notification->Deliver(*it->callbacks);
+            }
+            it = --it->count ? std::next(it) : m_list.erase(it);
+        }
+    }
+
+    /**
+     * Call func once the subscriber queues have delivered (or dropped) everything pushed onto them so far, without
+     * waiting for them: a marker holding func is pushed onto each queue, and func is called by whichever thread releases
+     * the last one. If there are no subscriber queues, func is called right away.
+     */
+    void CallAfterQueues(std::function<void()> func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        struct CallOnRelease {
+            std::function<void()> func;
+            ~CallOnRelease() { func(); }
+        };
+        auto marker{std::make_shared<const Notification>(Notification{
+            .call = [release = std::make_shared<CallOnRelease>(std::move(func))](CValidationInterface&) {},
+        })};
+        for (const auto& queue : GetQueues()) queue->Push(marker);
+    }
+
+    //! Wait until the subscriber queues have delivered everything pushed onto them so far.
+    void WaitForQueues() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        for (const auto& queue : GetQueues()) queue->WaitForPushed();
+    }
+
+    std::vector<ValidationSignals::QueueInfo> GetQueueInfo() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<ValidationSignals::QueueInfo> info;
+        for (const auto& queue : GetQueues()) info.push_back(queue->GetInfo());
+        return info;
+    }
 };
 
 ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner)
@@ -102,18 +344,36 @@ ValidationSignals::~ValidationSignals() = default;
 void ValidationSignals::FlushBackgroundCallbacks()
 {
     m_internals->m_task_runner->flush();
+    m_internals->WaitForQueues();
 }
 
 size_t ValidationSignals::CallbacksPending()
+{
+    size_t queued{0};
+    for (const auto& info : m_internals->GetQueueInfo()) queued = std::max(queued, info.pending);
+    return SharedCallbacksPending() + queued;
+}
+
+size_t ValidationSignals::SharedCallbacksPending()
 {
     return m_internals->m_task_runner->size();
 }
 
+std::vector<ValidationSignals::QueueInfo> ValidationSignals::GetQueueInfo()
+{
+    return m_internals->GetQueueInfo();
+}
+
 void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
 {
     // Each connection captures the shared_ptr to ensure that each callback is
     // executed before the subscriber is destroyed. For more details see #18338.
-    m_internals->Register(std::move(callbacks));
+    m_internals->Register(std::move(callbacks), /*queue_name=*/std::nullopt);
+}
+
+void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks, std::string queue_name)
+{
+    m_internals->Register(std::move(callbacks), std::move(queue_name));
 }
 
 void ValidationSignals::RegisterValidationInterface(CValidationInterface* callbacks)
@@ -123,6 +383,11 @@ void ValidationSignals::RegisterValidationInterface(CValidationInterface* callba
     RegisterSharedValidationInterface({callbacks, [](CValidationInterface*){}});
 }
 
+void ValidationSignals::RegisterValidationInterface(CValidationInterface* callbacks, std::string queue_name)
+{
+    RegisterSharedValidationInterface({callbacks, [](CValidationInterface*){}}, std::move(queue_name));
+}
+
 void ValidationSignals::UnregisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
 {
     UnregisterValidationInterface(callbacks.get());
@@ -140,7 +405,11 @@ void ValidationSignals::UnregisterAllValidationInterfaces()
 
 void ValidationSignals::CallFunctionInValidationInterfaceQueue(std::function<void()> func)
 {
-    m_internals->m_task_runner->insert(std::move(func));
+    // Subscribers with a queue of their own may lag behind the shared queue. Rather than blocking the shared queue
+    // until they catch up, leave it to them to call func once they have.
+    m_internals->m_task_runner->insert([this, func = std::move(func)]() mutable {
+        m_internals->CallAfterQueues(std::move(func));
+    });
 }
 
 void ValidationSignals::SyncWithValidationInterfaceQueue()
@@ -164,9 +433,10 @@ void ValidationSignals::SyncWithValidationInterfaceQueue()
                       "log_msg must be passed as an rvalue");                                                    \
         auto enqueue_log_msg = (log_msg);                                                                        \
         LOG_EVENT("Enqueuing %s", enqueue_log_msg);                                                              \
-        m_internals->m_task_runner->insert([local_log_msg = std::move(enqueue_log_msg), local_event = (event)] { \
+        m_internals->m_task_runner->insert([local_log_msg = std::move(enqueue_log_msg),                           \
+                                            local_event = std::make_shared<const ValidationSignalsImpl::Notification>((event)), this] { \
             LOG_EVENT("%s", local_log_msg);                                                                      \
-            local_event();                                                                                       \
+            m_internals->Deliver(local_event);                                                                   \
         });                                                                                                      \
     } while (0)
 
@@ -185,9 +455,7 @@ void ValidationSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlo
                           pindexNew->GetBlockHash().ToString(),
                           pindexFork ? pindexFork->GetBlockHash().ToString() : "null",
                           fInitialDownload);
-    auto event = [pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
-    };
+    ValidationSignalsImpl::Notification event{.call = [pindexNew, pindexFork, fInitialDownload](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); }};
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
 
@@ -202,9 +470,7 @@ void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInf
     auto log_msg = LOG_MSG("%s: txid=%s wtxid=%s", __func__,
                           tx.info.m_tx->GetHash().ToString(),
                           tx.info.m_tx->GetWitnessHash().ToString());
-    auto event = [tx, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
-    };
+    ValidationSignalsImpl::Notification event{.tx_added = std::pair{tx, mempool_sequence}};
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
 
@@ -213,9 +479,7 @@ void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx,
                           tx->GetHash().ToString(),
                           tx->GetWitnessHash().ToString(),
                           RemovalReasonToString(reason));
-    auto event = [tx, reason, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
-    };
+    ValidationSignalsImpl::Notification event{.call = [tx, reason, mempool_sequence](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); }};
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
 
@@ -224,9 +488,7 @@ void ValidationSignals::BlockConnected(const ChainstateRole& role, std::shared_p
     auto log_msg = LOG_MSG("%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
                           pindex->nHeight);
-    auto event = [role, pblock = std::move(pblock), pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(role, pblock, pindex); });
-    };
+    ValidationSignalsImpl::Notification event{.call = [role, pblock = std::move(pblock), pindex](CValidationInterface& callbacks) { callbacks.BlockConnected(role, pblock, pindex); }};
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
 
@@ -238,9 +500,7 @@ void ValidationSignals::MempoolTransactionsRemovedForBlock(std::shared_ptr<const
                            block_height,
                            txs_removed_for_block.size(),
                            block->vtx.size());
-    auto event = [block = std::move(block), txs_removed_for_block = std::move(txs_removed_for_block), block_height, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MempoolTransactionsRemovedForBlock(block, txs_removed_for_block, block_height); });
-    };
+    ValidationSignalsImpl::Notification event{.call = [block = std::move(block), txs_removed_for_block = std::move(txs_removed_for_block), block_height](CValidationInterface& callbacks) { callbacks.MempoolTransactionsRemovedForBlock(block, txs_removed_for_block, block_height); }};
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
 
@@ -249,9 +509,7 @@ void ValidationSignals::BlockDisconnected(std::shared_ptr<const CBlock> pblock,
     auto log_msg = LOG_MSG("%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
                           pindex->nHeight);
-    auto event = [pblock = std::move(pblock), pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
-    };
+    ValidationSignalsImpl::Notification event{.call = [pblock = std::move(pblock), pindex](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); }};
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
 
@@ -259,9 +517,7 @@ void ValidationSignals::ChainStateFlushed(const ChainstateRole& role, const CBlo
 {
     auto log_msg = LOG_MSG("%s: block hash=%s", __func__,
                           locator.IsNull() ? "null" : locator.vHave.front().ToString());
-    auto event = [role, locator, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(role, locator); });
-    };
+    ValidationSignalsImpl::Notification event{.call = [role, locator](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(role, locator); }};
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
 
@@ -11,10 +11,15 @@
 #include <sync.h>
 #include <uint256.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace kernel {
@@ -74,6 +79,15 @@ protected:
      * Called on a background thread.
      */
     virtual void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) {}
+    /**
+     * Notifies listeners of several transactions having been added to mempool, in the order they were added.
+     *
+     * Subscribers registered with a queue of their own receive TransactionAddedToMempool notifications that piled up
+     * in their queue through this. The default implementation calls TransactionAddedToMempool for each transaction.
+     *
+     * Called on a background thread.
+     */
+    virtual void TransactionsAddedToMempool(std::span<const std::pair<NewMempoolTransactionInfo, uint64_t>> txs);
 
     /**
      * Notifies listeners of a transaction leaving mempool.
@@ -162,6 +176,7 @@ protected:
      */
     virtual void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& block) {};
     friend class ValidationSignals;
+    friend class ValidationSignalsImpl;
     friend class ValidationInterfaceTest;
 };
 
@@ -178,13 +193,34 @@ public:
 
     ~ValidationSignals();
 
-    /** Call any remaining callbacks on the calling thread */
+    /** Call any remaining callbacks on the calling thread, and wait for the subscriber queues to drain */
     void FlushBackgroundCallbacks();
 
+    /** Number of pending callbacks: those in the shared queue plus the backlog of the most lagging subscriber queue */
     size_t CallbacksPending();
+    /** Number of callbacks pending in the shared queue */
+    size_t SharedCallbacksPending();
+
+    /** State of a subscriber queue, see RegisterValidationInterface(). */
+    struct QueueInfo {
+        std::string name;
+        //! Notifications queued or being delivered.
+        size_t pending{0};
+        //! Notifications delivered so far.
+        uint64_t delivered{0};
+        //! How long ago the oldest pending notification was queued.
+        std::optional<std::chrono::milliseconds> lag{};
+    };
+    std::vector<QueueInfo> GetQueueInfo();
 
     /** Register subscriber */
     void RegisterValidationInterface(CValidationInterface* callbacks);
+    /**
+     * Register subscriber with a queue and thread of its own, so that it neither holds up nor is held up by other
+     * subscribers. Its TransactionAddedToMempool notifications may be delivered in batches. Unregistering it waits
+     * for a callback in progress to return, unless done from within that callback.
+     */
+    void RegisterValidationInterface(CValidationInterface* callbacks, std::string queue_name);
     /** Unregister subscriber. DEPRECATED. This is not safe to use when the RPC server or main message handler thread is running. */
     void UnregisterValidationInterface(CValidationInterface* callbacks);
     /** Unregister all subscribers */
@@ -196,12 +232,16 @@ public:
     // processed.
     /** Register subscriber */
     void RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks);
+    /** Register subscriber with a queue of its own */
+    void RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks, std::string queue_name);
     /** Unregister subscriber */
     void UnregisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks);
 
     /**
      * Pushes a function to callback onto the notification queue, guaranteeing any
      * callbacks generated prior to now are finished when the function is called.
+     * The function is called on the thread of the shared queue, or on that of the
+     * subscriber queue that caught up last.
      *
      * Be very careful blocking on func to be called if any locks are held -
      * validation interface clients may not be able to make progress as they often
@@ -248,9 +248,11 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse,
     bool allow_used_addresses = !avoid_reuse || !wallet.IsWalletFlagSet(WALLET_FLAG_AVOID_REUSE);
     {
         LOCK(wallet.cs_wallet);
+        if (auto cached{wallet.GetCachedBalance(min_depth, allow_used_addresses, include_nonmempool)}) return *cached;
         std::set<Txid> trusted_parents;
-        for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
-            const CWalletTx& wtx = txo.GetWalletTx();
+        // Outputs spent by confirmed transactions never count towards the balance
+        for (const auto& [outpoint, txo] : wallet.GetUnspentTXOs()) {
+            const CWalletTx& wtx = txo->GetWalletTx();
 
             const bool is_trusted{CachedTxIsTrusted(wallet, wtx, trusted_parents)};
             const int tx_depth{wallet.GetTxDepthInMainChain(wtx)};
@@ -278,9 +280,9 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse,
                 }
                 if (bucket) {
                     // Get the amounts for mine
-                    CAmount credit_mine = txo.GetTxOut().nValue;
+                    CAmount credit_mine = txo->GetTxOut().nValue;
 
-                    if (!allow_used_addresses && wallet.IsSpentKey(txo.GetTxOut().scriptPubKey)) {
+                    if (!allow_used_addresses && wallet.IsSpentKey(txo->GetTxOut().scriptPubKey)) {
                         bucket = &ret.m_mine_used;
                     }
                     *bucket += credit_mine;
@@ -290,6 +292,7 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse,
                 }
             }
         }
+        wallet.CacheBalance(min_depth, allow_used_addresses, include_nonmempool, ret);
     }
     return ret;
 }
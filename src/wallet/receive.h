@@ -8,6 +8,7 @@
 #include <consensus/amount.h>
 #include <primitives/transaction_identifier.h>
 #include <wallet/transaction.h>
+#include <wallet/types.h>
 #include <wallet/wallet.h>
 
 namespace wallet {
@@ -43,13 +44,6 @@ bool CachedTxIsFromMe(const CWallet& wallet, const CWalletTx& wtx);
 bool CachedTxIsTrusted(const CWallet& wallet, const CWalletTx& wtx, std::set<Txid>& trusted_parents) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet);
 bool CachedTxIsTrusted(const CWallet& wallet, const CWalletTx& wtx);
 
-struct Balance {
-    CAmount m_mine_trusted{0};           //!< Trusted, at depth=GetBalance.min_depth or more
-    CAmount m_mine_untrusted_pending{0}; //!< Untrusted, but in mempool (pending)
-    CAmount m_mine_immature{0};          //!< Immature coinbases in the main chain
-    CAmount m_mine_used{0};              //!< Trusted/untrusted/immature funds in utxos that have already been spent from (only populated if AVOID REUSE wallet flag is set)
-    CAmount m_mine_nonmempool{0};        //!< Coins spent by wallet txs that are not in the mempool
-};
 Balance GetBalance(const CWallet& wallet, int min_depth = 0, bool avoid_reuse = true, bool include_nonmempool = false);
 
 std::map<CTxDestination, CAmount> GetAddressBalances(const CWallet& wallet);
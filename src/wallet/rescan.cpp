@@ -0,0 +1,160 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/rescan.h>
+
+#include <interfaces/chain.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <utility>
+
+using interfaces::FoundBlock;
+
+namespace wallet {
+namespace {
+//! Number of blocks from start_height to max_height, or to the tip without a maximum.
+size_t RangeSize(interfaces::Chain& chain, int start_height, std::optional<int> max_height)
+{
+    const int end_height{max_height ? *max_height : chain.getHeight().value_or(-1)};
+    return end_height >= start_height ? size_t(end_height - start_height) + 1 : 0;
+}
+
+//! Rescan workers needed to keep RESCAN_FILTER_BATCHES_PER_WORKER batches of the range in flight each.
+int RescanWorkers(const RescanFilter* filter, size_t blocks, int max_workers)
+{
+    if (!filter || blocks <= RESCAN_FILTER_BATCH_SIZE) return 0;
+    const size_t per_worker{RESCAN_FILTER_BATCHES_PER_WORKER * RESCAN_FILTER_BATCH_SIZE};
+    return int(std::clamp<size_t>(1 + (blocks - 1) / per_worker, 1, std::max(max_workers, 1)));
+}
+} // namespace
+
+RescanLookahead::RescanLookahead(interfaces::Chain& chain, const RescanFilter* filter, int start_height, std::optional<int> max_height, int max_workers)
+    : m_chain{chain}, m_filter{filter}, m_max_height{max_height},
+      m_workers{RescanWorkers(filter, RangeSize(chain, start_height, max_height), max_workers)},
+      m_max_ahead{m_workers > 0 ? size_t(m_workers) * RESCAN_FILTER_BATCHES_PER_WORKER * RESCAN_FILTER_BATCH_SIZE :
+                  filter ? 1 : RESCAN_PREFETCH_BLOCKS}
+{
+}
+
+RescanLookahead::~RescanLookahead()
+{
+    // Stopping the pools runs the tasks still queued, let them return without
+    // testing filters or reading blocks nobody is waiting for.
+    m_cancelled = true;
+}
+
+RescanLookahead::ScanBlock RescanLookahead::Take(const uint256& block_hash, int block_height)
+{
+    if (m_blocks.empty() || m_blocks.front().hash != block_hash) {
+        // Blocks looked up ahead belong to a branch that is no longer followed.
+        m_blocks.clear();
+        m_next_hash = block_hash;
+        m_next_height = block_height;
+    }
+    Fill();
+    // Nothing to look up for an unknown block, leave it to the caller.
+    if (m_blocks.empty()) return {};
+    Prefetch();
+
+    Block block{std::move(m_blocks.front())};
+    m_blocks.pop_front();
+    Resolve(block);
+    ScanBlock result;
+    result.matches = block.matches;
+    if (m_filter && result.matches == false) {
+        // Scripts may have been added to the filter set since the block was tested.
+        const auto filter_set{m_filter->FilterSet()};
+        if (block.filter_set != filter_set) result.matches = m_filter->MatchesBlock(block.hash, *filter_set);
+    }
+    if (block.data.valid()) {
+        CBlock data{block.data.get()};
+        if (!data.IsNull()) result.data = std::move(data);
+    }
+    return result;
+}
+
+void RescanLookahead::Fill()
+{
+    while (m_blocks.size() < m_max_ahead && !m_next_hash.IsNull()) {
+        std::vector<uint256> hashes;
+        while (hashes.size() < std::min(RESCAN_FILTER_BATCH_SIZE, m_max_ahead - m_blocks.size()) && !m_next_hash.IsNull()) {
+            hashes.push_back(m_next_hash);
+            bool next_block{false};
+            if (m_max_height && m_next_height >= *m_max_height) {
+                m_next_hash.SetNull();
+            } else {
+                m_chain.findBlock(m_next_hash, FoundBlock().nextBlock(FoundBlock().inActiveChain(next_block).hash(m_next_hash)));
+                if (!next_block) m_next_hash.SetNull();
+            }
+            ++m_next_height;
+        }
+
+        BatchMatches batch_matches;
+        std::shared_ptr<const GCSFilter::ElementSet> filter_set;
+        if (m_filter && m_workers > 0) {
+            if (m_filter_pool.WorkersCount() == 0) m_filter_pool.Start(m_workers);
+            filter_set = m_filter->FilterSet();
+            auto future{m_filter_pool.Submit([filter = m_filter, &cancelled = m_cancelled, hashes, filter_set] {
+                std::vector<std::optional<bool>> matches;
+                matches.reserve(hashes.size());
+                for (const uint256& hash : hashes) {
+                    if (cancelled) break;
+                    matches.push_back(filter->MatchesBlock(hash, *filter_set));
+                }
+                return matches;
+            })};
+            // Without a result, the block filters are tested when the blocks are taken.
+            if (future) batch_matches = std::move(*future);
+        }
+        for (size_t i{0}; i < hashes.size(); ++i) {
+            Block& block{m_blocks.emplace_back()};
+            block.hash = hashes[i];
+            block.batch_matches = batch_matches;
+            block.batch_pos = i;
+            block.filter_set = filter_set;
+        }
+    }
+}
+
+void RescanLookahead::Resolve(Block& block)
+{
+    if (block.resolved) return;
+    block.resolved = true;
+    if (block.batch_matches.valid()) {
+        const auto& matches{block.batch_matches.get()};
+        if (block.batch_pos < matches.size()) block.matches = matches[block.batch_pos];
+    } else if (m_filter) {
+        block.filter_set = m_filter->FilterSet();
+        block.matches = m_filter->MatchesBlock(block.hash, *block.filter_set);
+    }
+    // Results are shared by the whole batch, drop the reference once read.
+    block.batch_matches = {};
+}
+
+void RescanLookahead::Prefetch()
+{
+    // Only wait for the filter results of the first block.
+    size_t reads{0};
+    for (Block& block : m_blocks) {
+        if (reads >= RESCAN_PREFETCH_BLOCKS) break;
+        if (!block.resolved && &block != &m_blocks.front() && block.batch_matches.valid() &&
+            block.batch_matches.wait_for(0s) != std::future_status::ready) break;
+        Resolve(block);
+        if (block.matches == false) continue;
+        // Reading the block to take next ahead saves nothing.
+        if (&block == &m_blocks.front()) continue;
+        ++reads;
+        if (block.data.valid()) continue;
+        if (m_read_pool.WorkersCount() == 0) m_read_pool.Start(1);
+        auto future{m_read_pool.Submit([&chain = m_chain, &cancelled = m_cancelled, hash = block.hash] {
+            CBlock data;
+            if (!cancelled) chain.findBlock(hash, FoundBlock().data(data));
+            return data;
+        })};
+        if (!future) break;
+        block.data = std::move(*future);
+    }
+}
+} // namespace wallet
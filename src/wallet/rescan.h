@@ -0,0 +1,129 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WALLET_RESCAN_H
+#define BITCOIN_WALLET_RESCAN_H
+
+#include <blockfilter.h>
+#include <primitives/block.h>
+#include <uint256.h>
+#include <util/threadpool.h>
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace interfaces {
+class Chain;
+} // namespace interfaces
+
+namespace wallet {
+/** Number of consecutive blocks whose filters a rescan worker tests in one task. */
+static constexpr size_t RESCAN_FILTER_BATCH_SIZE{100};
+/** Number of filter batches tested ahead of the block being rescanned, per rescan worker. */
+static constexpr size_t RESCAN_FILTER_BATCHES_PER_WORKER{4};
+/** Maximum number of upcoming blocks read ahead of the block being rescanned. */
+static constexpr size_t RESCAN_PREFETCH_BLOCKS{8};
+/** Default for -rescanthreads, where 0 means one less than the number of cores. */
+static constexpr int DEFAULT_RESCAN_THREADS{0};
+/** Maximum for -rescanthreads. */
+static constexpr int MAX_RESCAN_THREADS{8};
+
+/** Tests the block filters of the blocks being rescanned against the scripts of a wallet. */
+class RescanFilter
+{
+public:
+    virtual ~RescanFilter() = default;
+
+    /** The current set of scripts. A set is never modified once returned; it is replaced when scripts are added. */
+    virtual std::shared_ptr<const GCSFilter::ElementSet> FilterSet() const = 0;
+
+    /**
+     * Whether the filter of the block matches any of the scripts in filter_set, or std::nullopt if the filter was not
+     * found. Called from the rescan workers.
+     */
+    virtual std::optional<bool> MatchesBlock(const uint256& block_hash, const GCSFilter::ElementSet& filter_set) const = 0;
+};
+
+/**
+ * Looks ahead of the block being rescanned. Rescan workers test the block
+ * filters of upcoming blocks against the wallet's scripts, in batches of
+ * consecutive blocks, and a prefetch thread reads the upcoming blocks that
+ * need to be inspected (all of them without a filter).
+ *
+ * The threads are only started once there is something for them to do, and
+ * not at all for a range of up to RESCAN_FILTER_BATCH_SIZE blocks, whose
+ * filters are then tested as the blocks are taken.
+ */
+class RescanLookahead
+{
+public:
+    struct ScanBlock {
+        //! Whether the block filter matched, std::nullopt without filter or when it was not found.
+        std::optional<bool> matches;
+        //! Block data, if it was read ahead.
+        std::optional<CBlock> data;
+    };
+
+    /**
+     * @param[in] filter       Filter to test the blocks against, or nullptr to inspect every block
+     * @param[in] start_height Height of the first block of the rescan
+     * @param[in] max_height   Height of the last block of the rescan, or std::nullopt to rescan up to the tip
+     * @param[in] max_workers  Maximum number of threads testing block filters. Fewer are used for short ranges.
+     */
+    RescanLookahead(interfaces::Chain& chain, const RescanFilter* filter, int start_height, std::optional<int> max_height, int max_workers);
+    ~RescanLookahead();
+
+    /**
+     * Return what was looked up ahead for the given block, which becomes the
+     * first block of the lookahead window. Looking ahead continues from there.
+     * If the window does not start at the given block, e.g. after a reorg, it
+     * is discarded and refilled from the given block.
+     */
+    ScanBlock Take(const uint256& block_hash, int block_height);
+
+    /** Number of threads testing block filters ahead of the rescan, 0 if they are tested as the blocks are taken. */
+    int Workers() const { return m_workers; }
+
+private:
+    using BatchMatches = std::shared_future<std::vector<std::optional<bool>>>;
+
+    struct Block {
+        uint256 hash;
+        //! Filter results of the batch the block was tested in, and the block's position in it.
+        BatchMatches batch_matches;
+        size_t batch_pos{0};
+        std::shared_ptr<const GCSFilter::ElementSet> filter_set;
+        bool resolved{false};
+        std::optional<bool> matches;
+        std::future<CBlock> data;
+    };
+
+    interfaces::Chain& m_chain;
+    const RescanFilter* const m_filter;
+    const std::optional<int> m_max_height;
+    const int m_workers;
+    const size_t m_max_ahead;
+    //! Set on destruction, so that tasks still queued on the pools return right away. Outlives the pools.
+    std::atomic<bool> m_cancelled{false};
+    ThreadPool m_filter_pool{"rescanfilter"};
+    ThreadPool m_read_pool{"rescanread"};
+    std::deque<Block> m_blocks;
+    //! Next block to append to the window, null at the end of the chain or scan range.
+    uint256 m_next_hash;
+    int m_next_height{0};
+
+    //! Extend the window up to m_max_ahead blocks, submitting their filter tests in batches.
+    void Fill();
+    void Resolve(Block& block);
+    //! Read ahead the first RESCAN_PREFETCH_BLOCKS blocks of the window that need to be inspected.
+    void Prefetch();
+};
+} // namespace wallet
+
+#endif // BITCOIN_WALLET_RESCAN_H
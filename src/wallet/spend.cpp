@@ -336,9 +336,10 @@ CoinsResult AvailableCoins(const CWallet& wallet,
     std::set<Txid> trusted_parents;
     // Cache for whether each tx passes the tx level checks (first bool), and whether the transaction is "safe" (second bool)
     std::unordered_map<Txid, std::pair<bool, bool>, SaltedTxidHasher> tx_safe_cache;
-    for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
-        const CWalletTx& wtx = txo.GetWalletTx();
-        const CTxOut& output = txo.GetTxOut();
+    // Outputs spent by confirmed transactions are never available
+    for (const auto& [outpoint, txo] : wallet.GetUnspentTXOs()) {
+        const CWalletTx& wtx = txo->GetWalletTx();
+        const CTxOut& output = txo->GetTxOut();
 
         if (tx_safe_cache.contains(outpoint.hash) && !tx_safe_cache.at(outpoint.hash).first) {
             continue;
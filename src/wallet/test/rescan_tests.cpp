@@ -0,0 +1,150 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/rescan.h>
+
+#include <chain.h>
+#include <consensus/validation.h>
+#include <interfaces/chain.h>
+#include <test/util/common.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace wallet {
+namespace {
+/** Filter whose scripts are block hashes, so that a block matches if its hash is in the filter set. */
+class TestRescanFilter : public RescanFilter
+{
+public:
+    std::shared_ptr<const GCSFilter::ElementSet> FilterSet() const override { return m_filter_set; }
+
+    std::optional<bool> MatchesBlock(const uint256& block_hash, const GCSFilter::ElementSet& filter_set) const override
+    {
+        return filter_set.contains(GCSFilter::Element(block_hash.begin(), block_hash.end()));
+    }
+
+    //! Replace the filter set, like a keypool top-up does.
+    void Set(const std::vector<uint256>& block_hashes)
+    {
+        auto filter_set{std::make_shared<GCSFilter::ElementSet>()};
+        for (const uint256& hash : block_hashes) filter_set->emplace(hash.begin(), hash.end());
+        m_filter_set = std::move(filter_set);
+    }
+
+private:
+    std::shared_ptr<const GCSFilter::ElementSet> m_filter_set{std::make_shared<GCSFilter::ElementSet>()};
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(rescan_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(rescan_lookahead_workers)
+{
+    TestRescanFilter filter;
+    // Without a filter, there are no filters to test.
+    BOOST_CHECK_EQUAL(RescanLookahead(*m_node.chain, nullptr, 0, std::nullopt, 4).Workers(), 0);
+    // Filters of short ranges are tested as the blocks are taken.
+    BOOST_CHECK_EQUAL(RescanLookahead(*m_node.chain, &filter, 50, std::nullopt, 4).Workers(), 0);
+    BOOST_CHECK_EQUAL(RescanLookahead(*m_node.chain, &filter, 0, 99, 4).Workers(), 0);
+    // The tip is at height 100.
+    BOOST_CHECK_EQUAL(RescanLookahead(*m_node.chain, &filter, 0, std::nullopt, 4).Workers(), 1);
+    BOOST_CHECK_EQUAL(RescanLookahead(*m_node.chain, &filter, 0, 1000, 4).Workers(), 3);
+    BOOST_CHECK_EQUAL(RescanLookahead(*m_node.chain, &filter, 0, 10000, 4).Workers(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(rescan_lookahead_prefetch)
+{
+    const CChain& active{*WITH_LOCK(::cs_main, return &m_node.chainman->ActiveChain())};
+
+    // Without a filter, every block is read ahead.
+    {
+        RescanLookahead lookahead{*m_node.chain, nullptr, 0, std::nullopt, 4};
+        for (int height{0}; height <= 100; ++height) {
+            const uint256 hash{WITH_LOCK(::cs_main, return active[height]->GetBlockHash())};
+            auto [matches, data]{lookahead.Take(hash, height)};
+            BOOST_CHECK(!matches);
+            // The first block is left to the caller.
+            BOOST_CHECK_EQUAL(data.has_value(), height > 0);
+            if (data) BOOST_CHECK_EQUAL(data->GetHash(), hash);
+        }
+    }
+
+    // With a filter, only the blocks that matched are read ahead.
+    TestRescanFilter filter;
+    const uint256 hash_10{WITH_LOCK(::cs_main, return active[10]->GetBlockHash())};
+    const uint256 hash_50{WITH_LOCK(::cs_main, return active[50]->GetBlockHash())};
+    filter.Set({hash_10, hash_50});
+    RescanLookahead lookahead{*m_node.chain, &filter, 0, std::nullopt, 4};
+    BOOST_REQUIRE_EQUAL(lookahead.Workers(), 1);
+    for (int height{0}; height <= 100; ++height) {
+        const uint256 hash{WITH_LOCK(::cs_main, return active[height]->GetBlockHash())};
+        auto [matches, data]{lookahead.Take(hash, height)};
+        const bool expected{height == 10 || height == 50};
+        BOOST_CHECK(matches == expected);
+        BOOST_CHECK_EQUAL(data.has_value(), expected);
+        if (data) BOOST_CHECK_EQUAL(data->GetHash(), hash);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rescan_lookahead_retest_after_update)
+{
+    const CChain& active{*WITH_LOCK(::cs_main, return &m_node.chainman->ActiveChain())};
+    TestRescanFilter filter;
+    RescanLookahead lookahead{*m_node.chain, &filter, 0, std::nullopt, 4};
+    BOOST_REQUIRE_EQUAL(lookahead.Workers(), 1);
+
+    // The whole range is submitted for testing against the empty filter set.
+    BOOST_CHECK(lookahead.Take(WITH_LOCK(::cs_main, return active[0]->GetBlockHash()), 0).matches == false);
+
+    // Blocks that did not match the old set are tested again against the new one.
+    const uint256 hash_5{WITH_LOCK(::cs_main, return active[5]->GetBlockHash())};
+    filter.Set({hash_5});
+    for (int height{1}; height <= 100; ++height) {
+        const uint256 hash{WITH_LOCK(::cs_main, return active[height]->GetBlockHash())};
+        BOOST_CHECK(lookahead.Take(hash, height).matches == (height == 5));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rescan_lookahead_reorg)
+{
+    const CChain& active{*WITH_LOCK(::cs_main, return &m_node.chainman->ActiveChain())};
+    TestRescanFilter filter;
+    RescanLookahead lookahead{*m_node.chain, &filter, 0, std::nullopt, 4};
+    BOOST_REQUIRE_EQUAL(lookahead.Workers(), 1);
+    for (int height{0}; height < 50; ++height) {
+        const uint256 hash{WITH_LOCK(::cs_main, return active[height]->GetBlockHash())};
+        BOOST_CHECK(lookahead.Take(hash, height).matches == false);
+    }
+
+    // Replace the blocks from height 50, which the window already holds, by a shorter branch.
+    const uint256 old_hash_50{WITH_LOCK(::cs_main, return active[50]->GetBlockHash())};
+    BlockValidationState state;
+    BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, WITH_LOCK(::cs_main, return active[50])));
+    coinbaseKey.MakeNewKey(true);
+    std::vector<uint256> new_hashes;
+    for (int i{0}; i < 3; ++i) {
+        new_hashes.push_back(CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey())).GetHash());
+    }
+    BOOST_REQUIRE_EQUAL(WITH_LOCK(::cs_main, return active.Height()), 52);
+    BOOST_REQUIRE(new_hashes[0] != old_hash_50);
+    filter.Set(new_hashes);
+
+    // The window is dropped and refilled from the new branch, up to its tip.
+    for (int height{50}; height <= 52; ++height) {
+        const uint256& hash{new_hashes[height - 50]};
+        auto [matches, data]{lookahead.Take(hash, height)};
+        BOOST_CHECK(matches == true);
+        BOOST_CHECK_EQUAL(data.has_value(), height > 50);
+        if (data) BOOST_CHECK_EQUAL(data->GetHash(), hash);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace wallet
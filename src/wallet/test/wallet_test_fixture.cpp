@@ -14,7 +14,7 @@ WalletTestingSetup::WalletTestingSetup(const ChainType chainType)
       m_wallet_loader{interfaces::MakeWalletLoader(*m_node.chain, *Assert(m_node.args))},
       m_wallet(m_node.chain.get(), "", CreateMockableWalletDatabase())
 {
-    m_chain_notifications_handler = m_node.chain->handleNotifications({ &m_wallet, [](CWallet*) {} });
+    m_chain_notifications_handler = m_node.chain->handleNotifications({ &m_wallet, [](CWallet*) {} }, "wallet");
     m_wallet_loader->registerRpcs();
 }
 
@@ -754,5 +754,68 @@ BOOST_FIXTURE_TEST_CASE(RemoveTxs, TestChain100Setup)
     TestUnloadWallet(std::move(wallet));
 }
 
+BOOST_FIXTURE_TEST_CASE(unspent_txos_and_balance_cache, TestChain100Setup)
+{
+    m_args.ForceSetArg("-unsafesqlitesync", "1");
+    WalletContext context;
+    context.args = &m_args;
+    context.chain = m_node.chain.get();
+    auto wallet = TestCreateWallet(context);
+    CKey key = GenerateRandomKey();
+    AddKey(*wallet, key);
+
+    // The unspent TXOs are the wallet's outputs which are not spent by a confirmed transaction
+    const auto check_unspent_txos{[&] {
+        LOCK(wallet->cs_wallet);
+        size_t unspent{0};
+        for (const auto& [outpoint, txo] : wallet->GetTXOs()) {
+            const bool confirmed_spend{wallet->HowSpent(outpoint) == CWallet::SpendType::CONFIRMED};
+            BOOST_CHECK_EQUAL(wallet->GetUnspentTXOs().contains(outpoint), !confirmed_spend);
+            if (!confirmed_spend) ++unspent;
+        }
+        BOOST_CHECK_EQUAL(wallet->GetUnspentTXOs().size(), unspent);
+    }};
+
+    // Receive a payment in the mempool
+    auto receive_tx = TestSimpleSpend(*m_coinbase_txns[0], 0, coinbaseKey, GetScriptForRawPubKey(key.GetPubKey()));
+    const COutPoint received{receive_tx.GetHash(), 0};
+    const CAmount amount{receive_tx.vout[0].nValue};
+    std::string error;
+    BOOST_CHECK(m_node.chain->broadcastTransaction(MakeTransactionRef(receive_tx), DEFAULT_TRANSACTION_MAXFEE, node::TxBroadcast::MEMPOOL_NO_BROADCAST, error));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    check_unspent_txos();
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_untrusted_pending, amount);
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, 0);
+
+    // Confirm it, the cached balance must not survive the new block
+    CreateAndProcessBlock({receive_tx}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    check_unspent_txos();
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_untrusted_pending, 0);
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, amount);
+    BOOST_CHECK_EQUAL(GetBalance(*wallet, /*min_depth=*/2).m_mine_trusted, 0);
+
+    // Spend it in a block, which removes it from the unspent TXOs
+    auto spend_tx = TestSimpleSpend(CTransaction{receive_tx}, 0, key, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    CreateAndProcessBlock({spend_tx}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    check_unspent_txos();
+    BOOST_CHECK(!WITH_LOCK(wallet->cs_wallet, return wallet->GetUnspentTXOs().contains(received)));
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, 0);
+    BOOST_CHECK_EQUAL(GetBalance(*wallet, /*min_depth=*/2).m_mine_trusted, 0);
+
+    // Disconnecting the block brings the output back, spent by a transaction that is no longer confirmed
+    {
+        BlockValidationState state;
+        m_node.chainman->ActiveChainstate().InvalidateBlock(state, WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip()));
+    }
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    check_unspent_txos();
+    BOOST_CHECK(WITH_LOCK(wallet->cs_wallet, return wallet->GetUnspentTXOs().contains(received)));
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, 0);
+
+    TestUnloadWallet(std::move(wallet));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -66,6 +66,7 @@
 #include <wallet/crypter.h>
 #include <wallet/db.h>
 #include <wallet/external_signer_scriptpubkeyman.h>
+#include <wallet/rescan.h>
 #include <wallet/scriptpubkeyman.h>
 #include <wallet/transaction.h>
 #include <wallet/types.h>
@@ -77,6 +78,7 @@
 #include <condition_variable>
 #include <exception>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <thread>
@@ -315,42 +317,51 @@ std::shared_ptr<CWallet> LoadWalletInternal(WalletContext& context, const std::s
     }
 }
 
-class FastWalletRescanFilter
+class FastWalletRescanFilter : public RescanFilter
 {
 public:
     FastWalletRescanFilter(const CWallet& wallet) : m_wallet(wallet)
     {
         // create initial filter with scripts from all ScriptPubKeyMans
+        auto filter_set{std::make_shared<GCSFilter::ElementSet>()};
         for (auto spkm : m_wallet.GetAllScriptPubKeyMans()) {
             auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(spkm)};
             assert(desc_spkm != nullptr);
-            AddScriptPubKeys(desc_spkm);
+            AddScriptPubKeys(*filter_set, desc_spkm);
             // save each range descriptor's end for possible future filter updates
             if (desc_spkm->IsHDEnabled()) {
                 m_last_range_ends.emplace(desc_spkm->GetID(), desc_spkm->GetEndRange());
             }
         }
+        m_filter_set = std::move(filter_set);
     }
 
     void UpdateIfNeeded()
     {
         // repopulate filter with new scripts if top-up has happened since last iteration
+        std::shared_ptr<GCSFilter::ElementSet> filter_set;
         for (const auto& [desc_spkm_id, last_range_end] : m_last_range_ends) {
             auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(m_wallet.GetScriptPubKeyMan(desc_spkm_id))};
             assert(desc_spkm != nullptr);
             int32_t current_range_end{desc_spkm->GetEndRange()};
             if (current_range_end > last_range_end) {
-                AddScriptPubKeys(desc_spkm, last_range_end);
+                // the current set may still be tested against by rescan workers, so extend a copy of it
+                if (!filter_set) filter_set = std::make_shared<GCSFilter::ElementSet>(*m_filter_set);
+                AddScriptPubKeys(*filter_set, desc_spkm, last_range_end);
                 m_last_range_ends.at(desc_spkm->GetID()) = current_range_end;
             }
         }
+        if (filter_set) m_filter_set = std::move(filter_set);
     }
 
-    std::optional<bool> MatchesBlock(const uint256& block_hash) const
+    std::optional<bool> MatchesBlock(const uint256& block_hash, const GCSFilter::ElementSet& filter_set) const override
     {
-        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, filter_set);
     }
 
+    /** The current filter set. It is never modified, UpdateIfNeeded replaces it instead. */
+    std::shared_ptr<const GCSFilter::ElementSet> FilterSet() const override { return m_filter_set; }
+
 private:
     const CWallet& m_wallet;
     /** Map for keeping track of each range descriptor's last seen end range.
@@ -360,15 +371,16 @@ private:
       * take possible keypool top-ups into account.
       */
     std::map<uint256, int32_t> m_last_range_ends;
-    GCSFilter::ElementSet m_filter_set;
+    std::shared_ptr<const GCSFilter::ElementSet> m_filter_set;
 
-    void AddScriptPubKeys(const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
+    static void AddScriptPubKeys(GCSFilter::ElementSet& filter_set, const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
     {
         for (const auto& script_pub_key : desc_spkm->GetScriptPubKeys(last_range_end)) {
-            m_filter_set.emplace(script_pub_key.begin(), script_pub_key.end());
+            filter_set.emplace(script_pub_key.begin(), script_pub_key.end());
         }
     }
 };
+
 } // namespace
 
 std::shared_ptr<CWallet> LoadWallet(WalletContext& context, const std::string& name, std::optional<bool> load_on_start, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error, std::vector<bilingual_str>& warnings)
@@ -682,6 +694,8 @@ void CWallet::SetLastBlockProcessedInMem(int block_height, uint256 block_hash)
 
     m_last_block_processed = block_hash;
     m_last_block_processed_height = block_height;
+    // Depths and coinbase maturity are relative to the last processed block
+    m_balance_cache.clear();
 }
 
 void CWallet::SetLastBlockProcessed(int block_height, uint256 block_hash)
@@ -822,6 +836,7 @@ CWallet::SpendType CWallet::HowSpent(const COutPoint& outpoint) const
 void CWallet::AddToSpends(const COutPoint& outpoint, const Txid& txid)
 {
     mapTxSpends.insert(std::make_pair(outpoint, txid));
+    RefreshUnspentTXO(outpoint);
 
     UnlockCoin(outpoint);
 
@@ -990,6 +1005,7 @@ void CWallet::MarkDirty()
         LOCK(cs_wallet);
         for (auto& [_, wtx] : mapWallet)
             wtx.MarkDirty();
+        m_balance_cache.clear();
     }
 }
 
@@ -1011,6 +1027,7 @@ bool CWallet::MarkReplaced(const Txid& originalHash, const Txid& newHash)
 
     // Refresh mempool status without waiting for transactionRemovedFromMempool or transactionAddedToMempool
     RefreshMempoolStatus(wtx, chain());
+    m_balance_cache.clear();
 
     WalletBatch batch(GetDatabase());
 
@@ -1139,6 +1156,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
 
     // Break debit/credit balance caches:
     wtx.MarkDirty();
+    MarkInputsDirty(wtx.GetTx());
 
     // Cache the outputs that belong to the wallet
     RefreshTXOsFromTx(wtx);
@@ -1305,7 +1323,9 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
         }
+        RefreshUnspentTXO(txin.prevout);
     }
+    m_balance_cache.clear();
 }
 
 bool CWallet::AbandonTransaction(const Txid& hashTx)
@@ -1432,6 +1452,13 @@ bool CWallet::SyncTransaction(const CTransactionRef& ptx, const SyncTxState& sta
     return true;
 }
 
+void CWallet::transactionsAddedToMempool(std::span<const CTransactionRef> txs)
+{
+    // Take the wallet lock once for the whole batch rather than once per transaction.
+    LOCK(cs_wallet);
+    for (const auto& tx : txs) transactionAddedToMempool(tx);
+}
+
 void CWallet::transactionAddedToMempool(const CTransactionRef& tx) {
     LOCK(cs_wallet);
     SyncTransaction(tx, TxStateInMempool{});
@@ -1439,6 +1466,7 @@ void CWallet::transactionAddedToMempool(const CTransactionRef& tx) {
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        m_balance_cache.clear();
     }
 
     const Txid& txid = tx->GetHash();
@@ -1480,6 +1508,7 @@ void CWallet::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRe
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        m_balance_cache.clear();
     }
     // Handle transactions that were removed from the mempool because they
     // conflict with transactions in a newly connected block.
@@ -1888,6 +1917,10 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     std::unique_ptr<FastWalletRescanFilter> fast_rescan_filter;
     if (chain().hasBlockFilterIndex(BlockFilterType::BASIC)) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this);
 
+    // Test block filters and read blocks ahead of the block being scanned
+    const int rescan_threads{m_rescan_threads > 0 ? m_rescan_threads : std::clamp(GetNumCores() - 1, 1, MAX_RESCAN_THREADS)};
+    RescanLookahead lookahead{chain(), fast_rescan_filter.get(), start_height, max_height, rescan_threads};
+
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
                     fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
 
@@ -1916,9 +1949,9 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         }
 
         bool fetch_block{true};
+        if (fast_rescan_filter) fast_rescan_filter->UpdateIfNeeded();
+        auto [matches_block, prefetched_block]{lookahead.Take(block_hash, block_height)};
         if (fast_rescan_filter) {
-            fast_rescan_filter->UpdateIfNeeded();
-            auto matches_block{fast_rescan_filter->MatchesBlock(block_hash)};
             if (matches_block.has_value()) {
                 if (*matches_block) {
                     LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (filter matched)\n", block_height, block_hash.ToString());
@@ -1943,8 +1976,13 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             // Read block data and locator if needed (the locator is usually null unless we need to save progress)
             CBlock block;
             CBlockLocator loc;
-            // Find block
-            FoundBlock found_block{FoundBlock().data(block)};
+            // Find block, unless it was read ahead
+            FoundBlock found_block;
+            if (prefetched_block) {
+                block = std::move(*prefetched_block);
+            } else {
+                found_block.data(block);
+            }
             if (save_progress && next_interval) found_block.locator(loc);
             chain().findBlock(block_hash, found_block);
 
@@ -2063,7 +2101,10 @@ bool CWallet::SubmitTxMemoryPoolAndRelay(CWalletTx& wtx,
     // If transaction was previously in the mempool, it should be updated when
     // TransactionRemovedFromMempool fires.
     bool ret = chain().broadcastTransaction(wtx.GetTx(), m_default_max_tx_fee, broadcast_method, err_string);
-    if (ret) wtx.m_state = TxStateInMempool{};
+    if (ret) {
+        wtx.m_state = TxStateInMempool{};
+        m_balance_cache.clear();
+    }
     return ret;
 }
 
@@ -2479,9 +2520,11 @@ util::Result<void> CWallet::RemoveTxs(WalletBatch& batch, std::vector<Txid>& txs
                         break;
                     }
                 }
+                RefreshUnspentTXO(txin.prevout);
             }
             for (unsigned int i = 0; i < it->second.GetTx()->vout.size(); ++i) {
                 m_txos.erase(COutPoint(hash, i));
+                m_unspent_txos.erase(COutPoint(hash, i));
             }
             mapWallet.erase(it);
             NotifyTransactionChanged(hash, CT_DELETED);
@@ -2574,6 +2617,7 @@ bool CWallet::DelAddressBookWithDB(WalletBatch& batch, const CTxDestination& add
 
         // finally, remove it from the map
         m_address_book.erase(address);
+        m_balance_cache.clear();
     }
 
     // All good, signal changes
@@ -2883,6 +2927,7 @@ bool CWallet::SetAddressPreviouslySpent(WalletBatch& batch, const CTxDestination
 
     if (!used) {
         if (auto* data{common::FindKey(m_address_book, dest)}) data->previously_spent = false;
+        m_balance_cache.clear();
         return batch.WriteAddressPreviouslySpent(dest, false);
     }
 
@@ -2893,6 +2938,7 @@ bool CWallet::SetAddressPreviouslySpent(WalletBatch& batch, const CTxDestination
 void CWallet::LoadAddressPreviouslySpent(const CTxDestination& dest)
 {
     m_address_book[dest].previously_spent = true;
+    m_balance_cache.clear();
 }
 
 void CWallet::LoadAddressReceiveRequest(const CTxDestination& dest, const std::string& id, const std::string& request)
@@ -3102,6 +3148,7 @@ bool CWallet::LoadWalletArgs(std::shared_ptr<CWallet> wallet, const WalletContex
 
     wallet->m_keypool_size = std::max(args.GetIntArg("-keypool", DEFAULT_KEYPOOL_SIZE), int64_t{1});
     wallet->m_notify_tx_changed_script = args.GetArg("-walletnotify", "");
+    wallet->m_rescan_threads = int(std::clamp<int64_t>(args.GetIntArg("-rescanthreads", DEFAULT_RESCAN_THREADS), 0, MAX_RESCAN_THREADS));
     wallet->SetBroadcastTransactions(args.GetBoolArg("-walletbroadcast", DEFAULT_WALLETBROADCAST));
 
     return true;
@@ -3233,7 +3280,7 @@ bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interf
     // be pending on the validation-side until lock release. Blocks that are connected while the
     // rescan is ongoing will not be processed in the rescan but with the block connected notifications,
     // so the wallet will only be completeley synced after the notifications delivery.
-    walletInstance->m_chain_notifications_handler = walletInstance->chain().handleNotifications(walletInstance);
+    walletInstance->m_chain_notifications_handler = walletInstance->chain().handleNotifications(walletInstance, "wallet " + walletInstance->LogName());
 
     // If rescan_required = true, rescan_height remains equal to 0
     int rescan_height = 0;
@@ -4006,7 +4053,9 @@ util::Result<void> CWallet::ApplyMigrationData(WalletBatch& local_wallet_batch,
     (void)local_wallet_batch.ReadBestBlock(best_block_locator);
 
     // Update m_txos to match the descriptors remaining in this wallet
+    m_unspent_txos.clear();
     m_txos.clear();
+    m_balance_cache.clear();
     RefreshAllTXOs();
 
     // Check if the transactions in the wallet are still ours. Either they belong here, or they belong in the watchonly wallet.
@@ -4619,6 +4668,7 @@ void CWallet::RefreshTXOsFromTx(const CWalletTx& wtx)
         if (m_txos.contains(outpoint)) {
         } else {
             m_txos.emplace(outpoint, WalletTXO{wtx, txout});
+            RefreshUnspentTXO(outpoint);
         }
     }
 }
@@ -4641,6 +4691,32 @@ std::optional<WalletTXO> CWallet::GetTXO(const COutPoint& outpoint) const
     return it->second;
 }
 
+void CWallet::RefreshUnspentTXO(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+    const auto it{m_txos.find(outpoint)};
+    if (it != m_txos.end() && HowSpent(outpoint) != SpendType::CONFIRMED) {
+        m_unspent_txos.insert_or_assign(outpoint, &it->second);
+    } else {
+        m_unspent_txos.erase(outpoint);
+    }
+    m_balance_cache.clear();
+}
+
+std::optional<Balance> CWallet::GetCachedBalance(int min_depth, bool allow_used_addresses, bool include_nonmempool) const
+{
+    AssertLockHeld(cs_wallet);
+    const auto it{m_balance_cache.find({min_depth, allow_used_addresses, include_nonmempool})};
+    if (it == m_balance_cache.end()) return std::nullopt;
+    return it->second;
+}
+
+void CWallet::CacheBalance(int min_depth, bool allow_used_addresses, bool include_nonmempool, const Balance& balance) const
+{
+    AssertLockHeld(cs_wallet);
+    m_balance_cache.insert_or_assign({min_depth, allow_used_addresses, include_nonmempool}, balance);
+}
+
 void CWallet::DisconnectChainNotifications()
 {
     if (m_chain_notifications_handler) {
@@ -33,6 +33,7 @@
 #include <util/ui_change_type.h>
 #include <wallet/crypter.h>
 #include <wallet/db.h>
+#include <wallet/rescan.h>
 #include <wallet/scriptpubkeyman.h>
 #include <wallet/transaction.h>
 #include <wallet/types.h>
@@ -49,6 +50,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -370,7 +372,7 @@ private:
     void RecursiveUpdateTxState(const Txid& tx_hash, const TryUpdatingStateFn& try_updating_state) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void RecursiveUpdateTxState(WalletBatch* batch, const Txid& tx_hash, const TryUpdatingStateFn& try_updating_state) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
-    /** Mark a transaction's inputs dirty, thus forcing the outputs to be recomputed */
+    /** Mark a transaction's inputs dirty, thus forcing the outputs to be recomputed, and refresh whether they are unspent */
     void MarkInputsDirty(const CTransactionRef& tx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -436,6 +438,15 @@ private:
     //! Set of both spent and unspent transaction outputs owned by this wallet
     std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher> m_txos GUARDED_BY(cs_wallet);
 
+    //! Outputs in m_txos which are not spent by a confirmed wallet transaction, pointing into m_txos
+    std::unordered_map<COutPoint, const WalletTXO*, SaltedOutpointHasher> m_unspent_txos GUARDED_BY(cs_wallet);
+
+    //! Results of GetBalance by (min_depth, allow_used_addresses, include_nonmempool), cleared whenever they may change
+    mutable std::map<std::tuple<int, bool, bool>, Balance> m_balance_cache GUARDED_BY(cs_wallet);
+
+    /** Add an output to m_unspent_txos or remove it, after it or one of its spends changed */
+    void RefreshUnspentTXO(const COutPoint& outpoint) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
      * block locator and m_last_block_processed, and registering for
@@ -524,6 +535,12 @@ public:
 
     const std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher>& GetTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_txos; };
     std::optional<WalletTXO> GetTXO(const COutPoint& outpoint) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Outputs owned by this wallet which are not spent by a confirmed transaction. They may still be spent by unconfirmed ones. */
+    const std::unordered_map<COutPoint, const WalletTXO*, SaltedOutpointHasher>& GetUnspentTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_unspent_txos; };
+
+    /** Balance previously computed by GetBalance with the same arguments, if nothing affecting it changed since */
+    std::optional<Balance> GetCachedBalance(int min_depth, bool allow_used_addresses, bool include_nonmempool) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void CacheBalance(int min_depth, bool allow_used_addresses, bool include_nonmempool, const Balance& balance) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /** Cache outputs that belong to the wallet from a single transaction */
     void RefreshTXOsFromTx(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -632,6 +649,7 @@ public:
     CWalletTx* AddToWallet(CTransactionRef tx, const TxState& state, const UpdateWalletTxFn& update_wtx=nullptr, bool rescanning_old_block = false);
     bool LoadToWallet(CWalletTx&& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void transactionAddedToMempool(const CTransactionRef& tx) override;
+    void transactionsAddedToMempool(std::span<const CTransactionRef> txs) override;
     void blockConnected(const kernel::ChainstateRole& role, const interfaces::BlockInfo& block) override;
     void blockDisconnected(const interfaces::BlockInfo& block) override;
     void updatedBlockTip() override;
@@ -755,6 +773,9 @@ public:
     /** Notify external script when a wallet transaction comes in or is updated (handled by -walletnotify) */
     std::string m_notify_tx_changed_script;
 
+    /** Maximum number of threads testing block filters during a rescan, 0 for one less than the number of cores (handled by -rescanthreads) */
+    int m_rescan_threads{DEFAULT_RESCAN_THREADS};
+
     size_t KeypoolCountExternalKeys() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     bool TopUpKeyPool(unsigned int kpSize = 0);
 
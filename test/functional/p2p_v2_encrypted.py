@@ -24,7 +24,8 @@ from test_framework.crypto.chacha20 import REKEY_INTERVAL
 class P2PEncrypted(BitcoinTestFramework):
     def set_test_params(self):
         self.num_nodes = 2
-        self.extra_args = [["-v2transport=1"], ["-v2transport=1"]]
+        # Spread the peers of node0 over several socket I/O threads.
+        self.extra_args = [["-v2transport=1", "-netiothreads=3"], ["-v2transport=1"]]
 
     def setup_network(self):
         self.setup_nodes()
@@ -99,7 +99,7 @@ class RpcMiscTest(BitcoinTestFramework):
         assert_equal(node.getindexinfo(), {})
 
         # Restart the node with indices and wait for them to sync
-        self.restart_node(0, ["-txindex", "-blockfilterindex", "-coinstatsindex", "-txospenderindex"])
+        self.restart_node(0, ["-txindex", "-blockfilterindex", "-coinstatsindex", "-txospenderindex", "-indexworkers=2"])
         self.wait_until(lambda: all(i["synced"] for i in node.getindexinfo().values()))
 
         # Returns a list of all running indices by default
@@ -120,6 +120,15 @@ class RpcMiscTest(BitcoinTestFramework):
         # Specifying an unknown index name returns an empty result
         assert_equal(node.getindexinfo("foo"), {})
 
+        self.log.info("test getvalidationqueueinfo")
+        # Every index receives its notifications on a queue of its own
+        node.syncwithvalidationinterfacequeue()
+        info = node.getvalidationqueueinfo()
+        assert_equal(info["pending"], 0)
+        for i in {"txindex", "basic block filter index", "coinstatsindex", "txospenderindex"}:
+            assert_equal(info["queues"][i]["pending"], 0)
+            assert_equal(info["queues"][i]["lag_ms"], 0)
+
         # Test a deprecated category
         all_result = node.logging(include=['all'])
         assert_equal(True, all(enabled is True for category, enabled in all_result.items()))
@@ -235,6 +235,15 @@ class NetTest(BitcoinTestFramework):
         assert_equal(info['connections_in'], 1)
         assert_equal(info['connections_out'], 1)
 
+        self.log.info("Check the block relay message latency histograms")
+        # The nodes answered each other's getheaders with a headers message.
+        self.wait_until(lambda: 'headers' in self.nodes[0].getnetworkinfo()['block_relay_latency']['msg_types'])
+        block_relay_latency = self.nodes[0].getnetworkinfo()['block_relay_latency']
+        assert_equal(block_relay_latency['bucket_limits_ms'], [1, 2, 5, 10, 20, 50, 100, 200, 500, 1000])
+        for latency in block_relay_latency['msg_types'].values():
+            assert_equal(len(latency['histogram']), len(block_relay_latency['bucket_limits_ms']) + 1)
+            assert_equal(sum(latency['histogram']), latency['count'])
+
         # check the `servicesnames` field
         network_info = [node.getnetworkinfo() for node in self.nodes]
         for info in network_info: